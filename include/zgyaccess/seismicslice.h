@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "zgyaccess/zgy_memorygovernor.h"
+
 #include <vector>
 #include <memory>
 
@@ -40,6 +42,8 @@ public:
     void reset();
 
     bool isEmpty() const;
+    // empty because the memory governor refused the buffer, rather than from a failed or empty read
+    bool isOutOfMemory() const;
 
     void limitTo(float minVal, float maxVal);
     void mute(float threshold);
@@ -47,6 +51,8 @@ public:
 private:
     int m_width;
     int m_depth;
+    bool m_outOfMemory;
+    std::unique_ptr<MemoryReservation> m_reservation;
     std::unique_ptr<float> m_values;
 };
 
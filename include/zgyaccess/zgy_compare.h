@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    class BrickDifference
+    {
+    public:
+        BrickDifference() {};
+
+        // full resolution index box of the brick
+        std::array<int, 3> start{ 0, 0, 0 };
+        std::array<int, 3> size{ 0, 0, 0 };
+
+        std::int64_t differingSamples = 0;
+        double maxDifference = 0.0;
+    };
+
+    class VolumeComparison
+    {
+    public:
+        VolumeComparison() {};
+
+        bool isIdentical() const { return sameSize && sameGeometry && !readFailed && (differingSamples == 0); };
+
+        bool sameSize = false;
+        bool sameGeometry = false;
+        bool readFailed = false;
+
+        std::int64_t comparedSamples = 0;
+        std::int64_t differingSamples = 0;
+        double maxDifference = 0.0;
+        double rmsDifference = 0.0;
+
+        // the files were byte for byte identical, so no brick was read
+        bool identicalFiles = false;
+
+        // bricks settled from the stored constant values alone, and bricks that had to be decoded
+        int constantBricks = 0;
+        int decodedBricks = 0;
+
+        // bricks with differences above the tolerance, in brick order
+        std::vector<BrickDifference> regions;
+    };
+
+    class VolumeComparator
+    {
+    public:
+        VolumeComparator();
+        ~VolumeComparator();
+
+        void setTolerance(double tolerance);
+
+        VolumeComparison compare(const ZGYReader& first, const ZGYReader& second) const;
+
+    private:
+        double m_tolerance;
+    };
+
+}
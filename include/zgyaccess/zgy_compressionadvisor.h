@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    class CompressionEstimate
+    {
+    public:
+        CompressionEstimate() {};
+
+        // requested tolerance relative to the RMS amplitude, or bits per sample for fixed rate trials
+        double target = 0.0;
+
+        // relative to float32 storage, with constant bricks stored without payload as in ZGY
+        double compressionRatio = 0.0;
+        double rmsError = 0.0;
+        double snr = 0.0;
+
+        // decoded float samples per second and thread, in MB
+        double decodeSpeed = 0.0;
+    };
+
+    // Trial compresses a sample of bricks with zfp directly, in fixed accuracy or fixed rate mode.
+    // These are not the settings of the ZFP compressor OpenZGY uses when writing with a signal to
+    // noise ratio, so the estimates describe zfp at the given tolerance or rate, not a ZGY file
+    // written with zfp_compressor(snr). The measured error and SNR are reported for each trial.
+    class CompressionAdvisor
+    {
+    public:
+        CompressionAdvisor();
+        ~CompressionAdvisor();
+
+        void setSampleBrickCount(int count);
+        void setSeed(unsigned int seed);
+
+        std::vector<CompressionEstimate> estimateAccuracy(const ZGYReader& reader, const std::vector<double>& relativeTolerances);
+        std::vector<CompressionEstimate> estimateBitRate(const ZGYReader& reader, const std::vector<double>& bitsPerSample);
+
+        int sampledBrickCount() const;
+        int constantBrickCount() const;
+
+    private:
+        std::vector<CompressionEstimate> estimate(const ZGYReader& reader, const std::vector<double>& targets, bool fixedRate);
+
+    private:
+        int m_sampleBrickCount;
+        unsigned int m_seed;
+
+        int m_sampledBricks;
+        int m_constantBricks;
+    };
+
+}
@@ -0,0 +1,67 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgy_point.h"
+
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+    class SeismicSliceData;
+
+    class ContourLine
+    {
+    public:
+        ContourLine(double level) : level(level), closed(false) {};
+
+        double level;
+        bool closed;
+        // closed lines do not repeat the first point at the end
+        std::vector<Point2d> points;
+    };
+
+    // Contours of a map grid laid out like a z slice (width inline, depth crossline), such as a
+    // z slice or a horizon. Grid cells with a NaN corner are skipped.
+    class ContourGenerator
+    {
+    public:
+        ContourGenerator(std::vector<double> levels);
+        ~ContourGenerator();
+
+        void setTileSize(int cells);
+        void setSimplifyTolerance(double tolerance);
+
+        // points as fractional inline and crossline indexes
+        std::vector<ContourLine> contours(std::shared_ptr<SeismicSliceData> grid) const;
+
+        // points as world coordinates of the survey
+        std::vector<ContourLine> contours(const ZGYReader& reader, std::shared_ptr<SeismicSliceData> grid) const;
+
+    private:
+        std::vector<ContourLine> trace(std::shared_ptr<SeismicSliceData> grid, const double transform[6]) const;
+
+    private:
+        std::vector<double> m_levels;
+        int m_tileSize;
+        double m_tolerance;
+    };
+
+}
@@ -0,0 +1,85 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class InterleavedSliceData;
+    class MultiVolumeReader;
+    class OutlineMask;
+    class SeismicSliceData;
+
+    // Mini-batch k-means classification of co-located attribute volumes. Each volume is scaled to
+    // [0, 1] over its data range before distances are computed. Class labels are 0 to classCount - 1,
+    // and -1 for samples with a NaN or infinite value in any volume.
+    class FaciesClassifier
+    {
+    public:
+        FaciesClassifier(int nClasses);
+        ~FaciesClassifier();
+
+        void setSeed(unsigned int seed);
+        void setIterations(int iterations);
+        void setBatchColumns(int columns);
+        void setMemoryBudget(std::int64_t bytes);
+
+        bool train(const MultiVolumeReader& volumes, const OutlineMask& mask, int zStartIndex, int zSize);
+
+        int classCount() const;
+        int channelCount() const;
+        std::vector<float> centroid(int classIndex) const;
+
+        void classify(const float* values, size_t nSamples, int* labels) const;
+
+        std::shared_ptr<SeismicSliceData> inlineSlice(const MultiVolumeReader& volumes, int inlineIndex) const;
+        std::shared_ptr<SeismicSliceData> zSlice(const MultiVolumeReader& volumes, int zIndex) const;
+
+        bool writeClassVolume(const MultiVolumeReader& volumes, std::string zgyFilename);
+
+        std::string errorMessage() const;
+
+    private:
+        bool setScaling(const MultiVolumeReader& volumes);
+        void initialize(const std::vector<float>& samples);
+        std::shared_ptr<SeismicSliceData> classifySlice(std::shared_ptr<InterleavedSliceData> slice) const;
+
+    private:
+        int m_classCount;
+        int m_channelCount;
+
+        unsigned int m_seed;
+        int m_iterations;
+        int m_batchColumns;
+        std::int64_t m_memoryBudget;
+
+        std::vector<float> m_offsets;
+        std::vector<float> m_scales;
+
+        // scaled centroids, class major, and the number of samples each has absorbed
+        std::vector<float> m_centroids;
+        std::vector<double> m_counts;
+
+        std::string m_errorMessage;
+    };
+
+}
@@ -0,0 +1,49 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+    class SeismicSliceData;
+
+    // Reads traces with the z window of each trace relative to a horizon, so that the horizon comes
+    // out flat. The horizon is a grid laid out like a z slice holding z values in the units of
+    // ZGYReader::zRange(), with NaN where it is undefined.
+    class HorizonFlattener
+    {
+    public:
+        HorizonFlattener(std::shared_ptr<SeismicSliceData> horizon);
+        ~HorizonFlattener();
+
+        void setFillValue(float fillValue);
+
+        std::shared_ptr<SeismicSliceData> inlineSlice(const ZGYReader& reader, int inlineIndex, int zStartOffset, int zSize) const;
+        std::shared_ptr<SeismicSliceData> xlineSlice(const ZGYReader& reader, int xlineIndex, int zStartOffset, int zSize) const;
+
+        bool readVolume(const ZGYReader& reader, std::array<int, 2> start, std::array<int, 2> size, int zStartOffset, int zSize, float* buffer) const;
+
+    private:
+        std::shared_ptr<SeismicSliceData> m_horizon;
+        float m_fillValue;
+    };
+
+}
@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "seismicslice.h"
+#include "zgy_mapgrid.h"
+
+#include <memory>
+#include <string>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    // Resamples map data on the survey grid (laid out like a z slice) onto a north-up world raster
+    // and writes it as a float32 GeoTIFF.
+    class GeoTiffExporter
+    {
+    public:
+        GeoTiffExporter(const MapGrid& grid);
+        ~GeoTiffExporter();
+
+        // axis aligned grid covering the survey, with rows running from north to south
+        static MapGrid northUpGrid(const ZGYReader& reader, double cellSize);
+
+        void setFillValue(float fillValue);
+        void setEpsgCode(int code);
+        void setTileSize(int pixels);
+
+        std::shared_ptr<SeismicSliceData> resample(const ZGYReader& reader, std::shared_ptr<SeismicSliceData> slice) const;
+
+        bool exportSlice(const ZGYReader& reader, std::shared_ptr<SeismicSliceData> slice, std::string filename);
+        bool exportZSlice(ZGYReader& reader, int zIndex, std::string filename);
+
+        std::string errorMessage() const;
+
+    private:
+        class Transform
+        {
+        public:
+            double base[2] = { 0.0, 0.0 };
+            double stepX[2] = { 0.0, 0.0 };
+            double stepY[2] = { 0.0, 0.0 };
+        };
+
+        Transform indexTransform(const ZGYReader& reader) const;
+        void resampleRow(const Transform& transform, SeismicSliceData& slice, int iy, int ix0, int nx, float* output) const;
+
+    private:
+        MapGrid m_grid;
+        float m_fillValue;
+        int m_epsgCode;
+        int m_tileSize;
+
+        std::string m_errorMessage;
+    };
+
+}
@@ -0,0 +1,54 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    class IsoSurfaceMesh
+    {
+    public:
+        IsoSurfaceMesh() {};
+
+        int vertexCount() const { return (int)(vertices.size() / 3); };
+        int triangleCount() const { return (int)(triangles.size() / 3); };
+
+        // x, y, z triples as full resolution inline, crossline and z sample indices
+        std::vector<float> vertices;
+        // three vertex indices per triangle, normals pointing towards values below the iso value
+        std::vector<int> triangles;
+    };
+
+    class IsoSurfaceExtractor
+    {
+    public:
+        IsoSurfaceExtractor(float isoValue);
+        ~IsoSurfaceExtractor();
+
+        std::unique_ptr<IsoSurfaceMesh> extract(const ZGYReader& reader, int lod, std::array<int, 3> start, std::array<int, 3> size) const;
+
+    private:
+        float m_isoValue;
+    };
+
+}
@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class MultiVolumeReader;
+    class OutlineMask;
+
+    class JointHistogramData
+    {
+    public:
+        JointHistogramData() {};
+
+        int dimensions() const { return (int)binCentres.size(); };
+        double count(const std::vector<int>& bin) const;
+
+        // bin centre values for each dimension
+        std::vector<std::vector<double>> binCentres;
+        // sample count per bin, last dimension fastest
+        std::vector<double> counts;
+    };
+
+    // Histogram over several co-located values per sample, e.g. a crossplot of two attributes
+    class JointHistogramGenerator
+    {
+    public:
+        JointHistogramGenerator(std::vector<int> nBins, std::vector<float> minVals, std::vector<float> maxVals);
+        ~JointHistogramGenerator();
+
+        void addData(const float* values, size_t nSamples);
+        void merge(const JointHistogramGenerator& other);
+
+        std::unique_ptr<JointHistogramData> getHistogram() const;
+
+        static std::unique_ptr<JointHistogramData> crossplot(const MultiVolumeReader& volumes, const OutlineMask& mask, int nBins, int zStartIndex, int zSize);
+
+    private:
+        std::vector<int> m_nBins;
+        std::vector<double> m_minVals;
+        std::vector<double> m_maxVals;
+        std::vector<double> m_scales;
+        std::vector<double> m_counts;
+    };
+
+}
@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    class LiveTraceMask
+    {
+    public:
+        LiveTraceMask();
+        LiveTraceMask(int inlineSize, int xlineSize);
+        ~LiveTraceMask();
+
+        static std::shared_ptr<LiveTraceMask> compute(const ZGYReader& reader);
+
+        int inlineSize() const;
+        int xlineSize() const;
+
+        bool isEmpty() const;
+
+        bool isLive(int inlineIndex, int xlineIndex) const;
+        void setLive(int inlineIndex, int xlineIndex, bool live);
+
+        int liveCount(int inlineIndex) const;
+        std::int64_t liveCount() const;
+
+        bool hasLiveTraces(int inlineStart, int inlineSize, int xlineStart, int xlineSize) const;
+
+        bool save(std::string filename, std::uint64_t sourceStamp) const;
+        bool load(std::string filename, std::uint64_t sourceStamp);
+
+    private:
+        int m_inlineSize;
+        int m_xlineSize;
+
+        std::vector<std::uint64_t> m_bits;
+        std::vector<int> m_rowCount;
+    };
+
+}
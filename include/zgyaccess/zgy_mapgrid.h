@@ -0,0 +1,50 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgy_point.h"
+
+namespace ZGYAccess
+{
+
+    class MapGrid
+    {
+    public:
+        MapGrid();
+        MapGrid(Point2d origin, double spacingX, double spacingY, int sizeX, int sizeY);
+        ~MapGrid();
+
+        Point2d origin() const;
+        double spacingX() const;
+        double spacingY() const;
+        int sizeX() const;
+        int sizeY() const;
+
+        bool isEmpty() const;
+
+        Point2d cellCentre(int ix, int iy) const;
+
+    private:
+        Point2d m_origin;
+        double m_spacingX;
+        double m_spacingY;
+        int m_sizeX;
+        int m_sizeY;
+    };
+
+}
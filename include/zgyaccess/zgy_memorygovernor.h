@@ -0,0 +1,120 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ZGYAccess
+{
+    enum class MemoryCategory
+    {
+        SliceData,
+        // bricks decoded for slice views, whether cached or only held by views
+        DecodedBricks,
+        WriteBuffers
+    };
+
+    // Something holding memory it can give back on request, such as a cache.
+    class MemoryReclaimer
+    {
+    public:
+        virtual ~MemoryReclaimer() {};
+
+        // free at least the given number of bytes if possible, returns the bytes freed
+        virtual std::int64_t reclaim(std::int64_t bytes) = 0;
+    };
+
+    // Process wide accounting of the larger allocations made by ZGYAccess, with an optional budget.
+    // When a request does not fit, registered caches are asked to shrink first. If that is not
+    // enough the request waits for memory to be released, up to the wait timeout, and then fails.
+    // Slices that do not fit are returned empty, and writers fail with an error message.
+    //
+    // Only memory owned by ZGYAccess is counted, not buffers internal to OpenZGY.
+    class MemoryGovernor
+    {
+    public:
+        static MemoryGovernor& instance();
+
+        // 0 means no limit, which is the default
+        void setBudget(std::int64_t bytes);
+        std::int64_t budget() const;
+
+        // 0 fails at once when the budget is used up, which is the default
+        void setWaitTimeout(int milliseconds);
+        int waitTimeout() const;
+
+        bool acquire(MemoryCategory category, std::int64_t bytes);
+        void release(MemoryCategory category, std::int64_t bytes);
+
+        std::int64_t usage() const;
+        std::int64_t usage(MemoryCategory category) const;
+        std::int64_t peakUsage() const;
+        void resetPeakUsage();
+
+        // requests refused since start, because they did not fit within the wait timeout
+        std::int64_t refusedCount() const;
+
+        // the governor only keeps a weak reference, so reclaimers need not be removed
+        void addReclaimer(std::weak_ptr<MemoryReclaimer> reclaimer);
+
+    private:
+        MemoryGovernor();
+
+        bool fits(std::int64_t bytes) const;
+        void take(MemoryCategory category, std::int64_t bytes);
+        void reclaim(std::int64_t bytes);
+
+    private:
+        mutable std::mutex m_mutex;
+        std::condition_variable m_released;
+
+        std::int64_t m_budget;
+        int m_waitTimeout;
+
+        std::int64_t m_usage;
+        std::int64_t m_peakUsage;
+        std::int64_t m_refusedCount;
+        std::array<std::int64_t, 3> m_categoryUsage;
+
+        std::vector<std::weak_ptr<MemoryReclaimer>> m_reclaimers;
+    };
+
+    // Acquires memory from the governor for the lifetime of the object.
+    class MemoryReservation
+    {
+    public:
+        MemoryReservation(MemoryCategory category, std::int64_t bytes);
+        ~MemoryReservation();
+
+        MemoryReservation(const MemoryReservation&) = delete;
+        MemoryReservation& operator=(const MemoryReservation&) = delete;
+
+        bool isValid() const;
+
+    private:
+        MemoryCategory m_category;
+        std::int64_t m_bytes;
+        bool m_valid;
+    };
+
+}
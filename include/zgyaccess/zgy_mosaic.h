@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "seismicslice.h"
+#include "zgy_mapgrid.h"
+
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    enum class MosaicBlend
+    {
+        Priority,
+        Feather
+    };
+
+    class ZSliceMosaic
+    {
+    public:
+        ZSliceMosaic(const MapGrid& grid);
+        ~ZSliceMosaic();
+
+        void setBlendMode(MosaicBlend mode, double featherWidth = 0.0);
+
+        void addSurvey(std::shared_ptr<ZGYReader> reader, int priority);
+        void clearSurveys();
+
+        std::shared_ptr<SeismicSliceData> zSlice(double z, float fillValue) const;
+
+    private:
+        class Survey
+        {
+        public:
+            std::shared_ptr<ZGYReader> reader;
+            int priority;
+        };
+
+    private:
+        MapGrid m_grid;
+        MosaicBlend m_blendMode;
+        double m_featherWidth;
+
+        std::vector<Survey> m_surveys;
+    };
+
+}
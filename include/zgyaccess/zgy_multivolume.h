@@ -0,0 +1,88 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+    class OutlineMask;
+
+    // Slice holding several co-located volumes, with the channels of each sample next to each other
+    class InterleavedSliceData
+    {
+    public:
+        InterleavedSliceData(int width, int depth, int channels);
+        ~InterleavedSliceData();
+
+        float* values();
+        float valueAt(int width, int depth, int channel) const;
+
+        int size() const;
+        int width() const;
+        int depth() const;
+        int channels() const;
+
+        bool isEmpty() const;
+        // empty because the memory governor refused the buffer
+        bool isOutOfMemory() const;
+
+    private:
+        int m_width;
+        int m_depth;
+        int m_channels;
+        bool m_outOfMemory;
+        std::unique_ptr<MemoryReservation> m_reservation;
+        std::vector<float> m_values;
+    };
+
+    class MultiVolumeReader
+    {
+    public:
+        MultiVolumeReader();
+        ~MultiVolumeReader();
+
+        void addVolume(std::shared_ptr<ZGYReader> reader);
+        void clearVolumes();
+        int volumeCount() const;
+        std::shared_ptr<ZGYReader> volume(int index) const;
+        bool isCompatible() const;
+
+        std::shared_ptr<InterleavedSliceData> inlineSlice(int inlineIndex, int zStartIndex, int zSize) const;
+        std::shared_ptr<InterleavedSliceData> xlineSlice(int xlineIndex, int zStartIndex, int zSize) const;
+        std::shared_ptr<InterleavedSliceData> zSlice(int zIndex) const;
+
+        bool readInterleaved(std::array<int, 3> start, std::array<int, 3> size, float* values) const;
+
+        std::vector<std::array<int, 2>> maskedBrickColumns(const OutlineMask& mask) const;
+        bool readMaskedColumn(const OutlineMask& mask, std::array<int, 2> column, int zStartIndex, int zSize, const std::function<void(const float*, size_t)>& callback) const;
+
+    private:
+        std::shared_ptr<InterleavedSliceData> readSlice(std::array<int, 3> start, std::array<int, 3> size, int width, int depth) const;
+
+    private:
+        std::vector<std::shared_ptr<ZGYReader>> m_volumes;
+    };
+
+}
@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgy_outline.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    class OutlineMask
+    {
+    public:
+        enum class Coverage
+        {
+            Outside,
+            Partial,
+            Inside
+        };
+
+    public:
+        OutlineMask();
+        OutlineMask(const ZGYReader& reader, const Outline& worldOutline);
+        OutlineMask(int inlineSize, int xlineSize, const Outline& indexOutline);
+        ~OutlineMask();
+
+        int inlineSize() const;
+        int xlineSize() const;
+
+        bool isEmpty() const;
+        bool isInside(int inlineIndex, int xlineIndex) const;
+
+        const std::vector<std::pair<int, int>>& spans(int inlineIndex) const;
+        std::int64_t traceCount() const;
+
+        Coverage coverage(int inlineStart, int inlineSize, int xlineStart, int xlineSize) const;
+
+    private:
+        void buildSpans(const std::vector<std::pair<double, double>>& polygon);
+
+    private:
+        int m_inlineSize;
+        int m_xlineSize;
+        std::int64_t m_traceCount;
+
+        std::vector<std::vector<std::pair<int, int>>> m_spans;
+    };
+
+}
@@ -0,0 +1,111 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    enum class PackedSampleFormat
+    {
+        Float16,
+        BFloat16,
+        UInt16,
+        UInt8
+    };
+
+    // Slice with samples stored in a compact format. The normalised formats map the value range
+    // linearly onto the full integer range, with values outside it clamped and NaN stored as 0.
+    class PackedSliceData
+    {
+    public:
+        PackedSliceData(int width, int depth, PackedSampleFormat format, float minValue, float maxValue);
+        ~PackedSliceData();
+
+        std::uint8_t* data();
+        size_t byteSize() const;
+
+        float valueAt(int width, int depth) const;
+
+        int size() const;
+        int width() const;
+        int depth() const;
+
+        PackedSampleFormat format() const;
+        std::pair<float, float> valueRange() const;
+
+        bool isEmpty() const;
+        // empty because the memory governor refused the buffer
+        bool isOutOfMemory() const;
+
+        static int bytesPerSample(PackedSampleFormat format);
+
+        static void pack(const float* values, size_t nValues, PackedSampleFormat format, float minValue, float maxValue, std::uint8_t* output);
+        static float unpack(const std::uint8_t* data, size_t index, PackedSampleFormat format, float minValue, float maxValue);
+
+        static std::uint16_t toFloat16(float value);
+        static float fromFloat16(std::uint16_t value);
+        static std::uint16_t toBFloat16(float value);
+        static float fromBFloat16(std::uint16_t value);
+
+    private:
+        int m_width;
+        int m_depth;
+        PackedSampleFormat m_format;
+        float m_minValue;
+        float m_maxValue;
+        bool m_outOfMemory;
+        std::unique_ptr<MemoryReservation> m_reservation;
+        std::vector<std::uint8_t> m_data;
+    };
+
+    // Reads slices straight into a packed format. The read is split along the brick grid, and each
+    // brick sized piece is converted while still in cache, so no float copy of the slice is made.
+    class PackedSliceReader
+    {
+    public:
+        PackedSliceReader(std::shared_ptr<ZGYReader> reader, PackedSampleFormat format);
+        ~PackedSliceReader();
+
+        void setValueRange(float minValue, float maxValue);
+
+        std::shared_ptr<PackedSliceData> inlineSlice(int inlineIndex, int zStartIndex, int zSize) const;
+        std::shared_ptr<PackedSliceData> xlineSlice(int xlineIndex, int zStartIndex, int zSize) const;
+        std::shared_ptr<PackedSliceData> zSlice(int zIndex) const;
+
+        bool readVolume(std::array<int, 3> start, std::array<int, 3> size, std::uint8_t* output) const;
+
+    private:
+        std::shared_ptr<PackedSliceData> readSlice(std::array<int, 3> start, std::array<int, 3> size, int width, int depth) const;
+
+    private:
+        std::shared_ptr<ZGYReader> m_reader;
+        PackedSampleFormat m_format;
+        float m_minValue;
+        float m_maxValue;
+    };
+
+}
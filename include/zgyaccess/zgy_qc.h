@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/zgy_statistics.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    class QcReport
+    {
+    public:
+        QcReport() {};
+
+        bool passed() const;
+        std::string toJson() const;
+
+        bool readFailed = false;
+
+        std::int64_t sampleCount = 0;
+        std::int64_t nanCount = 0;
+        std::int64_t infCount = 0;
+
+        // statistics of the finite samples, how many samples sit exactly at the extremes, and how
+        // many at the next distinct value inside each extreme
+        SampleStatistics statistics;
+        std::int64_t minValueCount = 0;
+        std::int64_t maxValueCount = 0;
+        std::int64_t minNeighbourCount = 0;
+        std::int64_t maxNeighbourCount = 0;
+        bool isClipped = false;
+
+        std::int64_t traceCount = 0;
+        std::int64_t zeroTraceCount = 0;
+        // inline/crossline indices of the first zeroed traces found, in trace order
+        std::vector<std::array<int, 2>> zeroTraces;
+
+        // cross-checks against the values stored in the file
+        std::pair<double, double> storedDataRange{ 0.0, 0.0 };
+        SampleStatistics storedStatistics;
+        std::int64_t storedHistogramCount = 0;
+        double storedHistogramMean = 0.0;
+
+        bool dataRangeConsistent = true;
+        bool statisticsConsistent = true;
+        bool histogramConsistent = true;
+    };
+
+    class QcScanner
+    {
+    public:
+        QcScanner();
+        ~QcScanner();
+
+        void setClipFraction(double fraction);
+        void setMaxReportedTraces(int count);
+
+        QcReport scan(ZGYReader& reader) const;
+
+    private:
+        double m_clipFraction;
+        int m_maxReportedTraces;
+    };
+
+}
@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "seismicslice.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    // Inline section reader for panning a z window. When the next window overlaps the previous one
+    // on the same inline, the overlap is shifted in place and only the exposed z range is read.
+    // The returned slice is owned by the section reader and is updated in place by the next call.
+    class InlineSectionReader
+    {
+    public:
+        InlineSectionReader(std::shared_ptr<ZGYReader> reader);
+        ~InlineSectionReader();
+
+        std::shared_ptr<SeismicSliceData> inlineSlice(int inlineIndex, int zStartIndex, int zSize);
+        void reset();
+
+        // samples read from the file by the last call, for monitoring the panning cost
+        std::int64_t samplesRead() const;
+
+    private:
+        bool readRange(int zStartIndex, int zSize, int zOffset);
+
+    private:
+        std::shared_ptr<ZGYReader> m_reader;
+
+        std::shared_ptr<SeismicSliceData> m_slice;
+        int m_inlineIndex;
+        int m_zStart;
+
+        std::int64_t m_samplesRead;
+    };
+
+}
@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ZGYAccess
+{
+
+    class SegyFormat
+    {
+    public:
+        enum class SampleFormat
+        {
+            IbmFloat = 1,
+            Int32 = 2,
+            Int16 = 3,
+            IeeeFloat = 5,
+            Int8 = 8
+        };
+
+        static const int textHeaderSize = 3200;
+        static const int binaryHeaderSize = 400;
+        static const int traceHeaderSize = 240;
+
+        // binary header fields, as byte offsets from the start of the file
+        static const int sampleIntervalOffset = 3216;
+        static const int sampleCountOffset = 3220;
+        static const int sampleFormatOffset = 3224;
+        static const int revisionOffset = 3500;
+        static const int fixedLengthOffset = 3502;
+        static const int extendedHeaderCountOffset = 3504;
+
+        // trace header fields, as 1-based byte positions within the trace header
+        static const int traceSequenceByte = 1;
+        static const int coordinateScalarByte = 71;
+        static const int delayTimeByte = 109;
+        static const int traceSampleCountByte = 115;
+        static const int traceSampleIntervalByte = 117;
+        static const int cdpXByte = 181;
+        static const int cdpYByte = 185;
+        static const int inlineByte = 189;
+        static const int xlineByte = 193;
+
+    public:
+        static int bytesPerSample(SampleFormat format);
+        static bool isSupported(int formatCode);
+
+        static std::int16_t readInt16(const std::uint8_t* data);
+        static std::int32_t readInt32(const std::uint8_t* data);
+        static void writeInt16(std::uint8_t* data, std::int16_t value);
+        static void writeInt32(std::uint8_t* data, std::int32_t value);
+
+        static void toFloat(const std::uint8_t* data, SampleFormat format, size_t nSamples, float* values);
+        static void fromFloat(const float* values, SampleFormat format, size_t nSamples, std::uint8_t* data);
+    };
+
+}
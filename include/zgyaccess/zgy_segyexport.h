@@ -0,0 +1,49 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/zgy_segy.h"
+
+#include <cstdint>
+#include <string>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    class SegyExporter
+    {
+    public:
+        SegyExporter();
+        ~SegyExporter();
+
+        void setSampleFormat(SegyFormat::SampleFormat format);
+        void setMemoryBudget(std::int64_t bytes);
+
+        bool exportToFile(const ZGYReader& reader, std::string segyFilename);
+
+        std::string errorMessage() const;
+
+    private:
+        SegyFormat::SampleFormat m_format;
+        std::int64_t m_memoryBudget;
+
+        std::string m_errorMessage;
+    };
+
+}
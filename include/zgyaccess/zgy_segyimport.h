@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace ZGYAccess
+{
+
+    class SegyImporter
+    {
+    public:
+        SegyImporter();
+        ~SegyImporter();
+
+        void setHeaderPositions(int inlineByte, int xlineByte, int cdpXByte, int cdpYByte);
+        void setCompression(float snr);
+        void setMemoryBudget(std::int64_t bytes);
+
+        bool import(std::string segyFilename, std::string zgyFilename);
+
+        std::string errorMessage() const;
+
+    private:
+        int m_inlineByte;
+        int m_xlineByte;
+        int m_cdpXByte;
+        int m_cdpYByte;
+
+        float m_snr;
+        std::int64_t m_memoryBudget;
+
+        std::string m_errorMessage;
+    };
+
+}
@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class SeismicSliceData;
+
+    enum class SliceCodec
+    {
+        Zfp,
+        Lossless
+    };
+
+    // Encodes slices into a compact buffer for sending over the network. The buffer starts with a
+    // small header giving the codec, the slice size and the byte size of each tile, so it can be
+    // decoded without any other information. Tiles are runs of whole traces and are encoded and
+    // decoded in parallel.
+    //
+    // Zfp keeps every sample within the given tolerance and expects finite samples. Lossless is
+    // meant for slices read from int8 or int16 files, which hold few distinct values; it stores a
+    // palette of the values, NaN included, and bit packs the differences between neighbouring
+    // palette indices. Slices with more than 65536 distinct values can not be encoded losslessly.
+    class SliceEncoder
+    {
+    public:
+        SliceEncoder();
+        ~SliceEncoder();
+
+        // traces per tile, default 64
+        void setTileTraces(int traces);
+
+        std::vector<std::uint8_t> encodeZfp(std::shared_ptr<SeismicSliceData> slice, double tolerance) const;
+        std::vector<std::uint8_t> encodeLossless(std::shared_ptr<SeismicSliceData> slice) const;
+
+        static std::shared_ptr<SeismicSliceData> decode(const std::uint8_t* data, size_t size);
+        static bool readHeader(const std::uint8_t* data, size_t size, SliceCodec& codec, int& width, int& depth);
+
+    private:
+        int m_tileTraces;
+    };
+
+}
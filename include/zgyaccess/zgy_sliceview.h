@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/seismicslice.h"
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+    // Full resolution brick decoded to floats, clipped to the survey at the edges
+    class DecodedBrick
+    {
+    public:
+        DecodedBrick() {};
+
+        const float* trace(int inlineIndex, int xlineIndex) const
+        {
+            return samples.data() + ((size_t)(inlineIndex - start[0]) * size[1] + (xlineIndex - start[1])) * size[2];
+        };
+
+        std::array<int, 3> start{ 0, 0, 0 };
+        std::array<int, 3> size{ 0, 0, 0 };
+        std::vector<float> samples;
+
+        // the samples count against the memory budget until the last holder lets go of the brick
+        std::unique_ptr<MemoryReservation> reservation;
+    };
+
+    // Inline z window referencing the decoded bricks it covers, without copying any samples.
+    // Each trace is a run of segments, one per brick in z.
+    class SeismicSliceView
+    {
+    public:
+        SeismicSliceView();
+        SeismicSliceView(int inlineIndex, int zStart, int zSize, int width, std::array<int, 3> brickSize, std::vector<std::shared_ptr<const DecodedBrick>> bricks, std::shared_ptr<void> cacheHold = nullptr);
+        ~SeismicSliceView();
+
+        int width() const;
+        int depth() const;
+        bool isEmpty() const;
+
+        int segmentCount() const;
+        const float* segment(int trace, int segmentIndex, int& nSamples) const;
+
+        float valueAt(int width, int depth) const;
+        void copyTrace(int trace, float* values) const;
+        std::shared_ptr<SeismicSliceData> gather() const;
+
+    private:
+        const DecodedBrick* brickFor(int trace, int segmentIndex) const;
+
+    private:
+        int m_inlineIndex;
+        int m_zStart;
+        int m_zSize;
+        int m_width;
+        std::array<int, 3> m_brickSize;
+        int m_bricksPerTrace;
+
+        // ordered by crossline brick, then z brick
+        std::vector<std::shared_ptr<const DecodedBrick>> m_bricks;
+
+        // room kept in the brick cache for these bricks until the view is released
+        std::shared_ptr<void> m_cacheHold;
+    };
+
+}
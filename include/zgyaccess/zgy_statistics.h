@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace ZGYAccess
+{
+
+    class SampleStatistics
+    {
+    public:
+        SampleStatistics();
+
+        void add(const float* values, size_t nValues);
+        void merge(const SampleStatistics& other);
+
+        void reset();
+
+        double mean() const;
+        double rms() const;
+        double stdDev() const;
+
+        std::int64_t count;
+        double sum;
+        double sumSquares;
+        double minValue;
+        double maxValue;
+    };
+
+}
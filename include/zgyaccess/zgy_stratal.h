@@ -0,0 +1,48 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+    class SeismicSliceData;
+
+    // Samples a volume at fixed proportions between a top and a base horizon. Horizons are grids
+    // laid out like a z slice (width inline, depth crossline) holding z values in the units of
+    // ZGYReader::zRange(), with NaN where the horizon is undefined.
+    class StratalSlicer
+    {
+    public:
+        StratalSlicer();
+        ~StratalSlicer();
+
+        void setFillValue(float fillValue);
+
+        std::vector<std::shared_ptr<SeismicSliceData>> slices(const ZGYReader& reader,
+                                                              std::shared_ptr<SeismicSliceData> top,
+                                                              std::shared_ptr<SeismicSliceData> base,
+                                                              const std::vector<double>& proportions) const;
+
+    private:
+        float m_fillValue;
+    };
+
+}
@@ -0,0 +1,92 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+    enum class SyntheticSampleType
+    {
+        Int8,
+        Int16,
+        Float32
+    };
+
+    class SyntheticVolumeGenerator
+    {
+    public:
+        SyntheticVolumeGenerator(int inlineSize, int xlineSize, int zSize);
+        ~SyntheticVolumeGenerator();
+
+        void setSampleType(SyntheticSampleType sampleType);
+        void setCompression(float snr);
+        void setSeed(unsigned int seed);
+        void setDeadAreas(bool enable);
+        void setMemoryBudget(std::int64_t bytes);
+
+        bool write(std::string zgyFilename);
+
+        // the samples written for one trace, before conversion to the storage type
+        void generateTrace(int inlineIndex, int xlineIndex, float* values) const;
+        bool isDeadTrace(int inlineIndex, int xlineIndex) const;
+
+        float amplitudeLimit() const;
+
+        std::string errorMessage() const;
+
+    private:
+        class Layer
+        {
+        public:
+            double depth = 0.0;
+            double reflectivity = 0.0;
+        };
+
+        class Undulation
+        {
+        public:
+            double amplitude = 0.0;
+            double waveInline = 0.0;
+            double waveXline = 0.0;
+            double phase = 0.0;
+        };
+
+        void buildModel();
+        double structure(int inlineIndex, int xlineIndex) const;
+
+    private:
+        std::array<int, 3> m_size;
+
+        SyntheticSampleType m_sampleType;
+        float m_snr;
+        unsigned int m_seed;
+        bool m_deadAreas;
+        std::int64_t m_memoryBudget;
+
+        std::vector<Layer> m_layers;
+        std::vector<Undulation> m_undulations;
+
+        std::string m_errorMessage;
+    };
+
+}
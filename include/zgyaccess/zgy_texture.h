@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    enum class TextureFormat
+    {
+        UNorm8,
+        UNorm16
+    };
+
+    class TextureBrick
+    {
+    public:
+        TextureBrick() {};
+
+        // first interior sample of the brick, in the index space of the exported level of detail
+        std::array<int, 3> origin{ 0, 0, 0 };
+        // number of interior samples holding data, the rest of the brick is edge padding
+        std::array<int, 3> size{ 0, 0, 0 };
+
+        std::vector<std::uint8_t> data;
+    };
+
+    class TextureBrickSet
+    {
+    public:
+        TextureBrickSet() {};
+
+        int paddedSize() const { return brickSize + 2 * border; };
+        int bytesPerSample() const { return (format == TextureFormat::UNorm16) ? 2 : 1; };
+
+        int lod = 0;
+        int brickSize = 0;
+        int border = 0;
+        TextureFormat format = TextureFormat::UNorm8;
+        float minValue = 0.0f;
+        float maxValue = 0.0f;
+        std::array<int, 3> brickCount{ 0, 0, 0 };
+
+        std::vector<TextureBrick> bricks;
+    };
+
+    class TextureBrickExporter
+    {
+    public:
+        TextureBrickExporter(int brickSize, int border, TextureFormat format);
+        ~TextureBrickExporter();
+
+        void setValueRange(float minVal, float maxVal);
+
+        std::unique_ptr<TextureBrickSet> exportVolume(const ZGYReader& reader, int lod, std::array<int, 3> start, std::array<int, 3> size) const;
+
+    private:
+        void convertBrick(const ZGYReader& reader, int lod, std::array<int, 3> lodSize, TextureBrick& brick, float minVal, float maxVal) const;
+
+    private:
+        int m_brickSize;
+        int m_border;
+        TextureFormat m_format;
+
+        bool m_useValueRange;
+        float m_minVal;
+        float m_maxVal;
+    };
+
+}
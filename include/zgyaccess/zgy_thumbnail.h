@@ -0,0 +1,126 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ZGYAccess
+{
+    class ZGYReader;
+
+    enum class ThumbnailColorMap
+    {
+        Grey,
+        Seismic
+    };
+
+    // RGBA image, four bytes per pixel, row by row. NaN samples are transparent.
+    class ThumbnailImage
+    {
+    public:
+        ThumbnailImage();
+        ThumbnailImage(int width, int height);
+        ~ThumbnailImage();
+
+        ThumbnailImage(ThumbnailImage&&) = default;
+        ThumbnailImage& operator=(ThumbnailImage&&) = default;
+
+        int width() const;
+        int height() const;
+        bool isEmpty() const;
+        // empty because the memory governor refused the pixels
+        bool isOutOfMemory() const;
+
+        std::uint8_t* data();
+        const std::uint8_t* data() const;
+        size_t byteSize() const;
+
+        std::array<std::uint8_t, 4> pixel(int x, int y) const;
+
+    private:
+        int m_width;
+        int m_height;
+        bool m_outOfMemory;
+        std::unique_ptr<MemoryReservation> m_reservation;
+        std::vector<std::uint8_t> m_rgba;
+    };
+
+    // Previews of the middle inline, crossline and z slice. Image columns follow the first axis
+    // of the slice and rows the second, so z increases downwards in the inline and xline images.
+    class SurveyThumbnails
+    {
+    public:
+        SurveyThumbnails() {};
+
+        bool isEmpty() const;
+
+        bool save(std::string filename, std::uint64_t sourceStamp) const;
+        bool load(std::string filename, std::uint64_t sourceStamp);
+
+        ThumbnailImage inlineImage;
+        ThumbnailImage xlineImage;
+        ThumbnailImage zImage;
+
+        // level of detail the images were made from, and the clip range used
+        int lod = 0;
+        float clipMin = 0.0f;
+        float clipMax = 0.0f;
+
+        // settings used, so a cached set made with other settings is not reused
+        int maxSize = 0;
+        ThumbnailColorMap colorMap = ThumbnailColorMap::Grey;
+        double clipPercentile = 0.0;
+    };
+
+    // Makes survey previews from the coarsest level of detail, which is usually a single brick,
+    // so only a few bricks are read per file. The clip range is taken from percentiles of the
+    // samples read, and made symmetric around zero for the seismic color map.
+    class ThumbnailGenerator
+    {
+    public:
+        ThumbnailGenerator();
+        ~ThumbnailGenerator();
+
+        // longest side of the images in pixels, default 128
+        void setMaxSize(int pixels);
+        // samples above this percentile, or below 100 minus it, are clipped, default 99
+        void setClipPercentile(double percentile);
+        void setColorMap(ThumbnailColorMap colorMap);
+
+        std::shared_ptr<SurveyThumbnails> generate(const ZGYReader& reader) const;
+
+        // cached in a sidecar file next to the ZGY file, made again if the file has changed
+        std::shared_ptr<SurveyThumbnails> thumbnails(std::string filename) const;
+        std::vector<std::shared_ptr<SurveyThumbnails>> thumbnails(const std::vector<std::string>& filenames) const;
+
+    private:
+        ThumbnailImage render(const std::vector<float>& samples, int width, int depth, float clipMin, float clipMax) const;
+
+    private:
+        int m_maxSize;
+        double m_clipPercentile;
+        ThumbnailColorMap m_colorMap;
+    };
+
+}
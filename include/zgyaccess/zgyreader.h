@@ -23,10 +23,15 @@
 #include <utility>
 #include <memory>
 #include <cmath>
+#include <functional>
 
 #include "seismicslice.h"
 #include "zgy_outline.h"
+#include "zgy_outlinemask.h"
 #include "zgy_histogram.h"
+#include "zgy_livemask.h"
+#include "zgy_statistics.h"
+#include "zgy_sliceview.h"
 
 namespace OpenZGY
 {
@@ -35,6 +40,8 @@ namespace OpenZGY
 
 namespace ZGYAccess
 {
+    class BrickCache;
+
     class ZGYReader
     {
     public:
@@ -44,6 +51,9 @@ namespace ZGYAccess
         bool open(std::string filename);
         void close();
 
+        std::string filename() const;
+        std::shared_ptr<ZGYReader> clone() const;
+
         std::vector<std::pair<std::string, std::string>> metaData();
 
         std::pair<double, double> zRange() const;
@@ -60,33 +70,60 @@ namespace ZGYAccess
 
         std::pair<double, double> dataRange() const;
 
+        int lodCount() const;
+        std::array<int, 3> brickSize() const;
+        std::array<int, 3> sizeAtLod(int lod) const;
+
+        bool readVolume(int lod, std::array<int, 3> start, std::array<int, 3> size, float* buffer) const;
+        bool isConstant(int lod, std::array<int, 3> start, std::array<int, 3> size, float& value) const;
+
         std::pair<double, double> toWorldCoordinate(int inLine, int crossLine) const;
         std::pair<int, int> toInlineXline(double worldX, double worldY) const;
+        std::pair<double, double> toInlineXlineIndex(double worldX, double worldY) const;
 
         std::shared_ptr<SeismicSliceData> inlineSlice(int inlineIndex);
         std::shared_ptr<SeismicSliceData> inlineSlice(int inlineIndex, int zStartIndex, int zSize);
+        std::shared_ptr<SeismicSliceView> inlineSliceView(int inlineIndex, int zStartIndex, int zSize);
 
         std::shared_ptr<SeismicSliceData> xlineSlice(int xlineIndex);
         std::shared_ptr<SeismicSliceData> xlineSlice(int xlineIndex, int zStartIndex, int zSize);
 
         std::shared_ptr<SeismicSliceData> zSlice(int zIndex);
+        std::shared_ptr<SeismicSliceData> zSlice(int zIndex, const OutlineMask& mask, float fillValue);
 
         std::shared_ptr<SeismicSliceData> zTrace(int inlineIndex, int xlineIndex);
         std::shared_ptr<SeismicSliceData> zTrace(int inlineIndex, int xlineIndex, int zStartIndex, int zSize);
 
         HistogramData* histogram();
+        SampleStatistics storedStatistics() const;
+
+        SampleStatistics statistics(const OutlineMask& mask, int zStartIndex, int zSize) const;
+        std::unique_ptr<HistogramData> histogram(const OutlineMask& mask, int nBins, int zStartIndex, int zSize) const;
 
         Outline seismicWorldOutline();
 
+        std::shared_ptr<const LiveTraceMask> liveTraceMask();
+        bool isLiveTrace(int inlineIndex, int xlineIndex);
+
+        void setBrickCacheSize(int bricks);
+
     private:
         std::string cornerToString(std::array<double, 2> corner);
         std::string sizeToString(std::array<std::int64_t, 3> size);
 
+        std::vector<std::array<int, 2>> maskedBrickColumns(const OutlineMask& mask) const;
+        std::shared_ptr<const DecodedBrick> decodedBrick(std::array<int, 3> brickIndex) const;
+
+        bool readMaskedColumn(const OutlineMask& mask, std::array<int, 2> column, int zStartIndex, int zSize, const std::function<void(const float*, size_t)>& callback) const;
+
     private:
         std::string                          m_filename;
         std::shared_ptr<OpenZGY::IZgyReader> m_reader;
 
         HistogramData m_histogram;
+
+        std::shared_ptr<LiveTraceMask> m_liveTraceMask;
+        std::shared_ptr<BrickCache> m_brickCache;
     };
 
 }
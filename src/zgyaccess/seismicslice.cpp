@@ -21,6 +21,10 @@
 #include "api.h"
 
 #include "zgyaccess/seismicslice.h"
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <limits>
+#include <new>
 
 namespace ZGYAccess
 {
@@ -31,11 +35,37 @@ namespace ZGYAccess
 SeismicSliceData::SeismicSliceData(int width, int height)
     : m_width(width)
     , m_depth(height)
+    , m_outOfMemory(false)
 {
-    const int size = height * width;
+    const std::int64_t size = (std::int64_t)height * width;
+
+    // a slice that can not be indexed, does not fit in the memory budget or can not be allocated
+    // is created empty and flagged, with nothing left counted against the budget
+    if ((width < 0) || (height < 0) || (size > std::numeric_limits<int>::max()))
+    {
+        m_width = 0;
+        m_depth = 0;
+        m_outOfMemory = true;
+        return;
+    }
+
+    m_reservation = std::make_unique<MemoryReservation>(MemoryCategory::SliceData, size * (std::int64_t)sizeof(float));
+
+    try
+    {
+        if (m_reservation->isValid()) m_values = std::unique_ptr<float>(new float[size]);
+    }
+    catch (const std::bad_alloc&)
+    {
+    }
 
-    float* buffer = new float[size];
-    m_values = std::unique_ptr<float>(buffer);
+    if (m_values == nullptr)
+    {
+        m_reservation.reset();
+        m_width = 0;
+        m_depth = 0;
+        m_outOfMemory = true;
+    }
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -43,7 +73,7 @@ SeismicSliceData::SeismicSliceData(int width, int height)
 //--------------------------------------------------------------------------------------------------
 SeismicSliceData::~SeismicSliceData()
 {
-
+    reset();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -87,6 +117,7 @@ void SeismicSliceData::reset()
     m_depth = 0;
 
     m_values.reset();
+    m_reservation.reset();
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -97,6 +128,14 @@ bool SeismicSliceData::isEmpty() const
     return size() == 0;
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SeismicSliceData::isOutOfMemory() const
+{
+    return m_outOfMemory;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgy_brickcache.h"
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+BrickCache::BrickCache(size_t maxBricks)
+    : m_maxBricks(maxBricks)
+    , m_heldBricks(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+BrickCache::~BrickCache()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void BrickCache::setMaxBricks(size_t maxBricks)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_maxBricks = maxBricks;
+    evict();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t BrickCache::maxBricks()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_maxBricks;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Room for the given number of bricks on top of the maximum, until the returned handle is
+/// released. A disabled cache stays disabled.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<void> BrickCache::holdCapacity(size_t bricks)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_maxBricks == 0) return nullptr;
+        m_heldBricks += bricks;
+    }
+
+    std::weak_ptr<BrickCache> cache = shared_from_this();
+    return std::shared_ptr<void>(nullptr, [cache, bricks](void*) {
+        if (auto owner = cache.lock()) owner->releaseCapacity(bricks);
+    });
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void BrickCache::releaseCapacity(size_t bricks)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_heldBricks -= bricks;
+    evict();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void BrickCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_bricks.clear();
+    m_order.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t BrickCache::key(std::array<int, 3> brickIndex)
+{
+    return ((std::uint64_t)brickIndex[0] << 42) | ((std::uint64_t)brickIndex[1] << 21) | (std::uint64_t)brickIndex[2];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<const DecodedBrick> BrickCache::find(std::array<int, 3> brickIndex)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_bricks.find(key(brickIndex));
+    if (it == m_bricks.end()) return nullptr;
+
+    m_order.splice(m_order.begin(), m_order, it->second.second);
+    return it->second.first;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Returns the cached brick, which is the one already present if another thread got there first.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<const DecodedBrick> BrickCache::insert(std::array<int, 3> brickIndex, std::shared_ptr<const DecodedBrick> brick)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::uint64_t k = key(brickIndex);
+
+    auto it = m_bricks.find(k);
+    if (it != m_bricks.end())
+    {
+        m_order.splice(m_order.begin(), m_order, it->second.second);
+        return it->second.first;
+    }
+
+    if (m_maxBricks == 0) return brick;
+
+    m_order.push_front(k);
+    m_bricks[k] = { brick, m_order.begin() };
+    evict();
+
+    return brick;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void BrickCache::evict()
+{
+    while (m_bricks.size() > m_maxBricks + m_heldBricks) evictOldest();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Returns the bytes freed, which is nothing if the brick is still held elsewhere. Its reservation
+/// is then released by the last holder.
+//--------------------------------------------------------------------------------------------------
+std::int64_t BrickCache::evictOldest()
+{
+    auto it = m_bricks.find(m_order.back());
+    const std::int64_t bytes = (it->second.first.use_count() == 1) ? byteSize(*it->second.first) : 0;
+
+    m_bricks.erase(it);
+    m_order.pop_back();
+
+    return bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t BrickCache::byteSize(const DecodedBrick& brick)
+{
+    return (std::int64_t)brick.samples.size() * sizeof(float);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Evict least recently used bricks until the given number of bytes is freed or the cache is empty.
+//--------------------------------------------------------------------------------------------------
+std::int64_t BrickCache::reclaim(std::int64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::int64_t freed = 0;
+    while ((freed < bytes) && !m_order.empty()) freed += evictOldest();
+
+    return freed;
+}
+
+}
@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/zgy_memorygovernor.h"
+#include "zgyaccess/zgy_sliceview.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace ZGYAccess
+{
+
+    // Least recently used cache of decoded full resolution bricks, safe to use from several threads.
+    // Bricks handed out stay alive after eviction for as long as someone holds them. Each brick holds
+    // its own memory reservation, and the cache evicts bricks when asked to reclaim memory.
+    //
+    // Slice views hold extra capacity for the bricks they cover while they are alive, so that the
+    // next view over the same bricks is served from the cache even when the cache is small.
+    class BrickCache : public MemoryReclaimer, public std::enable_shared_from_this<BrickCache>
+    {
+    public:
+        explicit BrickCache(size_t maxBricks);
+        ~BrickCache();
+
+        void setMaxBricks(size_t maxBricks);
+        size_t maxBricks();
+        std::shared_ptr<void> holdCapacity(size_t bricks);
+        void clear();
+
+        std::shared_ptr<const DecodedBrick> find(std::array<int, 3> brickIndex);
+        std::shared_ptr<const DecodedBrick> insert(std::array<int, 3> brickIndex, std::shared_ptr<const DecodedBrick> brick);
+
+        std::int64_t reclaim(std::int64_t bytes) override;
+
+    private:
+        static std::uint64_t key(std::array<int, 3> brickIndex);
+        static std::int64_t byteSize(const DecodedBrick& brick);
+        void releaseCapacity(size_t bricks);
+        void evict();
+        std::int64_t evictOldest();
+
+    private:
+        std::mutex m_mutex;
+        size_t m_maxBricks;
+        size_t m_heldBricks;
+
+        std::list<std::uint64_t> m_order;
+        std::unordered_map<std::uint64_t, std::pair<std::shared_ptr<const DecodedBrick>, std::list<std::uint64_t>::iterator>> m_bricks;
+    };
+
+}
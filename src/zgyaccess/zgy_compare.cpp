@@ -0,0 +1,257 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_compare.h"
+#include "zgyaccess/zgyreader.h"
+
+#include "zgy_mappedfile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    class BrickResult
+    {
+    public:
+        bool isConstant = false;
+        std::int64_t differingSamples = 0;
+        double maxDifference = 0.0;
+        double sumSquares = 0.0;
+    };
+
+    // NaN matches NaN, and counts as an infinite difference against anything else
+    inline double sampleDifference(float a, float b)
+    {
+        if (a == b) return 0.0;
+
+        const bool nanA = std::isnan(a);
+        const bool nanB = std::isnan(b);
+        if (nanA && nanB) return 0.0;
+        if (nanA || nanB) return std::numeric_limits<double>::infinity();
+
+        return std::abs((double)a - (double)b);
+    }
+
+    // compare the raw bytes of the two files in parallel chunks, at the speed of reading them
+    bool identicalFiles(const std::string& firstName, const std::string& secondName)
+    {
+        if (firstName.empty() || secondName.empty()) return false;
+
+        MappedFile first;
+        MappedFile second;
+        if (!first.open(firstName) || !second.open(secondName) || (first.size() != second.size())) return false;
+
+        const std::int64_t chunkBytes = std::int64_t(16) << 20;
+        const std::int64_t nChunks = ((std::int64_t)first.size() + chunkBytes - 1) / chunkBytes;
+        std::atomic<bool> differs(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (std::int64_t c = 0; c < nChunks; c++)
+        {
+            if (differs) continue;
+
+            const std::int64_t offset = c * chunkBytes;
+            const size_t bytes = (size_t)std::min<std::int64_t>(chunkBytes, (std::int64_t)first.size() - offset);
+            if (std::memcmp(first.data() + offset, second.data() + offset, bytes) != 0) differs = true;
+        }
+
+        return !differs;
+    }
+
+    void addDifference(BrickResult& result, double diff, std::int64_t count, double tolerance)
+    {
+        if (diff > tolerance) result.differingSamples += count;
+        result.maxDifference = std::max(result.maxDifference, diff);
+        result.sumSquares += diff * diff * count;
+    }
+
+    bool sameGeometry(const ZGYReader& first, const ZGYReader& second)
+    {
+        if ((first.inlineRange().first != second.inlineRange().first) || (first.inlineStep() != second.inlineStep())) return false;
+        if ((first.xlineRange().first != second.xlineRange().first) || (first.xlineStep() != second.xlineStep())) return false;
+
+        if (std::abs(first.zRange().first - second.zRange().first) > 1e-6) return false;
+        if (std::abs(first.zStep() - second.zStep()) > 1e-6) return false;
+
+        const int il0 = first.inlineRange().first;
+        const int xl0 = first.xlineRange().first;
+        const int il1 = il0 + (first.inlineSize() - 1) * first.inlineStep();
+        const int xl1 = xl0 + (first.xlineSize() - 1) * first.xlineStep();
+
+        for (auto [il, xl] : { std::make_pair(il0, xl0), std::make_pair(il1, xl0), std::make_pair(il0, xl1) })
+        {
+            const auto a = first.toWorldCoordinate(il, xl);
+            const auto b = second.toWorldCoordinate(il, xl);
+            if ((std::abs(a.first - b.first) > 1e-3) || (std::abs(a.second - b.second) > 1e-3)) return false;
+        }
+
+        return true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+VolumeComparator::VolumeComparator()
+    : m_tolerance(0.0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+VolumeComparator::~VolumeComparator()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Samples differing by more than the tolerance are counted as different. Default is exact match.
+//--------------------------------------------------------------------------------------------------
+void VolumeComparator::setTolerance(double tolerance)
+{
+    m_tolerance = std::max(0.0, tolerance);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Compare the full resolution samples of two volumes of the same size, brick by brick in parallel.
+/// Files with identical bytes are settled from the raw bytes alone, and bricks stored as constants
+/// in both files are compared without decoding any data.
+//--------------------------------------------------------------------------------------------------
+VolumeComparison VolumeComparator::compare(const ZGYReader& first, const ZGYReader& second) const
+{
+    VolumeComparison retval;
+
+    const auto size = first.sizeAtLod(0);
+    if ((size[0] <= 0) || (size[1] <= 0) || (size[2] <= 0) || (size != second.sizeAtLod(0))) return retval;
+
+    retval.sameSize = true;
+    retval.sameGeometry = sameGeometry(first, second);
+
+    const auto bricksize = first.brickSize();
+    std::array<int, 3> brickCount;
+    for (int d = 0; d < 3; d++)
+    {
+        brickCount[d] = (size[d] + bricksize[d] - 1) / bricksize[d];
+    }
+    const int nBricks = brickCount[0] * brickCount[1] * brickCount[2];
+
+    retval.comparedSamples = (std::int64_t)size[0] * size[1] * size[2];
+
+    if (identicalFiles(first.filename(), second.filename()))
+    {
+        retval.identicalFiles = true;
+        return retval;
+    }
+
+    std::vector<BrickResult> results(nBricks);
+    std::atomic<bool> readFailed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < nBricks; b++)
+    {
+        const int bk = b % brickCount[2];
+        const int bj = (b / brickCount[2]) % brickCount[1];
+        const int bi = b / brickCount[2] / brickCount[1];
+
+        const std::array<int, 3> start = { bi * bricksize[0], bj * bricksize[1], bk * bricksize[2] };
+        std::array<int, 3> count;
+        for (int d = 0; d < 3; d++)
+        {
+            count[d] = std::min(bricksize[d], size[d] - start[d]);
+        }
+        const std::int64_t nSamples = (std::int64_t)count[0] * count[1] * count[2];
+
+        auto& result = results[b];
+
+        float constFirst = 0.0f;
+        float constSecond = 0.0f;
+        if (first.isConstant(0, start, count, constFirst) && second.isConstant(0, start, count, constSecond))
+        {
+            result.isConstant = true;
+            addDifference(result, sampleDifference(constFirst, constSecond), nSamples, m_tolerance);
+            continue;
+        }
+
+        std::vector<float> samplesFirst(nSamples);
+        std::vector<float> samplesSecond(nSamples);
+        if (!first.readVolume(0, start, count, samplesFirst.data()) || !second.readVolume(0, start, count, samplesSecond.data()))
+        {
+            readFailed = true;
+            continue;
+        }
+
+        for (std::int64_t n = 0; n < nSamples; n++)
+        {
+            addDifference(result, sampleDifference(samplesFirst[n], samplesSecond[n]), 1, m_tolerance);
+        }
+    }
+
+    if (readFailed)
+    {
+        retval.readFailed = true;
+        return retval;
+    }
+
+    double sumSquares = 0.0;
+    for (int b = 0; b < nBricks; b++)
+    {
+        const auto& result = results[b];
+
+        if (result.isConstant)
+            retval.constantBricks++;
+        else
+            retval.decodedBricks++;
+
+        retval.differingSamples += result.differingSamples;
+        retval.maxDifference = std::max(retval.maxDifference, result.maxDifference);
+        sumSquares += result.sumSquares;
+
+        if (result.differingSamples > 0)
+        {
+            const int bk = b % brickCount[2];
+            const int bj = (b / brickCount[2]) % brickCount[1];
+            const int bi = b / brickCount[2] / brickCount[1];
+
+            BrickDifference region;
+            region.start = { bi * bricksize[0], bj * bricksize[1], bk * bricksize[2] };
+            for (int d = 0; d < 3; d++)
+            {
+                region.size[d] = std::min(bricksize[d], size[d] - region.start[d]);
+            }
+            region.differingSamples = result.differingSamples;
+            region.maxDifference = result.maxDifference;
+            retval.regions.push_back(region);
+        }
+    }
+
+    retval.rmsDifference = std::sqrt(sumSquares / retval.comparedSamples);
+
+    return retval;
+}
+
+}
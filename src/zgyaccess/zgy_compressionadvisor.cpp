@@ -0,0 +1,307 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_compressionadvisor.h"
+#include "zgyaccess/zgy_statistics.h"
+#include "zgyaccess/zgyreader.h"
+
+#include "zfp.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    class SampledBrick
+    {
+    public:
+        std::array<int, 3> size{ 0, 0, 0 };
+        std::vector<float> samples;
+        bool isConstant = false;
+    };
+
+    class TrialResult
+    {
+    public:
+        size_t compressedBytes = 0;
+        double sumSquaredError = 0.0;
+        double decodeSeconds = 0.0;
+    };
+
+    // compress and decompress one brick with zfp, the codec behind compressed ZGY files
+    bool runTrial(SampledBrick& brick, bool fixedRate, double target, double tolerance, std::vector<unsigned char>& encoded, std::vector<float>& decoded, TrialResult& result)
+    {
+        // samples are stored with z fastest, which is x in zfp terms
+        zfp_field* field = zfp_field_3d(brick.samples.data(), zfp_type_float, brick.size[2], brick.size[1], brick.size[0]);
+        zfp_stream* zfp = zfp_stream_open(nullptr);
+
+        if (fixedRate)
+            zfp_stream_set_rate(zfp, target, zfp_type_float, 3, 0);
+        else
+            zfp_stream_set_accuracy(zfp, tolerance);
+
+        encoded.resize(zfp_stream_maximum_size(zfp, field));
+        bitstream* stream = stream_open(encoded.data(), encoded.size());
+        zfp_stream_set_bit_stream(zfp, stream);
+
+        zfp_stream_rewind(zfp);
+        result.compressedBytes = zfp_compress(zfp, field);
+
+        decoded.resize(brick.samples.size());
+        zfp_field_set_pointer(field, decoded.data());
+
+        zfp_stream_rewind(zfp);
+        const auto started = std::chrono::steady_clock::now();
+        const bool decodedOk = (result.compressedBytes != 0) && (zfp_decompress(zfp, field) != 0);
+        result.decodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        zfp_field_free(field);
+        zfp_stream_close(zfp);
+        stream_close(stream);
+
+        if (!decodedOk) return false;
+
+        double sumSquaredError = 0.0;
+        for (size_t n = 0; n < decoded.size(); n++)
+        {
+            const double diff = (double)decoded[n] - brick.samples[n];
+            sumSquaredError += diff * diff;
+        }
+        result.sumSquaredError = sumSquaredError;
+
+        return true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CompressionAdvisor::CompressionAdvisor()
+    : m_sampleBrickCount(64)
+    , m_seed(1)
+    , m_sampledBricks(0)
+    , m_constantBricks(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+CompressionAdvisor::~CompressionAdvisor()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Number of full resolution bricks to trial compress. Each one holds up to 1 MB of float samples.
+//--------------------------------------------------------------------------------------------------
+void CompressionAdvisor::setSampleBrickCount(int count)
+{
+    m_sampleBrickCount = std::max(1, count);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void CompressionAdvisor::setSeed(unsigned int seed)
+{
+    m_seed = seed;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int CompressionAdvisor::sampledBrickCount() const
+{
+    return m_sampledBricks;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int CompressionAdvisor::constantBrickCount() const
+{
+    return m_constantBricks;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Estimates for fixed accuracy ZFP compression, where zfp keeps every sample within the tolerance.
+/// Each tolerance is given as a fraction of the RMS amplitude of the sampled bricks.
+//--------------------------------------------------------------------------------------------------
+std::vector<CompressionEstimate> CompressionAdvisor::estimateAccuracy(const ZGYReader& reader, const std::vector<double>& relativeTolerances)
+{
+    return estimate(reader, relativeTolerances, false);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Estimates for fixed rate ZFP compression at the given number of bits per sample.
+//--------------------------------------------------------------------------------------------------
+std::vector<CompressionEstimate> CompressionAdvisor::estimateBitRate(const ZGYReader& reader, const std::vector<double>& bitsPerSample)
+{
+    return estimate(reader, bitsPerSample, true);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::vector<CompressionEstimate> CompressionAdvisor::estimate(const ZGYReader& reader, const std::vector<double>& targets, bool fixedRate)
+{
+    m_sampledBricks = 0;
+    m_constantBricks = 0;
+
+    const auto size = reader.sizeAtLod(0);
+    const auto bricksize = reader.brickSize();
+    if ((size[0] <= 0) || (size[1] <= 0) || (size[2] <= 0) || targets.empty()) return {};
+
+    std::array<int, 3> brickCount;
+    for (int d = 0; d < 3; d++)
+    {
+        brickCount[d] = (size[d] + bricksize[d] - 1) / bricksize[d];
+    }
+    const std::int64_t totalBricks = (std::int64_t)brickCount[0] * brickCount[1] * brickCount[2];
+
+    // jittered stratified sampling over the linear brick index, so the whole survey is covered
+    const int nSampled = (int)std::min<std::int64_t>(m_sampleBrickCount, totalBricks);
+    std::vector<std::int64_t> brickIndex(nSampled);
+    std::mt19937 random(m_seed);
+    for (int n = 0; n < nSampled; n++)
+    {
+        const std::int64_t first = totalBricks * n / nSampled;
+        const std::int64_t last = totalBricks * (n + 1) / nSampled;
+        brickIndex[n] = std::uniform_int_distribution<std::int64_t>(first, last - 1)(random);
+    }
+
+    std::vector<SampledBrick> bricks(nSampled);
+    std::vector<SampleStatistics> stats(nSampled);
+    std::atomic<bool> readFailed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int n = 0; n < nSampled; n++)
+    {
+        const std::int64_t index = brickIndex[n];
+        const int bk = (int)(index % brickCount[2]);
+        const int bj = (int)((index / brickCount[2]) % brickCount[1]);
+        const int bi = (int)(index / brickCount[2] / brickCount[1]);
+
+        const std::array<int, 3> start = { bi * bricksize[0], bj * bricksize[1], bk * bricksize[2] };
+        auto& brick = bricks[n];
+        for (int d = 0; d < 3; d++)
+        {
+            brick.size[d] = std::min(bricksize[d], size[d] - start[d]);
+        }
+        brick.samples.resize((size_t)brick.size[0] * brick.size[1] * brick.size[2]);
+
+        float constValue = 0.0f;
+        if (reader.isConstant(0, start, brick.size, constValue))
+        {
+            brick.isConstant = true;
+            std::fill(brick.samples.begin(), brick.samples.end(), constValue);
+        }
+        else if (!reader.readVolume(0, start, brick.size, brick.samples.data()))
+        {
+            readFailed = true;
+            continue;
+        }
+
+        stats[n].add(brick.samples.data(), brick.samples.size());
+    }
+
+    if (readFailed) return {};
+
+    SampleStatistics total;
+    for (const auto& s : stats)
+    {
+        total.merge(s);
+    }
+
+    const double signalRms = total.rms();
+    const double totalBytes = (double)total.count * sizeof(float);
+
+    // results per brick and target, merged serially below
+    const int nTargets = (int)targets.size();
+    std::vector<TrialResult> results((size_t)nSampled * nTargets);
+    std::atomic<bool> trialFailed(false);
+
+    const int nTrials = nSampled * nTargets;
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < nTrials; t++)
+    {
+        auto& brick = bricks[t / nTargets];
+        if (brick.isConstant) continue;
+
+        const double target = targets[t % nTargets];
+
+        // zfp bounds the maximum error of each sample by the tolerance
+        const double tolerance = std::max(target * signalRms, (double)std::numeric_limits<float>::min());
+
+        std::vector<unsigned char> encoded;
+        std::vector<float> decoded;
+        if (!runTrial(brick, fixedRate, target, tolerance, encoded, decoded, results[t])) trialFailed = true;
+    }
+
+    if (trialFailed) return {};
+
+    m_sampledBricks = nSampled;
+    for (const auto& brick : bricks)
+    {
+        if (brick.isConstant) m_constantBricks++;
+    }
+
+    std::vector<CompressionEstimate> estimates(nTargets);
+    for (int target = 0; target < nTargets; target++)
+    {
+        size_t compressedBytes = 0;
+        double sumSquaredError = 0.0;
+        double decodeSeconds = 0.0;
+        double decodedBytes = 0.0;
+
+        for (int n = 0; n < nSampled; n++)
+        {
+            if (bricks[n].isConstant) continue;
+
+            const auto& result = results[(size_t)n * nTargets + target];
+            compressedBytes += result.compressedBytes;
+            sumSquaredError += result.sumSquaredError;
+            decodeSeconds += result.decodeSeconds;
+            decodedBytes += (double)bricks[n].samples.size() * sizeof(float);
+        }
+
+        auto& estimate = estimates[target];
+        estimate.target = targets[target];
+        estimate.compressionRatio = totalBytes / std::max<double>((double)compressedBytes, 1.0);
+        estimate.rmsError = std::sqrt(sumSquaredError / total.count);
+        estimate.snr = (estimate.rmsError > 0.0) ? 20.0 * std::log10(signalRms / estimate.rmsError) : std::numeric_limits<double>::infinity();
+        estimate.decodeSpeed = (decodeSeconds > 0.0) ? decodedBytes / decodeSeconds / (1024.0 * 1024.0) : 0.0;
+    }
+
+    return estimates;
+}
+
+}
@@ -0,0 +1,377 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_contour.h"
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/seismicslice.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    // Part of a contour, with the grid edge each end point lies on. Points are in index coordinates.
+    class Chain
+    {
+    public:
+        std::vector<std::uint64_t> keys;
+        std::vector<std::array<double, 2>> points;
+        bool closed = false;
+    };
+
+    // Join chains that end on the same grid edge. Each edge is crossed at most once per level, so an
+    // edge is shared by at most two chain ends.
+    std::vector<Chain> linkChains(std::vector<Chain>& chains)
+    {
+        std::unordered_map<std::uint64_t, std::vector<size_t>> ends;
+        for (size_t c = 0; c < chains.size(); c++)
+        {
+            if (chains[c].closed) continue;
+
+            ends[chains[c].keys.front()].push_back(c);
+            ends[chains[c].keys.back()].push_back(c);
+        }
+
+        std::vector<bool> used(chains.size(), false);
+        std::vector<Chain> retval;
+
+        auto partner = [&](std::uint64_t key, size_t self) -> size_t {
+            for (size_t other : ends[key])
+            {
+                if ((other != self) && !used[other]) return other;
+            }
+            return chains.size();
+        };
+
+        for (size_t c = 0; c < chains.size(); c++)
+        {
+            if (used[c]) continue;
+            used[c] = true;
+
+            Chain current = std::move(chains[c]);
+            if (current.closed)
+            {
+                retval.push_back(std::move(current));
+                continue;
+            }
+
+            // extend at the back, then reverse and extend at what was the front
+            for (int side = 0; side < 2; side++)
+            {
+                while (!current.closed)
+                {
+                    const size_t other = partner(current.keys.back(), c);
+                    if (other == chains.size()) break;
+                    used[other] = true;
+
+                    Chain& next = chains[other];
+                    if (next.keys.front() != current.keys.back())
+                    {
+                        std::reverse(next.keys.begin(), next.keys.end());
+                        std::reverse(next.points.begin(), next.points.end());
+                    }
+
+                    current.keys.insert(current.keys.end(), next.keys.begin() + 1, next.keys.end());
+                    current.points.insert(current.points.end(), next.points.begin() + 1, next.points.end());
+
+                    if (current.keys.back() == current.keys.front())
+                    {
+                        current.keys.pop_back();
+                        current.points.pop_back();
+                        current.closed = true;
+                    }
+                }
+
+                if (current.closed) break;
+
+                std::reverse(current.keys.begin(), current.keys.end());
+                std::reverse(current.points.begin(), current.points.end());
+            }
+
+            retval.push_back(std::move(current));
+        }
+
+        return retval;
+    }
+
+    double segmentDistance(const Point2d& p, const Point2d& a, const Point2d& b)
+    {
+        const double dx = b.x() - a.x();
+        const double dy = b.y() - a.y();
+        const double length2 = dx * dx + dy * dy;
+
+        double t = (length2 > 0.0) ? ((p.x() - a.x()) * dx + (p.y() - a.y()) * dy) / length2 : 0.0;
+        t = std::clamp(t, 0.0, 1.0);
+
+        return std::hypot(p.x() - (a.x() + t * dx), p.y() - (a.y() + t * dy));
+    }
+
+    // Douglas-Peucker, keeping the first and last point
+    void simplify(const std::vector<Point2d>& points, size_t first, size_t last, double tolerance, std::vector<bool>& keep)
+    {
+        if (last <= first + 1) return;
+
+        double maxDistance = 0.0;
+        size_t farthest = first;
+        for (size_t p = first + 1; p < last; p++)
+        {
+            const double d = segmentDistance(points[p], points[first], points[last]);
+            if (d > maxDistance)
+            {
+                maxDistance = d;
+                farthest = p;
+            }
+        }
+
+        if (maxDistance <= tolerance) return;
+
+        keep[farthest] = true;
+        simplify(points, first, farthest, tolerance, keep);
+        simplify(points, farthest, last, tolerance, keep);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ContourGenerator::ContourGenerator(std::vector<double> levels)
+    : m_levels(levels)
+    , m_tileSize(128)
+    , m_tolerance(0.0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ContourGenerator::~ContourGenerator()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Grid cells per tile side. Tiles and levels are traced in parallel and stitched afterwards.
+//--------------------------------------------------------------------------------------------------
+void ContourGenerator::setTileSize(int cells)
+{
+    m_tileSize = std::max(1, cells);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Maximum distance, in output coordinates, between a simplified line and the points it replaces.
+/// Zero turns simplification off.
+//--------------------------------------------------------------------------------------------------
+void ContourGenerator::setSimplifyTolerance(double tolerance)
+{
+    m_tolerance = std::max(0.0, tolerance);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::vector<ContourLine> ContourGenerator::contours(std::shared_ptr<SeismicSliceData> grid) const
+{
+    const double identity[6] = { 0.0, 0.0, 1.0, 0.0, 0.0, 1.0 };
+
+    return trace(grid, identity);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::vector<ContourLine> ContourGenerator::contours(const ZGYReader& reader, std::shared_ptr<SeismicSliceData> grid) const
+{
+    if ((grid == nullptr) || (grid->width() != reader.inlineSize()) || (grid->depth() != reader.xlineSize())) return {};
+
+    // the world coordinates are affine in the annotation, so three lookups give the whole grid
+    const int il0 = reader.inlineRange().first;
+    const int xl0 = reader.xlineRange().first;
+
+    const auto origin = reader.toWorldCoordinate(il0, xl0);
+    const auto alongInline = reader.toWorldCoordinate(il0 + reader.inlineStep(), xl0);
+    const auto alongXline = reader.toWorldCoordinate(il0, xl0 + reader.xlineStep());
+
+    const double transform[6] = { origin.first, origin.second,
+                                  alongInline.first - origin.first, alongInline.second - origin.second,
+                                  alongXline.first - origin.first, alongXline.second - origin.second };
+
+    return trace(grid, transform);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Marching squares per tile and level, with the saddle cases resolved by the cell centre value.
+/// Segments are linked into chains within each tile, and the chains of all tiles are stitched on
+/// the grid edges they end on. The transform maps index coordinates to output coordinates as
+/// origin (0, 1), inline direction (2, 3) and crossline direction (4, 5).
+//--------------------------------------------------------------------------------------------------
+std::vector<ContourLine> ContourGenerator::trace(std::shared_ptr<SeismicSliceData> grid, const double transform[6]) const
+{
+    std::vector<ContourLine> retLines;
+    if ((grid == nullptr) || grid->isEmpty() || m_levels.empty()) return retLines;
+
+    const int width = grid->width();
+    const int depth = grid->depth();
+    const float* values = grid->values();
+
+    const int cellsI = width - 1;
+    const int cellsJ = depth - 1;
+    if ((cellsI <= 0) || (cellsJ <= 0)) return retLines;
+
+    const int tilesI = (cellsI + m_tileSize - 1) / m_tileSize;
+    const int tilesJ = (cellsJ + m_tileSize - 1) / m_tileSize;
+    const int nTiles = tilesI * tilesJ;
+    const int nLevels = (int)m_levels.size();
+    const int nTasks = nTiles * nLevels;
+
+    std::vector<std::vector<Chain>> taskChains(nTasks);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int task = 0; task < nTasks; task++)
+    {
+        const double level = m_levels[task / nTiles];
+        const int tile = task % nTiles;
+        const int ci0 = (tile / tilesJ) * m_tileSize;
+        const int cj0 = (tile % tilesJ) * m_tileSize;
+        const int ci1 = std::min(cellsI, ci0 + m_tileSize);
+        const int cj1 = std::min(cellsJ, cj0 + m_tileSize);
+
+        auto value = [&](int i, int j) { return (double)values[(size_t)i * depth + j]; };
+
+        // edges along the inline direction start at (i, j), edges along the crossline direction too
+        auto edgeI = [&](int i, int j) { return ((std::uint64_t)i * depth + j) * 2; };
+        auto edgeJ = [&](int i, int j) { return ((std::uint64_t)i * depth + j) * 2 + 1; };
+
+        auto crossing = [&](int i, int j, bool alongI) {
+            const double a = value(i, j);
+            const double b = alongI ? value(i + 1, j) : value(i, j + 1);
+            const double t = (b != a) ? (level - a) / (b - a) : 0.5;
+            return alongI ? std::array<double, 2>{ i + t, (double)j } : std::array<double, 2>{ (double)i, j + t };
+        };
+
+        std::vector<Chain> segments;
+
+        for (int i = ci0; i < ci1; i++)
+        {
+            for (int j = cj0; j < cj1; j++)
+            {
+                const double v0 = value(i, j);
+                const double v1 = value(i + 1, j);
+                const double v2 = value(i + 1, j + 1);
+                const double v3 = value(i, j + 1);
+                if (std::isnan(v0) || std::isnan(v1) || std::isnan(v2) || std::isnan(v3)) continue;
+
+                const int cell = (v0 >= level ? 1 : 0) | (v1 >= level ? 2 : 0) | (v2 >= level ? 4 : 0) | (v3 >= level ? 8 : 0);
+                if ((cell == 0) || (cell == 15)) continue;
+
+                // cell edges: 0 low crossline, 1 high inline, 2 high crossline, 3 low inline
+                const std::uint64_t keys[4] = { edgeI(i, j), edgeJ(i + 1, j), edgeI(i, j + 1), edgeJ(i, j) };
+                auto point = [&](int edge) {
+                    switch (edge)
+                    {
+                    case 0: return crossing(i, j, true);
+                    case 1: return crossing(i + 1, j, false);
+                    case 2: return crossing(i, j + 1, true);
+                    default: return crossing(i, j, false);
+                    }
+                };
+                auto addSegment = [&](int a, int b) {
+                    Chain segment;
+                    segment.keys = { keys[a], keys[b] };
+                    segment.points = { point(a), point(b) };
+                    segments.push_back(std::move(segment));
+                };
+
+                const bool centreAbove = (v0 + v1 + v2 + v3) / 4.0 >= level;
+
+                switch (cell)
+                {
+                case 1: case 14: addSegment(3, 0); break;
+                case 2: case 13: addSegment(0, 1); break;
+                case 3: case 12: addSegment(3, 1); break;
+                case 4: case 11: addSegment(1, 2); break;
+                case 6: case 9:  addSegment(0, 2); break;
+                case 7: case 8:  addSegment(3, 2); break;
+                case 5:
+                    if (centreAbove) { addSegment(0, 1); addSegment(2, 3); }
+                    else { addSegment(3, 0); addSegment(1, 2); }
+                    break;
+                case 10:
+                    if (centreAbove) { addSegment(3, 0); addSegment(1, 2); }
+                    else { addSegment(0, 1); addSegment(2, 3); }
+                    break;
+                }
+            }
+        }
+
+        taskChains[task] = linkChains(segments);
+    }
+
+    for (int l = 0; l < nLevels; l++)
+    {
+        std::vector<Chain> chains;
+        for (int tile = 0; tile < nTiles; tile++)
+        {
+            auto& tileChains = taskChains[l * nTiles + tile];
+            std::move(tileChains.begin(), tileChains.end(), std::back_inserter(chains));
+        }
+
+        for (auto& chain : linkChains(chains))
+        {
+            ContourLine line(m_levels[l]);
+            line.closed = chain.closed;
+
+            for (auto& [i, j] : chain.points)
+            {
+                line.points.emplace_back(transform[0] + transform[2] * i + transform[4] * j, transform[1] + transform[3] * i + transform[5] * j);
+            }
+
+            if ((m_tolerance > 0.0) && (line.points.size() > 2))
+            {
+                // closed lines are simplified as an open line returning to its first point
+                if (line.closed) line.points.push_back(line.points.front());
+
+                std::vector<bool> keep(line.points.size(), false);
+                keep.front() = true;
+                keep.back() = true;
+                simplify(line.points, 0, line.points.size() - 1, m_tolerance, keep);
+
+                std::vector<Point2d> kept;
+                for (size_t p = 0; p < line.points.size(); p++)
+                {
+                    if (keep[p]) kept.push_back(line.points[p]);
+                }
+                if (line.closed) kept.pop_back();
+
+                line.points = kept;
+            }
+
+            retLines.push_back(std::move(line));
+        }
+    }
+
+    return retLines;
+}
+
+}
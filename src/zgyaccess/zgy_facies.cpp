@@ -0,0 +1,626 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_facies.h"
+#include "zgyaccess/zgy_multivolume.h"
+#include "zgyaccess/zgy_outlinemask.h"
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/seismicslice.h"
+
+#include "zgy_slabwriter.h"
+
+#include "exception.h"
+#include "api.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    // samples classified together, channel major, so that the distance loops run over contiguous memory
+    const int blockSize = 256;
+
+    // samples drawn from the first batch to seed the centroids
+    const int initSampleCount = 10000;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// At most 127 classes, so that labels fit in an int8 volume.
+//--------------------------------------------------------------------------------------------------
+FaciesClassifier::FaciesClassifier(int nClasses)
+    : m_classCount(std::clamp(nClasses, 1, 127))
+    , m_channelCount(0)
+    , m_seed(1)
+    , m_iterations(50)
+    , m_batchColumns(8)
+    , m_memoryBudget(std::int64_t(1) << 30)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+FaciesClassifier::~FaciesClassifier()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void FaciesClassifier::setSeed(unsigned int seed)
+{
+    m_seed = seed;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Number of mini-batch updates of the centroids.
+//--------------------------------------------------------------------------------------------------
+void FaciesClassifier::setIterations(int iterations)
+{
+    m_iterations = std::max(1, iterations);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Brick columns read per mini-batch. Columns are drawn in random order, and the whole region is
+/// visited before any column is used again.
+//--------------------------------------------------------------------------------------------------
+void FaciesClassifier::setBatchColumns(int columns)
+{
+    m_batchColumns = std::max(1, columns);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Memory used for the slabs of samples when writing a class volume.
+//--------------------------------------------------------------------------------------------------
+void FaciesClassifier::setMemoryBudget(std::int64_t bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int FaciesClassifier::classCount() const
+{
+    return m_classCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int FaciesClassifier::channelCount() const
+{
+    return m_channelCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Centre of a class in the units of each volume.
+//--------------------------------------------------------------------------------------------------
+std::vector<float> FaciesClassifier::centroid(int classIndex) const
+{
+    std::vector<float> retval;
+    if ((classIndex < 0) || (classIndex >= m_classCount) || m_centroids.empty()) return retval;
+
+    for (int c = 0; c < m_channelCount; c++)
+    {
+        const float scale = m_scales[c];
+        retval.push_back(m_offsets[c] + ((scale > 0.0f) ? m_centroids[classIndex * m_channelCount + c] / scale : 0.0f));
+    }
+
+    return retval;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string FaciesClassifier::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool FaciesClassifier::setScaling(const MultiVolumeReader& volumes)
+{
+    if (!volumes.isCompatible())
+    {
+        m_errorMessage = "Volumes must be open and have the same size";
+        return false;
+    }
+
+    m_channelCount = volumes.volumeCount();
+    m_offsets.clear();
+    m_scales.clear();
+
+    for (int v = 0; v < m_channelCount; v++)
+    {
+        const auto [minVal, maxVal] = volumes.volume(v)->dataRange();
+        m_offsets.push_back((float)minVal);
+        m_scales.push_back((maxVal > minVal) ? (float)(1.0 / (maxVal - minVal)) : 0.0f);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Label of each of the interleaved samples, nearest centroid after scaling.
+//--------------------------------------------------------------------------------------------------
+void FaciesClassifier::classify(const float* values, size_t nSamples, int* labels) const
+{
+    const int nChannels = m_channelCount;
+    if (m_centroids.empty())
+    {
+        std::fill(labels, labels + nSamples, -1);
+        return;
+    }
+
+    std::vector<float> scaled((size_t)nChannels * blockSize);
+    std::vector<float> distance(blockSize);
+    std::vector<float> best(blockSize);
+    std::vector<int> bestClass(blockSize);
+    std::vector<char> valid(blockSize);
+
+    for (size_t s0 = 0; s0 < nSamples; s0 += blockSize)
+    {
+        const int n = (int)std::min<size_t>(blockSize, nSamples - s0);
+
+        for (int s = 0; s < n; s++)
+        {
+            valid[s] = 1;
+            for (int c = 0; c < nChannels; c++)
+            {
+                const float value = values[(s0 + s) * nChannels + c];
+                if (!std::isfinite(value)) valid[s] = 0;
+
+                scaled[(size_t)c * blockSize + s] = (value - m_offsets[c]) * m_scales[c];
+            }
+        }
+
+        std::fill(best.begin(), best.begin() + n, std::numeric_limits<float>::max());
+
+        for (int k = 0; k < m_classCount; k++)
+        {
+            std::fill(distance.begin(), distance.begin() + n, 0.0f);
+
+            for (int c = 0; c < nChannels; c++)
+            {
+                const float centre = m_centroids[k * nChannels + c];
+                const float* channel = &scaled[(size_t)c * blockSize];
+                for (int s = 0; s < n; s++)
+                {
+                    const float d = channel[s] - centre;
+                    distance[s] += d * d;
+                }
+            }
+
+            for (int s = 0; s < n; s++)
+            {
+                if (distance[s] < best[s])
+                {
+                    best[s] = distance[s];
+                    bestClass[s] = k;
+                }
+            }
+        }
+
+        for (int s = 0; s < n; s++)
+        {
+            labels[s0 + s] = valid[s] ? bestClass[s] : -1;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// k-means++ seeding from scaled samples.
+//--------------------------------------------------------------------------------------------------
+void FaciesClassifier::initialize(const std::vector<float>& samples)
+{
+    const int nChannels = m_channelCount;
+    const size_t nSamples = samples.size() / nChannels;
+
+    m_centroids.assign((size_t)m_classCount * nChannels, 0.0f);
+    m_counts.assign(m_classCount, 0.0);
+
+    if (nSamples == 0) return;
+
+    std::mt19937 random(m_seed);
+    std::vector<double> nearest(nSamples, std::numeric_limits<double>::max());
+
+    size_t chosen = std::uniform_int_distribution<size_t>(0, nSamples - 1)(random);
+    for (int k = 0; k < m_classCount; k++)
+    {
+        std::copy(&samples[chosen * nChannels], &samples[chosen * nChannels] + nChannels, &m_centroids[(size_t)k * nChannels]);
+
+        double total = 0.0;
+        for (size_t s = 0; s < nSamples; s++)
+        {
+            double d = 0.0;
+            for (int c = 0; c < nChannels; c++)
+            {
+                const double diff = samples[s * nChannels + c] - m_centroids[(size_t)k * nChannels + c];
+                d += diff * diff;
+            }
+            nearest[s] = std::min(nearest[s], d);
+            total += nearest[s];
+        }
+
+        // all samples already coincide with a centroid, keep the remaining classes on the last one
+        if (total <= 0.0) continue;
+
+        double target = std::uniform_real_distribution<double>(0.0, total)(random);
+        for (chosen = 0; chosen + 1 < nSamples; chosen++)
+        {
+            target -= nearest[chosen];
+            if (target <= 0.0) break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Fit the centroids to the samples inside the mask and z range. Memory use is bounded by the
+/// brick columns of one batch, as nothing is kept between batches except the centroids.
+//--------------------------------------------------------------------------------------------------
+bool FaciesClassifier::train(const MultiVolumeReader& volumes, const OutlineMask& mask, int zStartIndex, int zSize)
+{
+    m_errorMessage.clear();
+    m_centroids.clear();
+
+    if (!setScaling(volumes)) return false;
+
+    const auto columns = volumes.maskedBrickColumns(mask);
+    const int nColumns = (int)columns.size();
+    if (nColumns == 0)
+    {
+        m_errorMessage = "No samples inside the mask";
+        return false;
+    }
+
+    const int nChannels = m_channelCount;
+    const int nClasses = m_classCount;
+
+    std::mt19937 random(m_seed);
+    std::vector<int> order(nColumns);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), random);
+
+    int next = 0;
+    auto nextBatch = [&]() {
+        std::vector<int> batch;
+        for (int b = 0; b < std::min(m_batchColumns, nColumns); b++)
+        {
+            if (next == nColumns)
+            {
+                std::shuffle(order.begin(), order.end(), random);
+                next = 0;
+            }
+            batch.push_back(order[next++]);
+        }
+        return batch;
+    };
+
+    auto scale = [&](const float* sample, float* scaled) {
+        for (int c = 0; c < nChannels; c++)
+        {
+            scaled[c] = (sample[c] - m_offsets[c]) * m_scales[c];
+            if (!std::isfinite(scaled[c])) return false;
+        }
+        return true;
+    };
+
+    std::atomic<bool> failed(false);
+
+    // seed from a reservoir sample of the first batch, one reservoir per column
+    auto batch = nextBatch();
+    const int nBatch = (int)batch.size();
+    const size_t reservoirSize = std::max(1, initSampleCount / nBatch);
+    std::vector<std::vector<float>> reservoirs(nBatch);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < nBatch; b++)
+    {
+        if (failed) continue;
+
+        std::mt19937 columnRandom(m_seed + b);
+        auto& reservoir = reservoirs[b];
+        std::vector<float> scaled(nChannels);
+        size_t seen = 0;
+
+        auto sample = [&](const float* values, size_t nSamples) {
+            for (size_t s = 0; s < nSamples; s++)
+            {
+                if (!scale(values + s * nChannels, scaled.data())) continue;
+
+                if (seen < reservoirSize)
+                {
+                    reservoir.insert(reservoir.end(), scaled.begin(), scaled.end());
+                }
+                else
+                {
+                    const size_t slot = std::uniform_int_distribution<size_t>(0, seen)(columnRandom);
+                    if (slot < reservoirSize) std::copy(scaled.begin(), scaled.end(), reservoir.begin() + slot * nChannels);
+                }
+                seen++;
+            }
+        };
+
+        if (!volumes.readMaskedColumn(mask, columns[batch[b]], zStartIndex, zSize, sample)) failed = true;
+    }
+
+    if (failed)
+    {
+        m_errorMessage = "Failed to read volume data";
+        return false;
+    }
+
+    std::vector<float> initSamples;
+    for (auto& reservoir : reservoirs)
+    {
+        initSamples.insert(initSamples.end(), reservoir.begin(), reservoir.end());
+    }
+
+    if (initSamples.empty())
+    {
+        m_errorMessage = "No valid samples inside the mask";
+        return false;
+    }
+
+    initialize(initSamples);
+
+    // mini-batch updates, each centroid moving towards the batch mean with a rate that decreases
+    // with the number of samples it has absorbed
+    for (int iteration = 0; iteration < m_iterations; iteration++)
+    {
+        if (iteration > 0) batch = nextBatch();
+
+        std::vector<std::vector<double>> sums(batch.size(), std::vector<double>((size_t)nClasses * nChannels, 0.0));
+        std::vector<std::vector<double>> counts(batch.size(), std::vector<double>(nClasses, 0.0));
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int b = 0; b < (int)batch.size(); b++)
+        {
+            if (failed) continue;
+
+            auto& sum = sums[b];
+            auto& count = counts[b];
+            std::vector<int> labels;
+
+            auto accumulate = [&](const float* values, size_t nSamples) {
+                labels.resize(nSamples);
+                classify(values, nSamples, labels.data());
+
+                for (size_t s = 0; s < nSamples; s++)
+                {
+                    const int k = labels[s];
+                    if (k < 0) continue;
+
+                    count[k] += 1.0;
+                    for (int c = 0; c < nChannels; c++)
+                    {
+                        sum[(size_t)k * nChannels + c] += (values[s * nChannels + c] - m_offsets[c]) * m_scales[c];
+                    }
+                }
+            };
+
+            if (!volumes.readMaskedColumn(mask, columns[batch[b]], zStartIndex, zSize, accumulate)) failed = true;
+        }
+
+        if (failed)
+        {
+            m_errorMessage = "Failed to read volume data";
+            m_centroids.clear();
+            return false;
+        }
+
+        for (int k = 0; k < nClasses; k++)
+        {
+            double n = 0.0;
+            std::vector<double> sum(nChannels, 0.0);
+            for (size_t b = 0; b < batch.size(); b++)
+            {
+                n += counts[b][k];
+                for (int c = 0; c < nChannels; c++)
+                {
+                    sum[c] += sums[b][(size_t)k * nChannels + c];
+                }
+            }
+
+            if (n == 0.0) continue;
+
+            m_counts[k] += n;
+            const double rate = n / m_counts[k];
+            for (int c = 0; c < nChannels; c++)
+            {
+                float& centre = m_centroids[(size_t)k * nChannels + c];
+                centre += (float)(rate * (sum[c] / n - centre));
+            }
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> FaciesClassifier::classifySlice(std::shared_ptr<InterleavedSliceData> slice) const
+{
+    if (slice->isEmpty() || m_centroids.empty() || (slice->channels() != m_channelCount)) return std::make_shared<SeismicSliceData>(0, 0);
+
+    const size_t nSamples = (size_t)slice->width() * slice->depth();
+    std::vector<int> labels(nSamples);
+    classify(slice->values(), nSamples, labels.data());
+
+    auto retData = std::make_shared<SeismicSliceData>(slice->width(), slice->depth());
+    if (retData->isEmpty()) return retData;
+
+    std::copy(labels.begin(), labels.end(), retData->values());
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Class labels of a full inline, laid out like ZGYReader::inlineSlice().
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> FaciesClassifier::inlineSlice(const MultiVolumeReader& volumes, int inlineIndex) const
+{
+    if (!volumes.isCompatible()) return std::make_shared<SeismicSliceData>(0, 0);
+
+    return classifySlice(volumes.inlineSlice(inlineIndex, 0, volumes.volume(0)->zSize()));
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Class labels of a z slice, laid out like ZGYReader::zSlice().
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> FaciesClassifier::zSlice(const MultiVolumeReader& volumes, int zIndex) const
+{
+    return classifySlice(volumes.zSlice(zIndex));
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write the class label of every sample to an int8 ZGY file with the geometry of the first volume,
+/// one slab of bricks at a time. Slabs are classified in parallel while the previous one is written.
+//--------------------------------------------------------------------------------------------------
+bool FaciesClassifier::writeClassVolume(const MultiVolumeReader& volumes, std::string zgyFilename)
+{
+    m_errorMessage.clear();
+
+    if (m_centroids.empty() || !volumes.isCompatible() || (volumes.volumeCount() != m_channelCount))
+    {
+        m_errorMessage = "The classifier must be trained on the same volumes";
+        return false;
+    }
+
+    auto reader = volumes.volume(0);
+    const auto size = reader->sizeAtLod(0);
+    const auto bricksize = reader->brickSize();
+    const int ni = size[0];
+    const int nj = size[1];
+    const int nk = size[2];
+
+    const int il0 = reader->inlineRange().first;
+    const int xl0 = reader->xlineRange().first;
+    const int ilStep = reader->inlineStep();
+    const int xlStep = reader->xlineStep();
+
+    auto corner = [&](int i, int j) {
+        const auto [x, y] = reader->toWorldCoordinate(il0 + i * ilStep, xl0 + j * xlStep);
+        return std::array<double, 2>{ x, y };
+    };
+
+    // only the unit names are exposed by the reader
+    std::string zUnit;
+    std::string hUnit;
+    for (auto& [key, value] : reader->metaData())
+    {
+        if (key == "Depth unit") zUnit = value;
+        if (key == "Horizontal unit") hUnit = value;
+    }
+
+    const bool timeUnit = (zUnit == "ms") || (zUnit == "s");
+
+    OpenZGY::ZgyWriterArgs args;
+    args.filename(zgyFilename)
+        .size(ni, nj, nk)
+        .bricksize(bricksize[0], bricksize[1], bricksize[2])
+        .datatype(OpenZGY::SampleDataType::int8)
+        .datarange(-128.0f, 127.0f)
+        .ilstart((float)il0)
+        .ilinc((float)ilStep)
+        .xlstart((float)xl0)
+        .xlinc((float)xlStep)
+        .zstart((float)reader->zRange().first)
+        .zinc((float)reader->zStep())
+        .zunit(timeUnit ? OpenZGY::UnitDimension::time : OpenZGY::UnitDimension::length, zUnit, (zUnit == "ms") ? 1000.0 : 1.0)
+        .hunit(OpenZGY::UnitDimension::length, hUnit, 1.0)
+        .corners({ corner(0, 0), corner(ni - 1, 0), corner(0, nj - 1), corner(ni - 1, nj - 1) });
+
+    // the interleaved input of a slab is scratch memory on top of the slab buffers
+    SlabWriter slabWriter({ ni, nj, nk }, bricksize, m_memoryBudget, (std::int64_t)m_channelCount * sizeof(float));
+    if (!slabWriter.isValid())
+    {
+        m_errorMessage = "Memory budget exceeded";
+        return false;
+    }
+
+    std::vector<float> samples;
+    std::shared_ptr<OpenZGY::IZgyWriter> writer;
+
+    try
+    {
+        writer = OpenZGY::IZgyWriter::open(args);
+
+        slabWriter.write(writer, [&](std::array<int, 3> start, std::array<int, 3> size, float* buffer) {
+            samples.resize((size_t)size[0] * size[1] * nk * m_channelCount);
+            if (!volumes.readInterleaved(start, size, samples.data())) throw std::runtime_error("Failed to read volume data");
+
+            const int nSlabTraces = size[0] * size[1];
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int n = 0; n < nSlabTraces; n++)
+            {
+                std::vector<int> labels(nk);
+                classify(samples.data() + (size_t)n * nk * m_channelCount, nk, labels.data());
+                std::copy(labels.begin(), labels.end(), buffer + (size_t)n * nk);
+            }
+        });
+
+        writer->finalize();
+        writer->close();
+    }
+    catch (const std::exception& err)
+    {
+        m_errorMessage = err.what();
+
+        // a partially written file is not left behind for someone to mistake for a complete volume
+        if (writer != nullptr)
+        {
+            try
+            {
+                writer->close();
+            }
+            catch (const std::exception&)
+            {
+            }
+            writer.reset();
+        }
+
+        std::error_code ec;
+        std::filesystem::remove(zgyFilename, ec);
+
+        return false;
+    }
+
+    return true;
+}
+
+}
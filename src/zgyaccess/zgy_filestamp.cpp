@@ -0,0 +1,40 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgy_filestamp.h"
+
+#include <filesystem>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint64_t fileStamp(const std::string& filename)
+{
+    std::error_code ec;
+    const std::uint64_t fileSize = std::filesystem::file_size(filename, ec);
+    if (ec) return 0;
+
+    const std::uint64_t modified = (std::uint64_t)std::filesystem::last_write_time(filename, ec).time_since_epoch().count();
+    if (ec) return 0;
+
+    return fileSize ^ (modified * 0x9E3779B97F4A7C15ull);
+}
+
+}
@@ -0,0 +1,193 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_flatten.h"
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/seismicslice.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+HorizonFlattener::HorizonFlattener(std::shared_ptr<SeismicSliceData> horizon)
+    : m_horizon(horizon)
+    , m_fillValue(std::numeric_limits<float>::quiet_NaN())
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+HorizonFlattener::~HorizonFlattener()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Value used where the horizon is undefined or the window reaches outside the volume.
+//--------------------------------------------------------------------------------------------------
+void HorizonFlattener::setFillValue(float fillValue)
+{
+    m_fillValue = fillValue;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Inline with sample n of each trace at the horizon plus zStartOffset + n samples.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> HorizonFlattener::inlineSlice(const ZGYReader& reader, int inlineIndex, int zStartOffset, int zSize) const
+{
+    const int width = reader.xlineSize();
+
+    auto retData = std::make_shared<SeismicSliceData>(width, zSize);
+    if (retData->isEmpty()) return retData;
+    if (!readVolume(reader, { inlineIndex, 0 }, { 1, width }, zStartOffset, zSize, retData->values())) return std::make_shared<SeismicSliceData>(0, 0);
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> HorizonFlattener::xlineSlice(const ZGYReader& reader, int xlineIndex, int zStartOffset, int zSize) const
+{
+    const int width = reader.inlineSize();
+
+    auto retData = std::make_shared<SeismicSliceData>(width, zSize);
+    if (retData->isEmpty()) return retData;
+    if (!readVolume(reader, { 0, xlineIndex }, { width, 1 }, zStartOffset, zSize, retData->values())) return std::make_shared<SeismicSliceData>(0, 0);
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Flattened traces for a box of inlines and crosslines, z fastest. Every brick column is read once
+/// over the union of the windows of its traces, and each trace is then shifted by its fractional
+/// horizon position with linear interpolation.
+//--------------------------------------------------------------------------------------------------
+bool HorizonFlattener::readVolume(const ZGYReader& reader, std::array<int, 2> start, std::array<int, 2> size, int zStartOffset, int zSize, float* buffer) const
+{
+    const int widthI = reader.inlineSize();
+    const int widthX = reader.xlineSize();
+    const int nz = reader.zSize();
+
+    if ((m_horizon == nullptr) || (buffer == nullptr) || (nz == 0) || (zSize <= 0)) return false;
+    if ((m_horizon->width() != widthI) || (m_horizon->depth() != widthX)) return false;
+    if ((start[0] < 0) || (start[1] < 0) || (size[0] <= 0) || (size[1] <= 0) || (start[0] + size[0] > widthI) || (start[1] + size[1] > widthX)) return false;
+
+    const double z0 = reader.zRange().first;
+    const double dz = reader.zStep();
+    if (dz <= 0.0) return false;
+
+    const float* horizon = m_horizon->values();
+    const auto bricksize = reader.brickSize();
+
+    const int firstI = start[0] / bricksize[0];
+    const int firstX = start[1] / bricksize[1];
+    const int columnsI = (start[0] + size[0] - 1) / bricksize[0] - firstI + 1;
+    const int columnsX = (start[1] + size[1] - 1) / bricksize[1] - firstX + 1;
+    const int nColumns = columnsI * columnsX;
+
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nColumns; c++)
+    {
+        if (failed) continue;
+
+        const int i0 = std::max(start[0], (firstI + c / columnsX) * bricksize[0]);
+        const int j0 = std::max(start[1], (firstX + c % columnsX) * bricksize[1]);
+        const int ni = std::min(start[0] + size[0], (firstI + c / columnsX + 1) * bricksize[0]) - i0;
+        const int nj = std::min(start[1] + size[1], (firstX + c % columnsX + 1) * bricksize[1]) - j0;
+
+        // first sample index of every window, NaN for undefined horizon
+        std::vector<double> positions((size_t)ni * nj);
+        int kMin = nz;
+        int kMax = -1;
+
+        for (int i = 0; i < ni; i++)
+        {
+            for (int j = 0; j < nj; j++)
+            {
+                const double z = horizon[(size_t)(i0 + i) * widthX + (j0 + j)];
+                const double k = (z - z0) / dz + zStartOffset;
+                positions[(size_t)i * nj + j] = k;
+                if (std::isnan(k)) continue;
+
+                const double first = std::floor(k);
+                if ((first > nz - 1) || (first + zSize < 0)) continue;
+
+                kMin = std::min(kMin, (int)std::max(first, 0.0));
+                kMax = std::max(kMax, (int)std::min(first + zSize, nz - 1.0));
+            }
+        }
+
+        std::vector<float> samples;
+        const int nk = kMax - kMin + 1;
+        if (nk > 0)
+        {
+            samples.resize((size_t)ni * nj * nk);
+            if (!reader.readVolume(0, { i0, j0, kMin }, { ni, nj, nk }, samples.data()))
+            {
+                failed = true;
+                continue;
+            }
+        }
+
+        for (int i = 0; i < ni; i++)
+        {
+            for (int j = 0; j < nj; j++)
+            {
+                float* output = buffer + ((size_t)(i0 - start[0] + i) * size[1] + (j0 - start[1] + j)) * zSize;
+                std::fill(output, output + zSize, m_fillValue);
+
+                const double k = positions[(size_t)i * nj + j];
+                if (std::isnan(k) || (nk <= 0)) continue;
+
+                const int first = (int)std::floor(k);
+                if ((first > nz - 1) || (first + zSize < 0)) continue;
+
+                // window samples with both neighbours inside the volume are interpolated in one
+                // contiguous loop, and a sample falling exactly on the last one is copied
+                const float t = (float)(k - first);
+                const int nLo = std::max(0, -first);
+                const int nHi = std::min(zSize, nz - 1 - first);
+
+                const float* trace = &samples[((size_t)i * nj + j) * nk];
+                const int shift = first - kMin;
+                for (int n = nLo; n < nHi; n++)
+                {
+                    output[n] = trace[shift + n] + t * (trace[shift + n + 1] - trace[shift + n]);
+                }
+
+                if ((t == 0.0f) && (nHi < zSize) && (first + nHi == nz - 1)) output[nHi] = trace[shift + nHi];
+            }
+        }
+    }
+
+    return !failed;
+}
+
+}
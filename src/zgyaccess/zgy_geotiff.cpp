@@ -0,0 +1,354 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_geotiff.h"
+#include "zgyaccess/zgyreader.h"
+
+#include "zgy_tiffwriter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    const std::uint16_t tagModelPixelScale = 33550;
+    const std::uint16_t tagModelTiepoint = 33922;
+    const std::uint16_t tagGeoKeyDirectory = 34735;
+    const std::uint16_t tagGdalNoData = 42113;
+
+    const std::uint16_t keyModelType = 1024;
+    const std::uint16_t keyRasterType = 1025;
+    const std::uint16_t keyProjectedCrs = 3072;
+
+    const std::uint16_t modelTypeProjected = 1;
+    const std::uint16_t rasterPixelIsArea = 1;
+    const std::uint16_t userDefined = 32767;
+
+    // a partially written file is not left behind for someone to mistake for a complete export
+    void removeFile(const std::string& filename)
+    {
+        std::error_code ec;
+        std::filesystem::remove(filename, ec);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The grid must have a positive x spacing and a negative y spacing, with cell (0, 0) in the
+/// north west corner.
+//--------------------------------------------------------------------------------------------------
+GeoTiffExporter::GeoTiffExporter(const MapGrid& grid)
+    : m_grid(grid)
+    , m_fillValue(std::numeric_limits<float>::quiet_NaN())
+    , m_epsgCode(0)
+    , m_tileSize(256)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+GeoTiffExporter::~GeoTiffExporter()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MapGrid GeoTiffExporter::northUpGrid(const ZGYReader& reader, double cellSize)
+{
+    if ((cellSize <= 0.0) || (reader.inlineSize() == 0)) return MapGrid();
+
+    const int il0 = reader.inlineRange().first;
+    const int xl0 = reader.xlineRange().first;
+    const int il1 = il0 + (reader.inlineSize() - 1) * reader.inlineStep();
+    const int xl1 = xl0 + (reader.xlineSize() - 1) * reader.xlineStep();
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (int il : { il0, il1 })
+    {
+        for (int xl : { xl0, xl1 })
+        {
+            const auto [x, y] = reader.toWorldCoordinate(il, xl);
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+    }
+
+    const int sizeX = (int)std::floor((maxX - minX) / cellSize) + 1;
+    const int sizeY = (int)std::floor((maxY - minY) / cellSize) + 1;
+
+    return MapGrid(Point2d(minX, maxY), cellSize, -cellSize, sizeX, sizeY);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Value for cells outside the survey or next to undefined samples. Also written as the nodata
+/// value of the GeoTIFF.
+//--------------------------------------------------------------------------------------------------
+void GeoTiffExporter::setFillValue(float fillValue)
+{
+    m_fillValue = fillValue;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Projected coordinate system of the world coordinates. Zero writes it as user defined.
+//--------------------------------------------------------------------------------------------------
+void GeoTiffExporter::setEpsgCode(int code)
+{
+    m_epsgCode = code;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Rounded up to a multiple of 16, as TIFF requires.
+//--------------------------------------------------------------------------------------------------
+void GeoTiffExporter::setTileSize(int pixels)
+{
+    m_tileSize = std::max(16, (pixels + 15) / 16 * 16);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string GeoTiffExporter::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Index coordinates are affine in world coordinates, so the inverse of the survey transform is
+/// found once from three cell centres, like the mosaic does.
+//--------------------------------------------------------------------------------------------------
+GeoTiffExporter::Transform GeoTiffExporter::indexTransform(const ZGYReader& reader) const
+{
+    Transform transform;
+
+    const auto base = reader.toInlineXlineIndex(m_grid.cellCentre(0, 0).x(), m_grid.cellCentre(0, 0).y());
+    const auto px = reader.toInlineXlineIndex(m_grid.cellCentre(1, 0).x(), m_grid.cellCentre(1, 0).y());
+    const auto py = reader.toInlineXlineIndex(m_grid.cellCentre(0, 1).x(), m_grid.cellCentre(0, 1).y());
+
+    transform.base[0] = base.first;
+    transform.base[1] = base.second;
+    transform.stepX[0] = px.first - base.first;
+    transform.stepX[1] = px.second - base.second;
+    transform.stepY[0] = py.first - base.first;
+    transform.stepY[1] = py.second - base.second;
+
+    return transform;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Bilinear samples of one grid row. The index position is linear in ix, so the loop has no
+/// dependencies between cells and vectorises apart from the gathers.
+//--------------------------------------------------------------------------------------------------
+void GeoTiffExporter::resampleRow(const Transform& transform, SeismicSliceData& slice, int iy, int ix0, int nx, float* output) const
+{
+    const int ni = slice.width();
+    const int nj = slice.depth();
+    const float* values = slice.values();
+    const float fill = m_fillValue;
+
+    const double u0 = transform.base[0] + iy * transform.stepY[0] + ix0 * transform.stepX[0];
+    const double v0 = transform.base[1] + iy * transform.stepY[1] + ix0 * transform.stepX[1];
+    const double du = transform.stepX[0];
+    const double dv = transform.stepX[1];
+
+    for (int x = 0; x < nx; x++)
+    {
+        const double u = u0 + x * du;
+        const double v = v0 + x * dv;
+
+        if ((u < 0.0) || (v < 0.0) || (u > ni - 1) || (v > nj - 1))
+        {
+            output[x] = fill;
+            continue;
+        }
+
+        const int i = std::min((int)u, std::max(0, ni - 2));
+        const int j = std::min((int)v, std::max(0, nj - 2));
+        const float fu = (float)(u - i);
+        const float fv = (float)(v - j);
+
+        const int i1 = std::min(i + 1, ni - 1);
+        const int j1 = std::min(j + 1, nj - 1);
+
+        const float a = values[(size_t)i * nj + j];
+        const float b = values[(size_t)i1 * nj + j];
+        const float c = values[(size_t)i * nj + j1];
+        const float d = values[(size_t)i1 * nj + j1];
+
+        const float top = a + fu * (b - a);
+        const float bottom = c + fu * (d - c);
+        const float value = top + fv * (bottom - top);
+
+        output[x] = std::isnan(value) ? fill : value;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The whole grid in memory, with the grid x index varying slowest like ZSliceMosaic::zSlice().
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> GeoTiffExporter::resample(const ZGYReader& reader, std::shared_ptr<SeismicSliceData> slice) const
+{
+    if (m_grid.isEmpty() || (slice == nullptr) || (slice->width() != reader.inlineSize()) || (slice->depth() != reader.xlineSize()) || slice->isEmpty())
+        return std::make_shared<SeismicSliceData>(0, 0);
+
+    const int sizeX = m_grid.sizeX();
+    const int sizeY = m_grid.sizeY();
+    const auto transform = indexTransform(reader);
+
+    auto retData = std::make_shared<SeismicSliceData>(sizeX, sizeY);
+    if (retData->isEmpty()) return retData;
+
+    float* output = retData->values();
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iy = 0; iy < sizeY; iy++)
+    {
+        std::vector<float> row(sizeX);
+        resampleRow(transform, *slice, iy, 0, sizeX, row.data());
+
+        for (int ix = 0; ix < sizeX; ix++)
+        {
+            output[(size_t)ix * sizeY + iy] = row[ix];
+        }
+    }
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Resample and write one row of tiles at a time, so memory use is bounded by a tile row
+/// regardless of the raster size. The tiles of a row are resampled in parallel.
+//--------------------------------------------------------------------------------------------------
+bool GeoTiffExporter::exportSlice(const ZGYReader& reader, std::shared_ptr<SeismicSliceData> slice, std::string filename)
+{
+    m_errorMessage.clear();
+
+    if (m_grid.isEmpty() || (m_grid.spacingX() <= 0.0) || (m_grid.spacingY() >= 0.0))
+    {
+        m_errorMessage = "The grid must be north-up, with positive x spacing and negative y spacing";
+        return false;
+    }
+
+    if ((slice == nullptr) || slice->isEmpty() || (slice->width() != reader.inlineSize()) || (slice->depth() != reader.xlineSize()))
+    {
+        m_errorMessage = "The slice does not match the survey";
+        return false;
+    }
+
+    const int sizeX = m_grid.sizeX();
+    const int sizeY = m_grid.sizeY();
+    const int tileSize = m_tileSize;
+    const int tilesX = (sizeX + tileSize - 1) / tileSize;
+    const int tilesY = (sizeY + tileSize - 1) / tileSize;
+
+    TiffWriter writer;
+    if (!writer.open(filename, sizeX, sizeY, tileSize))
+    {
+        m_errorMessage = "Could not create " + filename + ", or the raster is too large for a TIFF file";
+        return false;
+    }
+
+    const auto transform = indexTransform(reader);
+    std::vector<float> tiles((size_t)tilesX * tileSize * tileSize);
+
+    for (int ty = 0; ty < tilesY; ty++)
+    {
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int tx = 0; tx < tilesX; tx++)
+        {
+            float* tile = tiles.data() + (size_t)tx * tileSize * tileSize;
+            const int nx = std::min(tileSize, sizeX - tx * tileSize);
+
+            for (int row = 0; row < tileSize; row++)
+            {
+                float* output = tile + (size_t)row * tileSize;
+                const int iy = ty * tileSize + row;
+
+                // padding outside the raster is part of every edge tile
+                if (iy >= sizeY)
+                {
+                    std::fill(output, output + tileSize, m_fillValue);
+                    continue;
+                }
+
+                resampleRow(transform, *slice, iy, tx * tileSize, nx, output);
+                std::fill(output + nx, output + tileSize, m_fillValue);
+            }
+        }
+
+        for (int tx = 0; tx < tilesX; tx++)
+        {
+            if (!writer.writeTile(tiles.data() + (size_t)tx * tileSize * tileSize))
+            {
+                m_errorMessage = "Failed to write " + filename;
+                writer.close();
+                removeFile(filename);
+                return false;
+            }
+        }
+    }
+
+    // raster space is pixel is area, so the tie point is the outer corner of the first cell
+    const Point2d origin = m_grid.origin();
+    writer.setDoubleTag(tagModelPixelScale, { m_grid.spacingX(), -m_grid.spacingY(), 0.0 });
+    writer.setDoubleTag(tagModelTiepoint, { 0.0, 0.0, 0.0, origin.x() - m_grid.spacingX() / 2, origin.y() - m_grid.spacingY() / 2, 0.0 });
+    writer.setShortTag(tagGeoKeyDirectory, { 1, 1, 0, 3,
+                                             keyModelType, 0, 1, modelTypeProjected,
+                                             keyRasterType, 0, 1, rasterPixelIsArea,
+                                             keyProjectedCrs, 0, 1, (std::uint16_t)((m_epsgCode > 0) ? m_epsgCode : userDefined) });
+
+    // enough digits to give back the float fill value exactly
+    char noData[32];
+    std::snprintf(noData, sizeof(noData), "%.9g", m_fillValue);
+    writer.setAsciiTag(tagGdalNoData, std::isnan(m_fillValue) ? "nan" : noData);
+
+    if (!writer.close())
+    {
+        m_errorMessage = "Failed to write " + filename;
+        removeFile(filename);
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool GeoTiffExporter::exportZSlice(ZGYReader& reader, int zIndex, std::string filename)
+{
+    return exportSlice(reader, reader.zSlice(zIndex), filename);
+}
+
+}
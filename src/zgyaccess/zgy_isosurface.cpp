@@ -0,0 +1,360 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_isosurface.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    // Each cell is split into six tetrahedra sharing the main diagonal. Cube corners are numbered
+    // with bit 0 = inline, bit 1 = crossline and bit 2 = z. Because every face is split along the
+    // diagonal from its lowest to its highest corner, neighbouring cells (and bricks) always agree
+    // on the shared edges, so the surface has no seams.
+    const int tetrahedra[6][4] = {
+        { 0, 1, 3, 7 },
+        { 0, 1, 5, 7 },
+        { 0, 2, 3, 7 },
+        { 0, 2, 6, 7 },
+        { 0, 4, 5, 7 },
+        { 0, 4, 6, 7 }
+    };
+
+    // All tetrahedron edges go from a corner to one with a superset of its bits, so an edge is
+    // identified by its lower corner and one of seven directions.
+    const int edgeDirection[8] = { -1, 0, 1, 3, 2, 4, 5, 6 };
+    const int numDirections = 7;
+
+    class BlockMesh
+    {
+    public:
+        std::vector<float> vertices;
+        std::vector<std::uint64_t> keys;
+        std::vector<bool> onBoundary;
+        std::vector<int> triangles;
+        bool failed = false;
+    };
+
+    class BlockMesher
+    {
+    public:
+        BlockMesher(const std::vector<float>& samples, std::array<int, 3> origin, std::array<int, 3> size, std::array<int, 3> lodSize, int factor, float isoValue, BlockMesh& mesh)
+            : m_samples(samples)
+            , m_origin(origin)
+            , m_size(size)
+            , m_lodSize(lodSize)
+            , m_factor(factor)
+            , m_isoValue(isoValue)
+            , m_mesh(mesh)
+            , m_vertexIndex((size_t)size[0] * size[1] * size[2] * numDirections, -1)
+        {
+        }
+
+        void run()
+        {
+            for (int i = 0; i < m_size[0] - 1; i++)
+            {
+                for (int j = 0; j < m_size[1] - 1; j++)
+                {
+                    for (int k = 0; k < m_size[2] - 1; k++)
+                    {
+                        cell(i, j, k);
+                    }
+                }
+            }
+        }
+
+    private:
+        float sample(const std::array<int, 3>& p) const
+        {
+            return m_samples[((size_t)p[0] * m_size[1] + p[1]) * m_size[2] + p[2]];
+        }
+
+        void cell(int i, int j, int k)
+        {
+            std::array<std::array<int, 3>, 8> corner;
+            std::array<float, 8> value;
+            int above = 0;
+
+            for (int c = 0; c < 8; c++)
+            {
+                corner[c] = { i + (c & 1), j + ((c >> 1) & 1), k + ((c >> 2) & 1) };
+                value[c] = sample(corner[c]);
+                if (!std::isfinite(value[c])) return;
+                if (value[c] >= m_isoValue) above++;
+            }
+
+            if ((above == 0) || (above == 8)) return;
+
+            for (const auto& tet : tetrahedra)
+            {
+                int inside[4];
+                int outside[4];
+                int nInside = 0;
+                int nOutside = 0;
+
+                for (int c : tet)
+                {
+                    if (value[c] >= m_isoValue)
+                        inside[nInside++] = c;
+                    else
+                        outside[nOutside++] = c;
+                }
+
+                if ((nInside == 0) || (nOutside == 0)) continue;
+
+                if (nInside == 1)
+                {
+                    triangle(corner, value, outside, nOutside,
+                             vertex(corner, value, inside[0], outside[0]),
+                             vertex(corner, value, inside[0], outside[1]),
+                             vertex(corner, value, inside[0], outside[2]));
+                }
+                else if (nInside == 3)
+                {
+                    triangle(corner, value, outside, nOutside,
+                             vertex(corner, value, outside[0], inside[0]),
+                             vertex(corner, value, outside[0], inside[1]),
+                             vertex(corner, value, outside[0], inside[2]));
+                }
+                else
+                {
+                    const int ac = vertex(corner, value, inside[0], outside[0]);
+                    const int ad = vertex(corner, value, inside[0], outside[1]);
+                    const int bd = vertex(corner, value, inside[1], outside[1]);
+                    const int bc = vertex(corner, value, inside[1], outside[0]);
+
+                    triangle(corner, value, outside, nOutside, ac, ad, bd);
+                    triangle(corner, value, outside, nOutside, ac, bd, bc);
+                }
+            }
+        }
+
+        int vertex(const std::array<std::array<int, 3>, 8>& corner, const std::array<float, 8>& value, int a, int b)
+        {
+            if (a > b) std::swap(a, b);
+
+            const auto& p = corner[a];
+            const auto& q = corner[b];
+            const int dir = edgeDirection[a ^ b];
+            const size_t localKey = (((size_t)p[0] * m_size[1] + p[1]) * m_size[2] + p[2]) * numDirections + dir;
+
+            int& index = m_vertexIndex[localKey];
+            if (index >= 0) return index;
+
+            const float va = value[a];
+            const float vb = value[b];
+            const float t = (vb != va) ? (m_isoValue - va) / (vb - va) : 0.5f;
+
+            index = (int)m_mesh.keys.size();
+
+            bool onBoundary = false;
+            std::array<std::uint64_t, 3> global;
+            for (int d = 0; d < 3; d++)
+            {
+                const float pos = (m_origin[d] + p[d] + t * (q[d] - p[d])) * m_factor;
+                m_mesh.vertices.push_back(pos);
+
+                global[d] = (std::uint64_t)(m_origin[d] + p[d]);
+                if ((p[d] == 0) || (p[d] == m_size[d] - 1)) onBoundary = true;
+            }
+
+            m_mesh.keys.push_back(((global[0] * m_lodSize[1] + global[1]) * m_lodSize[2] + global[2]) * numDirections + dir);
+            m_mesh.onBoundary.push_back(onBoundary);
+
+            return index;
+        }
+
+        void triangle(const std::array<std::array<int, 3>, 8>& corner, const std::array<float, 8>& value, const int* outside, int nOutside, int v0, int v1, int v2)
+        {
+            const float* p0 = &m_mesh.vertices[3 * v0];
+            const float* p1 = &m_mesh.vertices[3 * v1];
+            const float* p2 = &m_mesh.vertices[3 * v2];
+
+            const float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+            const float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+            const float normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+
+            // orient the triangle so that the normal points towards the corners below the iso value
+            float dot = 0.0f;
+            for (int d = 0; d < 3; d++)
+            {
+                float outsideCentre = 0.0f;
+                for (int c = 0; c < nOutside; c++)
+                {
+                    outsideCentre += (m_origin[d] + corner[outside[c]][d]) * m_factor;
+                }
+                outsideCentre /= nOutside;
+
+                dot += normal[d] * (outsideCentre - (p0[d] + p1[d] + p2[d]) / 3.0f);
+            }
+
+            m_mesh.triangles.push_back(v0);
+            if (dot >= 0.0f)
+            {
+                m_mesh.triangles.push_back(v1);
+                m_mesh.triangles.push_back(v2);
+            }
+            else
+            {
+                m_mesh.triangles.push_back(v2);
+                m_mesh.triangles.push_back(v1);
+            }
+        }
+
+    private:
+        const std::vector<float>& m_samples;
+        std::array<int, 3> m_origin;
+        std::array<int, 3> m_size;
+        std::array<int, 3> m_lodSize;
+        int m_factor;
+        float m_isoValue;
+        BlockMesh& m_mesh;
+        std::vector<int> m_vertexIndex;
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+IsoSurfaceExtractor::IsoSurfaceExtractor(float isoValue)
+    : m_isoValue(isoValue)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+IsoSurfaceExtractor::~IsoSurfaceExtractor()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Extract the iso surface inside the sub-volume given by start and size (full resolution indices)
+/// using the data at the given level of detail. The region is split along the brick boundaries and
+/// each brick is meshed in parallel. Vertices on edges shared between bricks are merged afterwards.
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<IsoSurfaceMesh> IsoSurfaceExtractor::extract(const ZGYReader& reader, int lod, std::array<int, 3> start, std::array<int, 3> size) const
+{
+    auto retData = std::make_unique<IsoSurfaceMesh>();
+
+    const auto lodSize = reader.sizeAtLod(lod);
+    const auto brickSize = reader.brickSize();
+    if ((lodSize[0] <= 0) || (lodSize[1] <= 0) || (lodSize[2] <= 0)) return retData;
+
+    const int factor = 1 << lod;
+
+    std::array<int, 3> lodStart;
+    std::array<int, 3> lodEnd;
+    std::array<int, 3> blockCount;
+    for (int d = 0; d < 3; d++)
+    {
+        lodStart[d] = std::clamp(start[d], 0, lodSize[d] * factor) / factor;
+        lodEnd[d] = std::min(lodSize[d], (std::max(0, start[d] + size[d]) + factor - 1) / factor);
+
+        // need at least two samples to make a cell
+        if (lodEnd[d] - lodStart[d] < 2) return retData;
+
+        const int firstBrick = lodStart[d] / brickSize[d];
+        const int lastBrick = (lodEnd[d] - 2) / brickSize[d];
+        blockCount[d] = lastBrick - firstBrick + 1;
+    }
+
+    const int nBlocks = blockCount[0] * blockCount[1] * blockCount[2];
+    std::vector<BlockMesh> blocks(nBlocks);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < nBlocks; b++)
+    {
+        if (failed) continue;
+
+        const std::array<int, 3> blockIndex = { b / (blockCount[1] * blockCount[2]), (b / blockCount[2]) % blockCount[1], b % blockCount[2] };
+
+        std::array<int, 3> origin;
+        std::array<int, 3> samples;
+        for (int d = 0; d < 3; d++)
+        {
+            const int brickStart = (lodStart[d] / brickSize[d] + blockIndex[d]) * brickSize[d];
+            const int cellFirst = std::max(brickStart, lodStart[d]);
+            const int cellLast = std::min(brickStart + brickSize[d], lodEnd[d] - 1) - 1;
+
+            origin[d] = cellFirst;
+            samples[d] = cellLast - cellFirst + 2;
+        }
+
+        std::vector<float> buffer((size_t)samples[0] * samples[1] * samples[2]);
+        if (!reader.readVolume(lod, origin, samples, buffer.data()))
+        {
+            failed = true;
+            continue;
+        }
+
+        BlockMesher mesher(buffer, origin, samples, lodSize, factor, m_isoValue, blocks[b]);
+        mesher.run();
+    }
+
+    if (failed) return retData;
+
+    std::unordered_map<std::uint64_t, int> sharedVertices;
+    std::vector<int> globalIndex;
+
+    for (auto& block : blocks)
+    {
+        const int nVertices = (int)block.keys.size();
+        globalIndex.resize(nVertices);
+
+        for (int v = 0; v < nVertices; v++)
+        {
+            const int newIndex = retData->vertexCount();
+
+            if (block.onBoundary[v])
+            {
+                auto [it, inserted] = sharedVertices.emplace(block.keys[v], newIndex);
+                if (!inserted)
+                {
+                    globalIndex[v] = it->second;
+                    continue;
+                }
+            }
+
+            globalIndex[v] = newIndex;
+            retData->vertices.insert(retData->vertices.end(), block.vertices.begin() + 3 * v, block.vertices.begin() + 3 * v + 3);
+        }
+
+        for (int index : block.triangles)
+        {
+            retData->triangles.push_back(globalIndex[index]);
+        }
+
+        block = BlockMesh();
+    }
+
+    return retData;
+}
+
+}
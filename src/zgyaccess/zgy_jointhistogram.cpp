@@ -0,0 +1,234 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_jointhistogram.h"
+#include "zgyaccess/zgy_memorygovernor.h"
+#include "zgyaccess/zgy_multivolume.h"
+#include "zgyaccess/zgy_outlinemask.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    // 128 MB of double counts, e.g. three volumes with 256 bins each
+    const std::int64_t maxTotalBins = std::int64_t(1) << 24;
+
+    // total bin count, or -1 beyond the limit
+    std::int64_t totalBins(const std::vector<int>& nBins)
+    {
+        std::int64_t total = nBins.empty() ? 0 : 1;
+        for (int bins : nBins)
+        {
+            total *= std::max(1, bins);
+            if (total > maxTotalBins) return -1;
+        }
+        return total;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double JointHistogramData::count(const std::vector<int>& bin) const
+{
+    if ((int)bin.size() != dimensions()) return 0.0;
+
+    size_t index = 0;
+    for (int d = 0; d < dimensions(); d++)
+    {
+        if ((bin[d] < 0) || (bin[d] >= (int)binCentres[d].size())) return 0.0;
+
+        index = index * binCentres[d].size() + bin[d];
+    }
+
+    return counts[index];
+}
+
+//--------------------------------------------------------------------------------------------------
+/// One bin count and value range per dimension. Values outside the range are counted in the
+/// first or last bin. More than 2^24 bins in total gives a generator without dimensions.
+//--------------------------------------------------------------------------------------------------
+JointHistogramGenerator::JointHistogramGenerator(std::vector<int> nBins, std::vector<float> minVals, std::vector<float> maxVals)
+{
+    if ((nBins.size() != minVals.size()) || (nBins.size() != maxVals.size())) return;
+
+    const std::int64_t nTotal = totalBins(nBins);
+    if (nTotal < 0) return;
+
+    for (size_t d = 0; d < nBins.size(); d++)
+    {
+        const int bins = std::max(1, nBins[d]);
+        m_nBins.push_back(bins);
+        m_minVals.push_back(minVals[d]);
+        m_maxVals.push_back(maxVals[d]);
+        m_scales.push_back((maxVals[d] > minVals[d]) ? bins / ((double)maxVals[d] - minVals[d]) : 0.0);
+    }
+
+    m_counts.assign((size_t)nTotal, 0.0);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+JointHistogramGenerator::~JointHistogramGenerator()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Add interleaved samples, one value per dimension for each sample. Samples with a NaN or
+/// infinite value in any dimension are skipped.
+//--------------------------------------------------------------------------------------------------
+void JointHistogramGenerator::addData(const float* values, size_t nSamples)
+{
+    const int nDims = (int)m_nBins.size();
+    if (nDims == 0) return;
+
+    for (size_t n = 0; n < nSamples; n++)
+    {
+        const float* sample = values + n * nDims;
+
+        size_t index = 0;
+        bool valid = true;
+        for (int d = 0; d < nDims; d++)
+        {
+            if (!std::isfinite(sample[d]))
+            {
+                valid = false;
+                break;
+            }
+
+            // clamped before the cast, as large finite values do not fit in an int
+            const int bin = (int)std::clamp((sample[d] - m_minVals[d]) * m_scales[d], 0.0, (double)(m_nBins[d] - 1));
+            index = index * m_nBins[d] + bin;
+        }
+
+        if (valid) m_counts[index] += 1.0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Add the counts of a generator with the same bins.
+//--------------------------------------------------------------------------------------------------
+void JointHistogramGenerator::merge(const JointHistogramGenerator& other)
+{
+    if (other.m_counts.size() != m_counts.size()) return;
+
+    for (size_t i = 0; i < m_counts.size(); i++)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<JointHistogramData> JointHistogramGenerator::getHistogram() const
+{
+    auto retData = std::make_unique<JointHistogramData>();
+
+    for (size_t d = 0; d < m_nBins.size(); d++)
+    {
+        const double binsize = (m_maxVals[d] - m_minVals[d]) / m_nBins[d];
+
+        std::vector<double> centres;
+        for (int i = 0; i < m_nBins[d]; i++)
+        {
+            centres.push_back(m_minVals[d] + binsize * (i + 0.5));
+        }
+        retData->binCentres.push_back(centres);
+    }
+
+    retData->counts = m_counts;
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Joint histogram of all volumes over the samples inside the mask and z range, nBins bins per
+/// volume over the data range of each file. Brick columns are split into one chunk per thread, each
+/// with its own bins, and the chunks are merged at the end. The bins of all threads count against
+/// the memory budget, and too many bins or a refused budget give an empty histogram.
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<JointHistogramData> JointHistogramGenerator::crossplot(const MultiVolumeReader& volumes, const OutlineMask& mask, int nBins, int zStartIndex, int zSize)
+{
+    if (!volumes.isCompatible()) return std::make_unique<JointHistogramData>();
+
+    std::vector<int> bins;
+    std::vector<float> minVals;
+    std::vector<float> maxVals;
+    for (int v = 0; v < volumes.volumeCount(); v++)
+    {
+        const auto [minVal, maxVal] = volumes.volume(v)->dataRange();
+        bins.push_back(nBins);
+        minVals.push_back((float)minVal);
+        maxVals.push_back((float)maxVal);
+    }
+
+    const std::int64_t nTotal = totalBins(bins);
+    if (nTotal <= 0) return std::make_unique<JointHistogramData>();
+
+    const auto columns = volumes.maskedBrickColumns(mask);
+    const int nColumns = (int)columns.size();
+    const int nChunks = std::min(nColumns, (int)std::max(1u, std::thread::hardware_concurrency()));
+
+    // bins per chunk plus the merged total
+    MemoryReservation reservation(MemoryCategory::SliceData, (nChunks + 1) * nTotal * (std::int64_t)sizeof(double));
+    if (!reservation.isValid()) return std::make_unique<JointHistogramData>();
+
+    std::vector<std::unique_ptr<JointHistogramGenerator>> chunkGenerators(nChunks);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int chunk = 0; chunk < nChunks; chunk++)
+    {
+        auto generator = std::make_unique<JointHistogramGenerator>(bins, minVals, maxVals);
+
+        for (int c = chunk; c < nColumns; c += nChunks)
+        {
+            if (failed) break;
+
+            if (!volumes.readMaskedColumn(mask, columns[c], zStartIndex, zSize, [&generator](const float* values, size_t nSamples) { generator->addData(values, nSamples); }))
+            {
+                failed = true;
+            }
+        }
+
+        chunkGenerators[chunk] = std::move(generator);
+    }
+
+    if (failed) return std::make_unique<JointHistogramData>();
+
+    JointHistogramGenerator total(bins, minVals, maxVals);
+    for (auto& generator : chunkGenerators)
+    {
+        total.merge(*generator);
+        generator.reset();
+    }
+
+    return total.getHistogram();
+}
+
+}
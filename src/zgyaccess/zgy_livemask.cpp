@@ -0,0 +1,319 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_livemask.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    const char sidecarMagic[8] = { 'Z', 'G', 'Y', 'L', 'I', 'V', 'E', '1' };
+
+    // Per trace state while scanning a brick column. A trace is dead if all its samples have the
+    // same value, which is what padding and unrecorded traces look like in a ZGY file.
+    class TraceState
+    {
+    public:
+        bool seen = false;
+        bool live = false;
+        float value = 0.0f;
+
+        void add(float minVal, float maxVal)
+        {
+            if (live) return;
+
+            if ((minVal != maxVal) || (seen && (minVal != value)))
+            {
+                live = true;
+                return;
+            }
+
+            seen = true;
+            value = minVal;
+        }
+    };
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+LiveTraceMask::LiveTraceMask()
+    : m_inlineSize(0)
+    , m_xlineSize(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// All traces start out as dead.
+//--------------------------------------------------------------------------------------------------
+LiveTraceMask::LiveTraceMask(int inlineSize, int xlineSize)
+    : m_inlineSize(std::max(0, inlineSize))
+    , m_xlineSize(std::max(0, xlineSize))
+{
+    m_bits.assign(((size_t)m_inlineSize * m_xlineSize + 63) / 64, 0);
+    m_rowCount.assign(m_inlineSize, 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+LiveTraceMask::~LiveTraceMask()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Find the live traces of the survey, one brick column at a time in parallel. Bricks stored as
+/// constant are classified without decompressing them, so only bricks with real data are read.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<LiveTraceMask> LiveTraceMask::compute(const ZGYReader& reader)
+{
+    const int ni = reader.inlineSize();
+    const int nj = reader.xlineSize();
+    const int nk = reader.zSize();
+
+    auto retval = std::make_shared<LiveTraceMask>(ni, nj);
+    if ((ni <= 0) || (nj <= 0) || (nk <= 0)) return retval;
+
+    const auto bricksize = reader.brickSize();
+    const int columnsI = (ni + bricksize[0] - 1) / bricksize[0];
+    const int columnsJ = (nj + bricksize[1] - 1) / bricksize[1];
+    const int nColumns = columnsI * columnsJ;
+
+    std::vector<std::uint8_t> live((size_t)ni * nj, 0);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nColumns; c++)
+    {
+        if (failed) continue;
+
+        const int i0 = (c / columnsJ) * bricksize[0];
+        const int j0 = (c % columnsJ) * bricksize[1];
+        const int ci = std::min(bricksize[0], ni - i0);
+        const int cj = std::min(bricksize[1], nj - j0);
+
+        std::vector<TraceState> traces((size_t)ci * cj);
+        std::vector<float> buffer;
+
+        for (int k0 = 0; k0 < nk; k0 += bricksize[2])
+        {
+            const int ck = std::min(bricksize[2], nk - k0);
+
+            float constValue;
+            if (reader.isConstant(0, { i0, j0, k0 }, { ci, cj, ck }, constValue))
+            {
+                for (auto& trace : traces)
+                {
+                    trace.add(constValue, constValue);
+                }
+                continue;
+            }
+
+            buffer.resize((size_t)ci * cj * ck);
+            if (!reader.readVolume(0, { i0, j0, k0 }, { ci, cj, ck }, buffer.data()))
+            {
+                failed = true;
+                break;
+            }
+
+            for (size_t t = 0; t < traces.size(); t++)
+            {
+                if (traces[t].live) continue;
+
+                const float* samples = buffer.data() + t * ck;
+                const auto [minIt, maxIt] = std::minmax_element(samples, samples + ck);
+                traces[t].add(*minIt, *maxIt);
+            }
+        }
+
+        for (int i = 0; i < ci; i++)
+        {
+            for (int j = 0; j < cj; j++)
+            {
+                live[(size_t)(i0 + i) * nj + j0 + j] = traces[(size_t)i * cj + j].live ? 1 : 0;
+            }
+        }
+    }
+
+    if (failed) return std::make_shared<LiveTraceMask>();
+
+    for (int i = 0; i < ni; i++)
+    {
+        for (int j = 0; j < nj; j++)
+        {
+            if (live[(size_t)i * nj + j]) retval->setLive(i, j, true);
+        }
+    }
+
+    return retval;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int LiveTraceMask::inlineSize() const
+{
+    return m_inlineSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int LiveTraceMask::xlineSize() const
+{
+    return m_xlineSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool LiveTraceMask::isEmpty() const
+{
+    return (m_inlineSize == 0) || (m_xlineSize == 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool LiveTraceMask::isLive(int inlineIndex, int xlineIndex) const
+{
+    if ((inlineIndex < 0) || (inlineIndex >= m_inlineSize) || (xlineIndex < 0) || (xlineIndex >= m_xlineSize)) return false;
+
+    const size_t bit = (size_t)inlineIndex * m_xlineSize + xlineIndex;
+    return (m_bits[bit / 64] >> (bit % 64)) & 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void LiveTraceMask::setLive(int inlineIndex, int xlineIndex, bool live)
+{
+    if ((inlineIndex < 0) || (inlineIndex >= m_inlineSize) || (xlineIndex < 0) || (xlineIndex >= m_xlineSize)) return;
+    if (isLive(inlineIndex, xlineIndex) == live) return;
+
+    const size_t bit = (size_t)inlineIndex * m_xlineSize + xlineIndex;
+    m_bits[bit / 64] ^= std::uint64_t(1) << (bit % 64);
+    m_rowCount[inlineIndex] += live ? 1 : -1;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int LiveTraceMask::liveCount(int inlineIndex) const
+{
+    if ((inlineIndex < 0) || (inlineIndex >= m_inlineSize)) return 0;
+
+    return m_rowCount[inlineIndex];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t LiveTraceMask::liveCount() const
+{
+    std::int64_t count = 0;
+    for (int rowCount : m_rowCount)
+    {
+        count += rowCount;
+    }
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// True if any trace in the box is live. Lets readers skip dead bricks entirely.
+//--------------------------------------------------------------------------------------------------
+bool LiveTraceMask::hasLiveTraces(int inlineStart, int inlineSize, int xlineStart, int xlineSize) const
+{
+    const int iEnd = std::min(m_inlineSize, inlineStart + inlineSize);
+    const int jEnd = std::min(m_xlineSize, xlineStart + xlineSize);
+
+    for (int i = std::max(0, inlineStart); i < iEnd; i++)
+    {
+        if (m_rowCount[i] == 0) continue;
+
+        for (int j = std::max(0, xlineStart); j < jEnd; j++)
+        {
+            if (isLive(i, j)) return true;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Store the mask in a sidecar file. The source stamp identifies the version of the ZGY file the
+/// mask was computed from, so that a stale sidecar is not used.
+//--------------------------------------------------------------------------------------------------
+bool LiveTraceMask::save(std::string filename, std::uint64_t sourceStamp) const
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    const std::int32_t sizes[2] = { m_inlineSize, m_xlineSize };
+
+    file.write(sidecarMagic, sizeof(sidecarMagic));
+    file.write(reinterpret_cast<const char*>(&sourceStamp), sizeof(sourceStamp));
+    file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    file.write(reinterpret_cast<const char*>(m_bits.data()), m_bits.size() * sizeof(std::uint64_t));
+
+    return file.good();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool LiveTraceMask::load(std::string filename, std::uint64_t sourceStamp)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    char magic[sizeof(sidecarMagic)];
+    std::uint64_t stamp = 0;
+    std::int32_t sizes[2] = { 0, 0 };
+
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&stamp), sizeof(stamp));
+    file.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+
+    if (!file || (std::memcmp(magic, sidecarMagic, sizeof(magic)) != 0) || (stamp != sourceStamp)) return false;
+    if ((sizes[0] < 0) || (sizes[1] < 0)) return false;
+
+    LiveTraceMask mask(sizes[0], sizes[1]);
+    file.read(reinterpret_cast<char*>(mask.m_bits.data()), mask.m_bits.size() * sizeof(std::uint64_t));
+    if (!file) return false;
+
+    for (int i = 0; i < mask.m_inlineSize; i++)
+    {
+        for (int j = 0; j < mask.m_xlineSize; j++)
+        {
+            if (mask.isLive(i, j)) mask.m_rowCount[i]++;
+        }
+    }
+
+    *this = std::move(mask);
+    return true;
+}
+
+}
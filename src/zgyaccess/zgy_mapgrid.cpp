@@ -0,0 +1,110 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_mapgrid.h"
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MapGrid::MapGrid()
+    : m_origin(0.0, 0.0)
+    , m_spacingX(0.0)
+    , m_spacingY(0.0)
+    , m_sizeX(0)
+    , m_sizeY(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Axis aligned grid in world coordinates. The origin is the centre of the first cell.
+//--------------------------------------------------------------------------------------------------
+MapGrid::MapGrid(Point2d origin, double spacingX, double spacingY, int sizeX, int sizeY)
+    : m_origin(origin)
+    , m_spacingX(spacingX)
+    , m_spacingY(spacingY)
+    , m_sizeX(sizeX)
+    , m_sizeY(sizeY)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MapGrid::~MapGrid()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Point2d MapGrid::origin() const
+{
+    return m_origin;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double MapGrid::spacingX() const
+{
+    return m_spacingX;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double MapGrid::spacingY() const
+{
+    return m_spacingY;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int MapGrid::sizeX() const
+{
+    return m_sizeX;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int MapGrid::sizeY() const
+{
+    return m_sizeY;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool MapGrid::isEmpty() const
+{
+    return (m_sizeX <= 0) || (m_sizeY <= 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+Point2d MapGrid::cellCentre(int ix, int iy) const
+{
+    return Point2d(m_origin.x() + ix * m_spacingX, m_origin.y() + iy * m_spacingY);
+}
+
+}
@@ -0,0 +1,271 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MemoryGovernor& MemoryGovernor::instance()
+{
+    static MemoryGovernor governor;
+    return governor;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MemoryGovernor::MemoryGovernor()
+    : m_budget(0)
+    , m_waitTimeout(0)
+    , m_usage(0)
+    , m_peakUsage(0)
+    , m_refusedCount(0)
+    , m_categoryUsage{ 0, 0, 0 }
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Lowering the budget below the current usage asks the caches to shrink, but does not take
+/// memory back from slices already handed out.
+//--------------------------------------------------------------------------------------------------
+void MemoryGovernor::setBudget(std::int64_t bytes)
+{
+    std::int64_t overflow = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_budget = std::max<std::int64_t>(0, bytes);
+        if (m_budget > 0) overflow = m_usage - m_budget;
+    }
+    m_released.notify_all();
+
+    if (overflow > 0) reclaim(overflow);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t MemoryGovernor::budget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_budget;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MemoryGovernor::setWaitTimeout(int milliseconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_waitTimeout = std::max(0, milliseconds);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int MemoryGovernor::waitTimeout() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_waitTimeout;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Account for an allocation, shrinking caches and then waiting if it does not fit. Requests
+/// larger than the whole budget fail at once.
+//--------------------------------------------------------------------------------------------------
+bool MemoryGovernor::acquire(MemoryCategory category, std::int64_t bytes)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (fits(bytes))
+    {
+        take(category, bytes);
+        return true;
+    }
+    if (bytes > m_budget)
+    {
+        m_refusedCount++;
+        return false;
+    }
+
+    // reclaimers release memory through the governor, so they are called without holding the lock
+    const std::int64_t shortfall = m_usage + bytes - m_budget;
+    lock.unlock();
+    reclaim(shortfall);
+    lock.lock();
+
+    if (m_released.wait_for(lock, std::chrono::milliseconds(m_waitTimeout), [this, bytes]() { return fits(bytes); }))
+    {
+        take(category, bytes);
+        return true;
+    }
+
+    m_refusedCount++;
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MemoryGovernor::release(MemoryCategory category, std::int64_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_usage -= bytes;
+        m_categoryUsage[(size_t)category] -= bytes;
+    }
+    m_released.notify_all();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t MemoryGovernor::usage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_usage;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t MemoryGovernor::usage(MemoryCategory category) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_categoryUsage[(size_t)category];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t MemoryGovernor::peakUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_peakUsage;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MemoryGovernor::resetPeakUsage()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_peakUsage = m_usage;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t MemoryGovernor::refusedCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_refusedCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MemoryGovernor::addReclaimer(std::weak_ptr<MemoryReclaimer> reclaimer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_reclaimers.erase(std::remove_if(m_reclaimers.begin(), m_reclaimers.end(), [](const std::weak_ptr<MemoryReclaimer>& r) { return r.expired(); }), m_reclaimers.end());
+    m_reclaimers.push_back(reclaimer);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool MemoryGovernor::fits(std::int64_t bytes) const
+{
+    return (m_budget == 0) || (m_usage + bytes <= m_budget);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MemoryGovernor::take(MemoryCategory category, std::int64_t bytes)
+{
+    m_usage += bytes;
+    m_categoryUsage[(size_t)category] += bytes;
+    m_peakUsage = std::max(m_peakUsage, m_usage);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Ask the reclaimers in turn until enough has been freed. Called without holding the lock.
+//--------------------------------------------------------------------------------------------------
+void MemoryGovernor::reclaim(std::int64_t bytes)
+{
+    std::vector<std::weak_ptr<MemoryReclaimer>> reclaimers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        reclaimers = m_reclaimers;
+    }
+
+    std::int64_t freed = 0;
+    for (auto& weakReclaimer : reclaimers)
+    {
+        if (freed >= bytes) break;
+
+        auto reclaimer = weakReclaimer.lock();
+        if (reclaimer != nullptr) freed += reclaimer->reclaim(bytes - freed);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MemoryReservation::MemoryReservation(MemoryCategory category, std::int64_t bytes)
+    : m_category(category)
+    , m_bytes(bytes)
+    , m_valid(MemoryGovernor::instance().acquire(category, bytes))
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MemoryReservation::~MemoryReservation()
+{
+    if (m_valid) MemoryGovernor::instance().release(m_category, m_bytes);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool MemoryReservation::isValid() const
+{
+    return m_valid;
+}
+
+}
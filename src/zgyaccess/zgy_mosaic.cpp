@@ -0,0 +1,290 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_mosaic.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    // The part of one survey that overlaps the output grid, read at a suitable level of detail,
+    // together with the affine map from output cells to survey grid indices.
+    class SurveyWindow
+    {
+    public:
+        bool valid = false;
+
+        int lod = 0;
+        int factor = 1;
+        std::array<int, 2> start{ 0, 0 };
+        std::array<int, 2> size{ 0, 0 };
+        std::vector<float> values;
+
+        std::array<int, 2> surveySize{ 0, 0 };
+        std::array<double, 2> traceSpacing{ 0.0, 0.0 };
+
+        std::array<double, 2> base{ 0.0, 0.0 };
+        std::array<double, 2> stepX{ 0.0, 0.0 };
+        std::array<double, 2> stepY{ 0.0, 0.0 };
+
+        // sample the window at the survey grid index (u, v), returns false if outside the survey
+        bool sample(double u, double v, float& value) const
+        {
+            const double eps = 1e-6;
+            if ((u < -eps) || (v < -eps) || (u > surveySize[0] - 1 + eps) || (v > surveySize[1] - 1 + eps)) return false;
+
+            const double x = std::clamp(u / factor - start[0], 0.0, size[0] - 1.0);
+            const double y = std::clamp(v / factor - start[1], 0.0, size[1] - 1.0);
+
+            const int x0 = std::min((int)x, size[0] - 1);
+            const int y0 = std::min((int)y, size[1] - 1);
+            const int x1 = std::min(x0 + 1, size[0] - 1);
+            const int y1 = std::min(y0 + 1, size[1] - 1);
+            const float fx = (float)(x - x0);
+            const float fy = (float)(y - y0);
+
+            const float v00 = values[(size_t)x0 * size[1] + y0];
+            const float v01 = values[(size_t)x0 * size[1] + y1];
+            const float v10 = values[(size_t)x1 * size[1] + y0];
+            const float v11 = values[(size_t)x1 * size[1] + y1];
+
+            value = (v00 * (1 - fy) + v01 * fy) * (1 - fx) + (v10 * (1 - fy) + v11 * fy) * fx;
+            return std::isfinite(value);
+        }
+
+        double edgeDistance(double u, double v) const
+        {
+            const double du = std::min(u, surveySize[0] - 1 - u) * traceSpacing[0];
+            const double dv = std::min(v, surveySize[1] - 1 - v) * traceSpacing[1];
+            return std::max(0.0, std::min(du, dv));
+        }
+    };
+
+    double distance(std::pair<double, double> a, std::pair<double, double> b)
+    {
+        return std::hypot(b.first - a.first, b.second - a.second);
+    }
+
+    SurveyWindow readWindow(const ZGYReader& reader, const MapGrid& grid, double z)
+    {
+        SurveyWindow window;
+
+        if ((reader.zSize() == 0) || (reader.zStep() <= 0.0)) return window;
+
+        const int zIndex = (int)std::lround((z - reader.zRange().first) / reader.zStep());
+        if ((zIndex < 0) || (zIndex >= reader.zSize())) return window;
+
+        window.surveySize = { reader.inlineSize(), reader.xlineSize() };
+
+        const int il = reader.inlineRange().first;
+        const int xl = reader.xlineRange().first;
+        const auto origin = reader.toWorldCoordinate(il, xl);
+        window.traceSpacing[0] = distance(origin, reader.toWorldCoordinate(il + reader.inlineStep(), xl));
+        window.traceSpacing[1] = distance(origin, reader.toWorldCoordinate(il, xl + reader.xlineStep()));
+
+        const auto toIndex = [&reader](Point2d p) {
+            auto [u, v] = reader.toInlineXlineIndex(p.x(), p.y());
+            return std::array<double, 2>{ u, v };
+        };
+
+        window.base = toIndex(grid.cellCentre(0, 0));
+        const auto px = toIndex(grid.cellCentre(1, 0));
+        const auto py = toIndex(grid.cellCentre(0, 1));
+        for (int d = 0; d < 2; d++)
+        {
+            window.stepX[d] = px[d] - window.base[d];
+            window.stepY[d] = py[d] - window.base[d];
+        }
+
+        // use the coarsest level of detail that is still at least as fine as the output grid
+        const double cellSize = std::min(std::abs(grid.spacingX()), std::abs(grid.spacingY()));
+        const double traceSize = std::min(window.traceSpacing[0], window.traceSpacing[1]);
+        if (traceSize > 0.0)
+        {
+            while ((window.lod + 1 < reader.lodCount()) && (traceSize * (2 << window.lod) <= cellSize))
+            {
+                window.lod++;
+            }
+        }
+        window.factor = 1 << window.lod;
+
+        const auto lodSize = reader.sizeAtLod(window.lod);
+        const int zLod = zIndex / window.factor;
+        if (zLod >= lodSize[2]) return window;
+
+        // bounding box of the output grid in survey index space
+        std::array<double, 2> lo{ 1e300, 1e300 };
+        std::array<double, 2> hi{ -1e300, -1e300 };
+        for (int cx : { 0, grid.sizeX() - 1 })
+        {
+            for (int cy : { 0, grid.sizeY() - 1 })
+            {
+                for (int d = 0; d < 2; d++)
+                {
+                    const double pos = window.base[d] + cx * window.stepX[d] + cy * window.stepY[d];
+                    lo[d] = std::min(lo[d], pos);
+                    hi[d] = std::max(hi[d], pos);
+                }
+            }
+        }
+
+        for (int d = 0; d < 2; d++)
+        {
+            const int first = std::max(0, (int)std::floor(lo[d] / window.factor) - 1);
+            const int last = std::min(lodSize[d] - 1, (int)std::ceil(hi[d] / window.factor) + 1);
+            if (last < first) return window;
+
+            window.start[d] = first;
+            window.size[d] = last - first + 1;
+        }
+
+        window.values.resize((size_t)window.size[0] * window.size[1]);
+        window.valid = reader.readVolume(window.lod, { window.start[0], window.start[1], zLod }, { window.size[0], window.size[1], 1 }, window.values.data());
+
+        return window;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ZSliceMosaic::ZSliceMosaic(const MapGrid& grid)
+    : m_grid(grid)
+    , m_blendMode(MosaicBlend::Priority)
+    , m_featherWidth(0.0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ZSliceMosaic::~ZSliceMosaic()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// With Priority, each output cell takes the value of the highest priority survey covering it.
+/// With Feather, overlapping surveys are averaged with weights that fall to zero over
+/// featherWidth (world units) towards the edge of each survey.
+//--------------------------------------------------------------------------------------------------
+void ZSliceMosaic::setBlendMode(MosaicBlend mode, double featherWidth)
+{
+    m_blendMode = mode;
+    m_featherWidth = featherWidth;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ZSliceMosaic::addSurvey(std::shared_ptr<ZGYReader> reader, int priority)
+{
+    if (reader == nullptr) return;
+
+    m_surveys.push_back({ reader, priority });
+
+    std::stable_sort(m_surveys.begin(), m_surveys.end(), [](const Survey& a, const Survey& b) { return a.priority > b.priority; });
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ZSliceMosaic::clearSurveys()
+{
+    m_surveys.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Mosaic of all surveys at the given z value (in the z unit of the surveys) on the output grid.
+/// The data is stored with the grid x index varying slowest, like zSlice(). Cells not covered by
+/// any survey get fillValue.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> ZSliceMosaic::zSlice(double z, float fillValue) const
+{
+    if (m_grid.isEmpty()) return std::make_shared<SeismicSliceData>(0, 0);
+
+    const int nSurveys = (int)m_surveys.size();
+    std::vector<SurveyWindow> windows(nSurveys);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int s = 0; s < nSurveys; s++)
+    {
+        windows[s] = readWindow(*m_surveys[s].reader, m_grid, z);
+    }
+
+    const int sizeX = m_grid.sizeX();
+    const int sizeY = m_grid.sizeY();
+
+    std::shared_ptr<SeismicSliceData> retData = std::make_shared<SeismicSliceData>(sizeX, sizeY);
+    if (retData->isEmpty()) return retData;
+
+    float* output = retData->values();
+
+    const bool feather = (m_blendMode == MosaicBlend::Feather);
+    const double featherWidth = m_featherWidth;
+
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+    for (int ix = 0; ix < sizeX; ix++)
+    {
+        for (int iy = 0; iy < sizeY; iy++)
+        {
+            bool covered = false;
+            float firstValue = fillValue;
+            double weightedSum = 0.0;
+            double weightSum = 0.0;
+
+            for (auto& window : windows)
+            {
+                if (!window.valid) continue;
+
+                const double u = window.base[0] + ix * window.stepX[0] + iy * window.stepY[0];
+                const double v = window.base[1] + ix * window.stepX[1] + iy * window.stepY[1];
+
+                float value;
+                if (!window.sample(u, v, value)) continue;
+
+                if (!covered)
+                {
+                    covered = true;
+                    firstValue = value;
+                    if (!feather) break;
+                }
+
+                const double weight = (featherWidth > 0.0) ? std::min(1.0, window.edgeDistance(u, v) / featherWidth) : 1.0;
+                weightedSum += weight * value;
+                weightSum += weight;
+            }
+
+            float result = firstValue;
+            if (feather && (weightSum > 0.0)) result = (float)(weightedSum / weightSum);
+
+            output[(size_t)ix * sizeY + iy] = result;
+        }
+    }
+
+    return retData;
+}
+
+}
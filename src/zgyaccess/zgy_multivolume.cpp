@@ -0,0 +1,411 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_multivolume.h"
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_outlinemask.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <new>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+InterleavedSliceData::InterleavedSliceData(int width, int depth, int channels)
+    : m_width(width)
+    , m_depth(depth)
+    , m_channels(channels)
+    , m_outOfMemory(false)
+{
+    const std::int64_t size = (std::int64_t)width * depth * channels;
+    bool allocated = false;
+
+    // counted against the memory budget as slice data, and left empty and flagged when refused
+    if ((width >= 0) && (depth >= 0) && (channels >= 0) && (size <= std::numeric_limits<int>::max()))
+    {
+        m_reservation = std::make_unique<MemoryReservation>(MemoryCategory::SliceData, size * (std::int64_t)sizeof(float));
+
+        try
+        {
+            if (m_reservation->isValid())
+            {
+                m_values.resize((size_t)size);
+                allocated = true;
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+    }
+
+    if (!allocated)
+    {
+        m_reservation.reset();
+        m_width = 0;
+        m_depth = 0;
+        m_channels = 0;
+        m_outOfMemory = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+InterleavedSliceData::~InterleavedSliceData()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+float* InterleavedSliceData::values()
+{
+    return m_values.data();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+float InterleavedSliceData::valueAt(int width, int depth, int channel) const
+{
+    if ((width < 0) || (width >= m_width) || (depth < 0) || (depth >= m_depth) || (channel < 0) || (channel >= m_channels)) return 0.0f;
+
+    return m_values[((size_t)width * m_depth + depth) * m_channels + channel];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int InterleavedSliceData::size() const
+{
+    return m_width * m_depth * m_channels;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int InterleavedSliceData::width() const
+{
+    return m_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int InterleavedSliceData::depth() const
+{
+    return m_depth;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int InterleavedSliceData::channels() const
+{
+    return m_channels;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool InterleavedSliceData::isEmpty() const
+{
+    return size() == 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool InterleavedSliceData::isOutOfMemory() const
+{
+    return m_outOfMemory;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MultiVolumeReader::MultiVolumeReader()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+MultiVolumeReader::~MultiVolumeReader()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Volumes must have the same size. The order of the volumes is the channel order of the output.
+//--------------------------------------------------------------------------------------------------
+void MultiVolumeReader::addVolume(std::shared_ptr<ZGYReader> reader)
+{
+    m_volumes.push_back(reader);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void MultiVolumeReader::clearVolumes()
+{
+    m_volumes.clear();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int MultiVolumeReader::volumeCount() const
+{
+    return (int)m_volumes.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ZGYReader> MultiVolumeReader::volume(int index) const
+{
+    if ((index < 0) || (index >= volumeCount())) return nullptr;
+
+    return m_volumes[index];
+}
+
+//--------------------------------------------------------------------------------------------------
+/// True if there is at least one volume and all volumes have the same size.
+//--------------------------------------------------------------------------------------------------
+bool MultiVolumeReader::isCompatible() const
+{
+    if (m_volumes.empty() || (m_volumes[0] == nullptr)) return false;
+
+    const auto volumeSize = m_volumes[0]->sizeAtLod(0);
+    for (const auto& volume : m_volumes)
+    {
+        if ((volume == nullptr) || (volume->sizeAtLod(0) != volumeSize)) return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<InterleavedSliceData> MultiVolumeReader::inlineSlice(int inlineIndex, int zStartIndex, int zSize) const
+{
+    if (m_volumes.empty()) return std::make_shared<InterleavedSliceData>(0, 0, 0);
+
+    const int width = m_volumes[0]->xlineSize();
+    return readSlice({ inlineIndex, 0, zStartIndex }, { 1, width, zSize }, width, zSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<InterleavedSliceData> MultiVolumeReader::xlineSlice(int xlineIndex, int zStartIndex, int zSize) const
+{
+    if (m_volumes.empty()) return std::make_shared<InterleavedSliceData>(0, 0, 0);
+
+    const int width = m_volumes[0]->inlineSize();
+    return readSlice({ 0, xlineIndex, zStartIndex }, { width, 1, zSize }, width, zSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<InterleavedSliceData> MultiVolumeReader::zSlice(int zIndex) const
+{
+    if (m_volumes.empty()) return std::make_shared<InterleavedSliceData>(0, 0, 0);
+
+    const int widthI = m_volumes[0]->inlineSize();
+    const int widthX = m_volumes[0]->xlineSize();
+    return readSlice({ 0, 0, zIndex }, { widthI, widthX, 1 }, widthI, widthX);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<InterleavedSliceData> MultiVolumeReader::readSlice(std::array<int, 3> start, std::array<int, 3> size, int width, int depth) const
+{
+    auto retData = std::make_shared<InterleavedSliceData>(width, depth, volumeCount());
+    if (retData->isOutOfMemory()) return retData;
+    if (!readInterleaved(start, size, retData->values())) return std::make_shared<InterleavedSliceData>(0, 0, 0);
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read a box from every volume into one buffer with z fastest and the volumes interleaved per
+/// sample. The box is split into brick tiles read in parallel, and each tile is scattered into the
+/// output while it is still in cache, so there is no separate interleave pass.
+//--------------------------------------------------------------------------------------------------
+bool MultiVolumeReader::readInterleaved(std::array<int, 3> start, std::array<int, 3> size, float* values) const
+{
+    if (!isCompatible() || (values == nullptr)) return false;
+
+    const auto volumeSize = m_volumes[0]->sizeAtLod(0);
+
+    for (int d = 0; d < 3; d++)
+    {
+        if ((start[d] < 0) || (size[d] <= 0) || (start[d] + size[d] > volumeSize[d])) return false;
+    }
+
+    // tiles follow the brick grid of the first volume
+    const auto bricksize = m_volumes[0]->brickSize();
+    std::array<int, 3> firstBrick;
+    std::array<int, 3> tileCount;
+    for (int d = 0; d < 3; d++)
+    {
+        firstBrick[d] = start[d] / bricksize[d];
+        tileCount[d] = (start[d] + size[d] - 1) / bricksize[d] - firstBrick[d] + 1;
+    }
+
+    const int nTiles = tileCount[0] * tileCount[1] * tileCount[2];
+    const int nChannels = volumeCount();
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < nTiles; t++)
+    {
+        if (failed) continue;
+
+        const std::array<int, 3> tile = { t / (tileCount[1] * tileCount[2]), (t / tileCount[2]) % tileCount[1], t % tileCount[2] };
+
+        std::array<int, 3> tileStart;
+        std::array<int, 3> tileSize;
+        for (int d = 0; d < 3; d++)
+        {
+            tileStart[d] = std::max(start[d], (firstBrick[d] + tile[d]) * bricksize[d]);
+            tileSize[d] = std::min(start[d] + size[d], (firstBrick[d] + tile[d] + 1) * bricksize[d]) - tileStart[d];
+        }
+
+        std::vector<float> buffer((size_t)tileSize[0] * tileSize[1] * tileSize[2]);
+
+        // all channels of a tile on the same thread, so threads never share output cache lines
+        for (int c = 0; c < nChannels; c++)
+        {
+            if (!m_volumes[c]->readVolume(0, tileStart, tileSize, buffer.data()))
+            {
+                failed = true;
+                break;
+            }
+
+            const float* src = buffer.data();
+            for (int i = 0; i < tileSize[0]; i++)
+            {
+                for (int j = 0; j < tileSize[1]; j++)
+                {
+                    const size_t offset = ((size_t)(tileStart[0] - start[0] + i) * size[1] + (tileStart[1] - start[1] + j)) * size[2] + (tileStart[2] - start[2]);
+                    float* dst = values + offset * nChannels + c;
+                    for (int k = 0; k < tileSize[2]; k++)
+                    {
+                        dst[(size_t)k * nChannels] = *src++;
+                    }
+                }
+            }
+        }
+    }
+
+    return !failed;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The brick columns (inline and crossline brick numbers) that have at least one trace inside
+/// the mask.
+//--------------------------------------------------------------------------------------------------
+std::vector<std::array<int, 2>> MultiVolumeReader::maskedBrickColumns(const OutlineMask& mask) const
+{
+    std::vector<std::array<int, 2>> retval;
+
+    if (!isCompatible()) return retval;
+
+    const int widthI = m_volumes[0]->inlineSize();
+    const int widthX = m_volumes[0]->xlineSize();
+    if ((mask.inlineSize() != widthI) || (mask.xlineSize() != widthX)) return retval;
+
+    const auto bricksize = m_volumes[0]->brickSize();
+
+    for (int i0 = 0; i0 < widthI; i0 += bricksize[0])
+    {
+        for (int j0 = 0; j0 < widthX; j0 += bricksize[1])
+        {
+            if (mask.coverage(i0, bricksize[0], j0, bricksize[1]) == OutlineMask::Coverage::Outside) continue;
+
+            retval.push_back({ i0 / bricksize[0], j0 / bricksize[1] });
+        }
+    }
+
+    return retval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read one brick column from all volumes, one brick at a time in z, and pass the interleaved
+/// samples inside the mask to the callback together with the number of samples (not values).
+//--------------------------------------------------------------------------------------------------
+bool MultiVolumeReader::readMaskedColumn(const OutlineMask& mask, std::array<int, 2> column, int zStartIndex, int zSize, const std::function<void(const float*, size_t)>& callback) const
+{
+    if (!isCompatible()) return false;
+
+    const auto bricksize = m_volumes[0]->brickSize();
+    const int nChannels = volumeCount();
+
+    const int i0 = column[0] * bricksize[0];
+    const int j0 = column[1] * bricksize[1];
+    const int ni = std::min(bricksize[0], m_volumes[0]->inlineSize() - i0);
+    const int nj = std::min(bricksize[1], m_volumes[0]->xlineSize() - j0);
+
+    const int zStart = std::max(0, zStartIndex);
+    const int zEnd = std::min(m_volumes[0]->zSize(), zStartIndex + zSize);
+
+    const bool allInside = (mask.coverage(i0, ni, j0, nj) == OutlineMask::Coverage::Inside);
+
+    std::vector<float> buffer;
+
+    for (int z0 = zStart; z0 < zEnd; z0 = (z0 / bricksize[2] + 1) * bricksize[2])
+    {
+        const int nz = std::min((z0 / bricksize[2] + 1) * bricksize[2], zEnd) - z0;
+
+        buffer.resize((size_t)ni * nj * nz * nChannels);
+        if (!readInterleaved({ i0, j0, z0 }, { ni, nj, nz }, buffer.data())) return false;
+
+        if (allInside)
+        {
+            callback(buffer.data(), (size_t)ni * nj * nz);
+            continue;
+        }
+
+        for (int i = 0; i < ni; i++)
+        {
+            for (auto& [first, last] : mask.spans(i0 + i))
+            {
+                const int lo = std::max(first, j0);
+                const int hi = std::min(last, j0 + nj - 1);
+                if (hi < lo) continue;
+
+                callback(buffer.data() + ((size_t)i * nj + (lo - j0)) * nz * nChannels, (size_t)(hi - lo + 1) * nz);
+            }
+        }
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,203 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_outlinemask.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+OutlineMask::OutlineMask()
+    : m_inlineSize(0)
+    , m_xlineSize(0)
+    , m_traceCount(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Mask of the traces of the survey whose positions are inside the world coordinate polygon.
+//--------------------------------------------------------------------------------------------------
+OutlineMask::OutlineMask(const ZGYReader& reader, const Outline& worldOutline)
+    : m_inlineSize(reader.inlineSize())
+    , m_xlineSize(reader.xlineSize())
+    , m_traceCount(0)
+{
+    std::vector<std::pair<double, double>> polygon;
+    for (auto& p : worldOutline.points())
+    {
+        polygon.push_back(reader.toInlineXlineIndex(p.x(), p.y()));
+    }
+
+    buildSpans(polygon);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Mask from a polygon given directly in inline (x) and crossline (y) index coordinates.
+//--------------------------------------------------------------------------------------------------
+OutlineMask::OutlineMask(int inlineSize, int xlineSize, const Outline& indexOutline)
+    : m_inlineSize(inlineSize)
+    , m_xlineSize(xlineSize)
+    , m_traceCount(0)
+{
+    std::vector<std::pair<double, double>> polygon;
+    for (auto& p : indexOutline.points())
+    {
+        polygon.push_back(std::make_pair(p.x(), p.y()));
+    }
+
+    buildSpans(polygon);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+OutlineMask::~OutlineMask()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Scan convert the polygon, one inline at a time. A trace is inside if its centre is inside the
+/// polygon by the even-odd rule. Each inline gets a sorted list of inclusive crossline spans.
+//--------------------------------------------------------------------------------------------------
+void OutlineMask::buildSpans(const std::vector<std::pair<double, double>>& polygon)
+{
+    m_spans.assign(std::max(0, m_inlineSize), {});
+    m_traceCount = 0;
+
+    const int nPoints = (int)polygon.size();
+    if ((nPoints < 3) || (m_xlineSize <= 0)) return;
+
+    std::vector<double> crossings;
+
+    for (int il = 0; il < m_inlineSize; il++)
+    {
+        crossings.clear();
+
+        for (int p = 0; p < nPoints; p++)
+        {
+            const auto& [u0, v0] = polygon[p];
+            const auto& [u1, v1] = polygon[(p + 1) % nPoints];
+
+            // half open test so that a vertex exactly on the inline is only counted once
+            if ((u0 <= il) == (u1 <= il)) continue;
+
+            crossings.push_back(v0 + (il - u0) * (v1 - v0) / (u1 - u0));
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+
+        auto& rowSpans = m_spans[il];
+        for (size_t c = 0; c + 1 < crossings.size(); c += 2)
+        {
+            const int first = std::max(0, (int)std::ceil(crossings[c]));
+            const int last = std::min(m_xlineSize - 1, (int)std::floor(crossings[c + 1]));
+            if (last < first) continue;
+
+            rowSpans.push_back(std::make_pair(first, last));
+            m_traceCount += last - first + 1;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int OutlineMask::inlineSize() const
+{
+    return m_inlineSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int OutlineMask::xlineSize() const
+{
+    return m_xlineSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool OutlineMask::isEmpty() const
+{
+    return m_traceCount == 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t OutlineMask::traceCount() const
+{
+    return m_traceCount;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const std::vector<std::pair<int, int>>& OutlineMask::spans(int inlineIndex) const
+{
+    static const std::vector<std::pair<int, int>> noSpans;
+
+    if ((inlineIndex < 0) || (inlineIndex >= (int)m_spans.size())) return noSpans;
+
+    return m_spans[inlineIndex];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool OutlineMask::isInside(int inlineIndex, int xlineIndex) const
+{
+    for (auto& [first, last] : spans(inlineIndex))
+    {
+        if (xlineIndex < first) return false;
+        if (xlineIndex <= last) return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// How much of the box of traces is inside the mask. Used to skip bricks that are fully outside
+/// and to avoid per trace tests for bricks that are fully inside.
+//--------------------------------------------------------------------------------------------------
+OutlineMask::Coverage OutlineMask::coverage(int inlineStart, int inlineSize, int xlineStart, int xlineSize) const
+{
+    std::int64_t nInside = 0;
+
+    const int xlineEnd = xlineStart + xlineSize - 1;
+    for (int il = inlineStart; il < inlineStart + inlineSize; il++)
+    {
+        for (auto& [first, last] : spans(il))
+        {
+            const int lo = std::max(first, xlineStart);
+            const int hi = std::min(last, xlineEnd);
+            if (hi >= lo) nInside += hi - lo + 1;
+        }
+    }
+
+    if (nInside == 0) return Coverage::Outside;
+    if (nInside == (std::int64_t)inlineSize * xlineSize) return Coverage::Inside;
+    return Coverage::Partial;
+}
+
+}
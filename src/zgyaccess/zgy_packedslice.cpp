@@ -0,0 +1,474 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_packedslice.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    std::uint32_t floatBits(float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    float bitsFloat(std::uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    template <typename T>
+    void packNormalised(const float* values, size_t nValues, float minValue, float maxValue, T* output)
+    {
+        const float maxCode = (float)std::numeric_limits<T>::max();
+        const float scale = (maxValue > minValue) ? maxCode / (maxValue - minValue) : 0.0f;
+
+        for (size_t n = 0; n < nValues; n++)
+        {
+            // NaN fails both comparisons of the clamp and is stored as 0
+            float code = (values[n] - minValue) * scale + 0.5f;
+            code = (code > 0.0f) ? code : 0.0f;
+            code = (code < maxCode) ? code : maxCode;
+            output[n] = (T)code;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// IEEE half precision with round to nearest even. Written with selects instead of branches so the
+/// loops calling it vectorise. Values too large for half become infinity, and NaN stays NaN.
+//--------------------------------------------------------------------------------------------------
+std::uint16_t PackedSliceData::toFloat16(float value)
+{
+    const std::uint32_t bits = floatBits(value);
+    const std::uint32_t sign = (bits >> 16) & 0x8000;
+    const std::uint32_t magnitude = bits & 0x7fffffff;
+
+    // normal halves: rebias the exponent and round the 13 dropped mantissa bits to even
+    const std::uint32_t normal = (magnitude + ((std::uint32_t)(15 - 127) << 23) + 0xfff + ((magnitude >> 13) & 1)) >> 13;
+
+    // subnormal halves: let the float adder do the shift and the rounding
+    const std::uint32_t denormMagic = (std::uint32_t)((127 - 15) + (23 - 10) + 1) << 23;
+    const std::uint32_t subnormal = floatBits(bitsFloat(magnitude) + bitsFloat(denormMagic)) - denormMagic;
+
+    const std::uint32_t overflow = (magnitude > 0x7f800000) ? 0x7e00 : 0x7c00;
+
+    std::uint32_t half = (magnitude < (113u << 23)) ? subnormal : normal;
+    half = (magnitude >= ((127u + 16) << 23)) ? overflow : half;
+
+    return (std::uint16_t)(half | sign);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+float PackedSliceData::fromFloat16(std::uint16_t value)
+{
+    const std::uint32_t sign = (std::uint32_t)(value & 0x8000) << 16;
+    const std::uint32_t exponent = (value >> 10) & 0x1f;
+    const std::uint32_t mantissa = value & 0x3ff;
+
+    if (exponent == 0)
+    {
+        return bitsFloat(sign) + (sign ? -1.0f : 1.0f) * std::ldexp((float)mantissa, -24);
+    }
+    if (exponent == 31)
+    {
+        return bitsFloat(sign | 0x7f800000 | (mantissa << 13));
+    }
+
+    return bitsFloat(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The upper half of a float with round to nearest even, keeping NaN a quiet NaN.
+//--------------------------------------------------------------------------------------------------
+std::uint16_t PackedSliceData::toBFloat16(float value)
+{
+    const std::uint32_t bits = floatBits(value);
+    const std::uint32_t rounded = (bits + 0x7fff + ((bits >> 16) & 1)) >> 16;
+    const bool isNan = (bits & 0x7fffffff) > 0x7f800000;
+
+    return (std::uint16_t)(isNan ? ((bits >> 16) | 0x40) : rounded);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+float PackedSliceData::fromBFloat16(std::uint16_t value)
+{
+    return bitsFloat((std::uint32_t)value << 16);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Number of bytes of one sample in the given format.
+//--------------------------------------------------------------------------------------------------
+int PackedSliceData::bytesPerSample(PackedSampleFormat format)
+{
+    return (format == PackedSampleFormat::UInt8) ? 1 : 2;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Convert floats to the packed format. The range is only used by the normalised formats.
+//--------------------------------------------------------------------------------------------------
+void PackedSliceData::pack(const float* values, size_t nValues, PackedSampleFormat format, float minValue, float maxValue, std::uint8_t* output)
+{
+    std::uint16_t* output16 = reinterpret_cast<std::uint16_t*>(output);
+
+    switch (format)
+    {
+    case PackedSampleFormat::Float16:
+        for (size_t n = 0; n < nValues; n++)
+        {
+            output16[n] = toFloat16(values[n]);
+        }
+        break;
+    case PackedSampleFormat::BFloat16:
+        for (size_t n = 0; n < nValues; n++)
+        {
+            output16[n] = toBFloat16(values[n]);
+        }
+        break;
+    case PackedSampleFormat::UInt16:
+        packNormalised(values, nValues, minValue, maxValue, output16);
+        break;
+    case PackedSampleFormat::UInt8:
+        packNormalised(values, nValues, minValue, maxValue, output);
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// One sample converted back to float.
+//--------------------------------------------------------------------------------------------------
+float PackedSliceData::unpack(const std::uint8_t* data, size_t index, PackedSampleFormat format, float minValue, float maxValue)
+{
+    std::uint16_t value16 = 0;
+    if (format != PackedSampleFormat::UInt8) std::memcpy(&value16, data + index * 2, sizeof(value16));
+
+    switch (format)
+    {
+    case PackedSampleFormat::Float16:
+        return fromFloat16(value16);
+    case PackedSampleFormat::BFloat16:
+        return fromBFloat16(value16);
+    case PackedSampleFormat::UInt16:
+        return minValue + value16 * (maxValue - minValue) / 65535.0f;
+    case PackedSampleFormat::UInt8:
+        return minValue + data[index] * (maxValue - minValue) / 255.0f;
+    }
+
+    return 0.0f;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+PackedSliceData::PackedSliceData(int width, int depth, PackedSampleFormat format, float minValue, float maxValue)
+    : m_width(width)
+    , m_depth(depth)
+    , m_format(format)
+    , m_minValue(minValue)
+    , m_maxValue(maxValue)
+    , m_outOfMemory(false)
+{
+    const std::int64_t size = (std::int64_t)width * depth;
+    bool allocated = false;
+
+    // counted against the memory budget as slice data, and left empty and flagged when refused
+    if ((width >= 0) && (depth >= 0) && (size <= std::numeric_limits<int>::max()))
+    {
+        const std::int64_t bytes = size * bytesPerSample(format);
+        m_reservation = std::make_unique<MemoryReservation>(MemoryCategory::SliceData, bytes);
+
+        try
+        {
+            if (m_reservation->isValid())
+            {
+                m_data.resize((size_t)bytes);
+                allocated = true;
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+    }
+
+    if (!allocated)
+    {
+        m_reservation.reset();
+        m_width = 0;
+        m_depth = 0;
+        m_outOfMemory = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+PackedSliceData::~PackedSliceData()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint8_t* PackedSliceData::data()
+{
+    return m_data.data();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t PackedSliceData::byteSize() const
+{
+    return m_data.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+float PackedSliceData::valueAt(int width, int depth) const
+{
+    if ((width < 0) || (width >= m_width) || (depth < 0) || (depth >= m_depth)) return 0.0f;
+
+    return unpack(m_data.data(), (size_t)width * m_depth + depth, m_format, m_minValue, m_maxValue);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int PackedSliceData::size() const
+{
+    return m_width * m_depth;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int PackedSliceData::width() const
+{
+    return m_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int PackedSliceData::depth() const
+{
+    return m_depth;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+PackedSampleFormat PackedSliceData::format() const
+{
+    return m_format;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::pair<float, float> PackedSliceData::valueRange() const
+{
+    return { m_minValue, m_maxValue };
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool PackedSliceData::isEmpty() const
+{
+    return size() == 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool PackedSliceData::isOutOfMemory() const
+{
+    return m_outOfMemory;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The normalised formats use the data range of the file unless another range is set.
+//--------------------------------------------------------------------------------------------------
+PackedSliceReader::PackedSliceReader(std::shared_ptr<ZGYReader> reader, PackedSampleFormat format)
+    : m_reader(reader)
+    , m_format(format)
+    , m_minValue(0.0f)
+    , m_maxValue(0.0f)
+{
+    if (m_reader != nullptr)
+    {
+        const auto [minVal, maxVal] = m_reader->dataRange();
+        m_minValue = (float)minVal;
+        m_maxValue = (float)maxVal;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+PackedSliceReader::~PackedSliceReader()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void PackedSliceReader::setValueRange(float minValue, float maxValue)
+{
+    m_minValue = minValue;
+    m_maxValue = maxValue;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<PackedSliceData> PackedSliceReader::inlineSlice(int inlineIndex, int zStartIndex, int zSize) const
+{
+    if (m_reader == nullptr) return std::make_shared<PackedSliceData>(0, 0, m_format, m_minValue, m_maxValue);
+
+    const int width = m_reader->xlineSize();
+    return readSlice({ inlineIndex, 0, zStartIndex }, { 1, width, zSize }, width, zSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<PackedSliceData> PackedSliceReader::xlineSlice(int xlineIndex, int zStartIndex, int zSize) const
+{
+    if (m_reader == nullptr) return std::make_shared<PackedSliceData>(0, 0, m_format, m_minValue, m_maxValue);
+
+    const int width = m_reader->inlineSize();
+    return readSlice({ 0, xlineIndex, zStartIndex }, { width, 1, zSize }, width, zSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<PackedSliceData> PackedSliceReader::zSlice(int zIndex) const
+{
+    if (m_reader == nullptr) return std::make_shared<PackedSliceData>(0, 0, m_format, m_minValue, m_maxValue);
+
+    const int widthI = m_reader->inlineSize();
+    const int widthX = m_reader->xlineSize();
+    return readSlice({ 0, 0, zIndex }, { widthI, widthX, 1 }, widthI, widthX);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<PackedSliceData> PackedSliceReader::readSlice(std::array<int, 3> start, std::array<int, 3> size, int width, int depth) const
+{
+    auto retData = std::make_shared<PackedSliceData>(width, depth, m_format, m_minValue, m_maxValue);
+    if (retData->isOutOfMemory()) return retData;
+    if (!readVolume(start, size, retData->data())) return std::make_shared<PackedSliceData>(0, 0, m_format, m_minValue, m_maxValue);
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read a box into the packed format, z fastest. Brick sized tiles are read in parallel into small
+/// float buffers and packed into place, runs of samples at a time.
+//--------------------------------------------------------------------------------------------------
+bool PackedSliceReader::readVolume(std::array<int, 3> start, std::array<int, 3> size, std::uint8_t* output) const
+{
+    if ((m_reader == nullptr) || (output == nullptr)) return false;
+
+    const auto volumeSize = m_reader->sizeAtLod(0);
+    for (int d = 0; d < 3; d++)
+    {
+        if ((start[d] < 0) || (size[d] <= 0) || (start[d] + size[d] > volumeSize[d])) return false;
+    }
+
+    const auto bricksize = m_reader->brickSize();
+    std::array<int, 3> firstBrick;
+    std::array<int, 3> tileCount;
+    for (int d = 0; d < 3; d++)
+    {
+        firstBrick[d] = start[d] / bricksize[d];
+        tileCount[d] = (start[d] + size[d] - 1) / bricksize[d] - firstBrick[d] + 1;
+    }
+
+    const int nTiles = tileCount[0] * tileCount[1] * tileCount[2];
+    const int bytes = PackedSliceData::bytesPerSample(m_format);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < nTiles; t++)
+    {
+        if (failed) continue;
+
+        const std::array<int, 3> tile = { t / (tileCount[1] * tileCount[2]), (t / tileCount[2]) % tileCount[1], t % tileCount[2] };
+
+        std::array<int, 3> tileStart;
+        std::array<int, 3> tileSize;
+        for (int d = 0; d < 3; d++)
+        {
+            tileStart[d] = std::max(start[d], (firstBrick[d] + tile[d]) * bricksize[d]);
+            tileSize[d] = std::min(start[d] + size[d], (firstBrick[d] + tile[d] + 1) * bricksize[d]) - tileStart[d];
+        }
+
+        std::vector<float> buffer((size_t)tileSize[0] * tileSize[1] * tileSize[2]);
+        if (!m_reader->readVolume(0, tileStart, tileSize, buffer.data()))
+        {
+            failed = true;
+            continue;
+        }
+
+        // when the tile covers the whole z range of the box, its crossline rows are contiguous in
+        // the output too, which makes one run per inline (a whole tile row for z slices)
+        const bool fullZ = (tileSize[2] == size[2]);
+        const int runs = fullZ ? 1 : tileSize[1];
+        const size_t runLength = fullZ ? (size_t)tileSize[1] * tileSize[2] : (size_t)tileSize[2];
+
+        const float* src = buffer.data();
+        for (int i = 0; i < tileSize[0]; i++)
+        {
+            for (int r = 0; r < runs; r++)
+            {
+                const size_t offset = ((size_t)(tileStart[0] - start[0] + i) * size[1] + (tileStart[1] - start[1] + r)) * size[2] + (tileStart[2] - start[2]);
+                PackedSliceData::pack(src, runLength, m_format, m_minValue, m_maxValue, output + offset * bytes);
+                src += runLength;
+            }
+        }
+    }
+
+    return !failed;
+}
+
+}
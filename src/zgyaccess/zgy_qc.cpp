@@ -0,0 +1,450 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_qc.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    // an extreme holding this many times more samples than the next value inside it is a clip spike
+    const double clipSpikeRatio = 4.0;
+
+    // the two largest distinct values and how many samples hold each
+    class TopTwo
+    {
+    public:
+        std::array<float, 2> value{ -std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+        std::array<std::int64_t, 2> count{ 0, 0 };
+
+        void add(float v, std::int64_t n)
+        {
+            if (n == 0) return;
+
+            if (v == value[0])
+            {
+                count[0] += n;
+            }
+            else if (v > value[0])
+            {
+                value[1] = value[0];
+                count[1] = count[0];
+                value[0] = v;
+                count[0] = n;
+            }
+            else if (v == value[1])
+            {
+                count[1] += n;
+            }
+            else if (v > value[1])
+            {
+                value[1] = v;
+                count[1] = n;
+            }
+        }
+
+        // the two largest values of a union are among the two largest of each part
+        void merge(const TopTwo& other)
+        {
+            add(other.value[0], other.count[0]);
+            add(other.value[1], other.count[1]);
+        }
+    };
+
+    class ScanResult
+    {
+    public:
+        SampleStatistics stats;
+        std::int64_t nanCount = 0;
+        std::int64_t infCount = 0;
+        // largest values, and largest negated values for the minimum side
+        TopTwo highest;
+        TopTwo lowest;
+
+        // three passes over data already in cache, all free of branches so the compiler can vectorize them
+        void addSamples(const float* values, size_t nValues)
+        {
+            const float inf = std::numeric_limits<float>::infinity();
+
+            std::int64_t nans = 0;
+            std::int64_t infs = 0;
+            float minVal = inf;
+            float maxVal = -inf;
+            double localSum = 0.0;
+            double localSumSquares = 0.0;
+
+            for (size_t i = 0; i < nValues; i++)
+            {
+                const float value = values[i];
+                const bool isNan = (value != value);
+                const bool isInf = (std::abs(value) == inf);
+                const bool isFinite = !isNan && !isInf;
+                const float finite = isFinite ? value : 0.0f;
+
+                nans += isNan;
+                infs += isInf;
+                minVal = std::min(minVal, isFinite ? value : inf);
+                maxVal = std::max(maxVal, isFinite ? value : -inf);
+                localSum += finite;
+                localSumSquares += (double)finite * finite;
+            }
+
+            // the values next to the extremes, NaN and infinity fail both comparisons
+            float nextMin = inf;
+            float nextMax = -inf;
+            for (size_t i = 0; i < nValues; i++)
+            {
+                const float value = values[i];
+                nextMin = std::min(nextMin, ((value > minVal) && (value < inf)) ? value : inf);
+                nextMax = std::max(nextMax, ((value < maxVal) && (value > -inf)) ? value : -inf);
+            }
+
+            std::int64_t atMin = 0;
+            std::int64_t atMax = 0;
+            std::int64_t atNextMin = 0;
+            std::int64_t atNextMax = 0;
+            for (size_t i = 0; i < nValues; i++)
+            {
+                atMin += (values[i] == minVal);
+                atMax += (values[i] == maxVal);
+                atNextMin += (values[i] == nextMin);
+                atNextMax += (values[i] == nextMax);
+            }
+
+            ScanResult local;
+            local.nanCount = nans;
+            local.infCount = infs;
+            local.stats.count = (std::int64_t)nValues - nans - infs;
+            if (local.stats.count > 0)
+            {
+                local.stats.sum = localSum;
+                local.stats.sumSquares = localSumSquares;
+                local.stats.minValue = minVal;
+                local.stats.maxValue = maxVal;
+                local.highest.add(maxVal, atMax);
+                local.lowest.add(-minVal, atMin);
+                if (nextMax > -inf) local.highest.add(nextMax, atNextMax);
+                if (nextMin < inf) local.lowest.add(-nextMin, atNextMin);
+            }
+            merge(local);
+        }
+
+        void addConstant(float value, std::int64_t nValues)
+        {
+            ScanResult local;
+            if (std::isnan(value))
+                local.nanCount = nValues;
+            else if (std::isinf(value))
+                local.infCount = nValues;
+            else
+            {
+                local.stats.count = nValues;
+                local.stats.sum = (double)value * nValues;
+                local.stats.sumSquares = (double)value * value * nValues;
+                local.stats.minValue = value;
+                local.stats.maxValue = value;
+                local.highest.add(value, nValues);
+                local.lowest.add(-value, nValues);
+            }
+            merge(local);
+        }
+
+        void merge(const ScanResult& other)
+        {
+            highest.merge(other.highest);
+            lowest.merge(other.lowest);
+
+            stats.merge(other.stats);
+            nanCount += other.nanCount;
+            infCount += other.infCount;
+        }
+    };
+
+    class ColumnResult
+    {
+    public:
+        ScanResult scan;
+        std::int64_t zeroTraceCount = 0;
+        std::vector<std::array<int, 2>> zeroTraces;
+    };
+
+    std::string jsonNumber(double value)
+    {
+        if (!std::isfinite(value)) return "null";
+
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.17g", value);
+        return text;
+    }
+
+    std::string jsonBool(bool value)
+    {
+        return value ? "true" : "false";
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Zeroed traces are reported, but do not fail the check since dead traces are often stored as zero.
+//--------------------------------------------------------------------------------------------------
+bool QcReport::passed() const
+{
+    return !readFailed && (nanCount == 0) && (infCount == 0) && !isClipped && dataRangeConsistent && statisticsConsistent && histogramConsistent;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string QcReport::toJson() const
+{
+    std::string json = "{\n";
+
+    json += "  \"passed\": " + jsonBool(passed()) + ",\n";
+    json += "  \"readFailed\": " + jsonBool(readFailed) + ",\n";
+    json += "  \"sampleCount\": " + std::to_string(sampleCount) + ",\n";
+    json += "  \"nanCount\": " + std::to_string(nanCount) + ",\n";
+    json += "  \"infCount\": " + std::to_string(infCount) + ",\n";
+
+    json += "  \"statistics\": { \"count\": " + std::to_string(statistics.count) + ", \"min\": " + jsonNumber(statistics.minValue) +
+            ", \"max\": " + jsonNumber(statistics.maxValue) + ", \"mean\": " + jsonNumber(statistics.mean()) + ", \"rms\": " + jsonNumber(statistics.rms()) + " },\n";
+
+    json += "  \"clipping\": { \"clipped\": " + jsonBool(isClipped) + ", \"minValueCount\": " + std::to_string(minValueCount) +
+            ", \"maxValueCount\": " + std::to_string(maxValueCount) + ", \"minNeighbourCount\": " + std::to_string(minNeighbourCount) +
+            ", \"maxNeighbourCount\": " + std::to_string(maxNeighbourCount) + " },\n";
+
+    json += "  \"traces\": { \"count\": " + std::to_string(traceCount) + ", \"zeroCount\": " + std::to_string(zeroTraceCount) + ", \"zero\": [";
+    for (size_t n = 0; n < zeroTraces.size(); n++)
+    {
+        json += (n > 0 ? ", [" : "[") + std::to_string(zeroTraces[n][0]) + ", " + std::to_string(zeroTraces[n][1]) + "]";
+    }
+    json += "] },\n";
+
+    json += "  \"dataRange\": { \"consistent\": " + jsonBool(dataRangeConsistent) + ", \"stored\": [" + jsonNumber(storedDataRange.first) + ", " +
+            jsonNumber(storedDataRange.second) + "] },\n";
+
+    json += "  \"storedStatistics\": { \"consistent\": " + jsonBool(statisticsConsistent) + ", \"count\": " + std::to_string(storedStatistics.count) +
+            ", \"min\": " + jsonNumber(storedStatistics.minValue) + ", \"max\": " + jsonNumber(storedStatistics.maxValue) +
+            ", \"mean\": " + jsonNumber(storedStatistics.mean()) + " },\n";
+
+    json += "  \"storedHistogram\": { \"consistent\": " + jsonBool(histogramConsistent) + ", \"count\": " + std::to_string(storedHistogramCount) +
+            ", \"mean\": " + jsonNumber(storedHistogramMean) + " }\n";
+
+    json += "}\n";
+    return json;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+QcScanner::QcScanner()
+    : m_clipFraction(1e-4)
+    , m_maxReportedTraces(1000)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+QcScanner::~QcScanner()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The volume is reported as clipped when more than this fraction of the samples sit exactly at
+/// the minimum or maximum value, and that value holds several times more samples than the next
+/// value inside it.
+//--------------------------------------------------------------------------------------------------
+void QcScanner::setClipFraction(double fraction)
+{
+    m_clipFraction = fraction;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void QcScanner::setMaxReportedTraces(int count)
+{
+    m_maxReportedTraces = std::max(0, count);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Scan every full resolution sample, one brick column per task. Bricks stored as constants are
+/// accounted for without decoding them.
+//--------------------------------------------------------------------------------------------------
+QcReport QcScanner::scan(ZGYReader& reader) const
+{
+    QcReport report;
+
+    const auto size = reader.sizeAtLod(0);
+    if ((size[0] <= 0) || (size[1] <= 0) || (size[2] <= 0))
+    {
+        report.readFailed = true;
+        return report;
+    }
+
+    const auto bricksize = reader.brickSize();
+    const int nColumnsI = (size[0] + bricksize[0] - 1) / bricksize[0];
+    const int nColumnsJ = (size[1] + bricksize[1] - 1) / bricksize[1];
+    const int nColumns = nColumnsI * nColumnsJ;
+
+    std::vector<ColumnResult> results(nColumns);
+    std::atomic<bool> readFailed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nColumns; c++)
+    {
+        if (readFailed) continue;
+
+        const int i0 = (c / nColumnsJ) * bricksize[0];
+        const int j0 = (c % nColumnsJ) * bricksize[1];
+        const int ni = std::min(bricksize[0], size[0] - i0);
+        const int nj = std::min(bricksize[1], size[1] - j0);
+
+        auto& result = results[c];
+        std::vector<char> allZero((size_t)ni * nj, 1);
+        std::vector<float> buffer;
+
+        for (int k0 = 0; k0 < size[2]; k0 += bricksize[2])
+        {
+            const int nk = std::min(bricksize[2], size[2] - k0);
+            const std::int64_t nSamples = (std::int64_t)ni * nj * nk;
+
+            float constValue = 0.0f;
+            if (reader.isConstant(0, { i0, j0, k0 }, { ni, nj, nk }, constValue))
+            {
+                result.scan.addConstant(constValue, nSamples);
+                if (constValue != 0.0f) std::fill(allZero.begin(), allZero.end(), 0);
+                continue;
+            }
+
+            buffer.resize(nSamples);
+            if (!reader.readVolume(0, { i0, j0, k0 }, { ni, nj, nk }, buffer.data()))
+            {
+                readFailed = true;
+                break;
+            }
+
+            result.scan.addSamples(buffer.data(), buffer.size());
+
+            for (int t = 0; t < ni * nj; t++)
+            {
+                if (!allZero[t]) continue;
+
+                const float* trace = buffer.data() + (size_t)t * nk;
+                allZero[t] = std::all_of(trace, trace + nk, [](float v) { return v == 0.0f; });
+            }
+        }
+
+        for (int t = 0; t < ni * nj; t++)
+        {
+            if (!allZero[t]) continue;
+
+            result.zeroTraceCount++;
+            if ((int)result.zeroTraces.size() < m_maxReportedTraces) result.zeroTraces.push_back({ i0 + t / nj, j0 + t % nj });
+        }
+    }
+
+    if (readFailed)
+    {
+        report.readFailed = true;
+        return report;
+    }
+
+    ScanResult total;
+    for (const auto& result : results)
+    {
+        total.merge(result.scan);
+        report.zeroTraceCount += result.zeroTraceCount;
+        report.zeroTraces.insert(report.zeroTraces.end(), result.zeroTraces.begin(), result.zeroTraces.end());
+    }
+
+    std::sort(report.zeroTraces.begin(), report.zeroTraces.end());
+    if ((int)report.zeroTraces.size() > m_maxReportedTraces) report.zeroTraces.resize(m_maxReportedTraces);
+
+    report.sampleCount = (std::int64_t)size[0] * size[1] * size[2];
+    report.traceCount = (std::int64_t)size[0] * size[1];
+    report.nanCount = total.nanCount;
+    report.infCount = total.infCount;
+    report.statistics = total.stats;
+    report.minValueCount = total.lowest.count[0];
+    report.maxValueCount = total.highest.count[0];
+    report.minNeighbourCount = total.lowest.count[1];
+    report.maxNeighbourCount = total.highest.count[1];
+
+    const auto& stats = report.statistics;
+    if (stats.count > 0)
+    {
+        // Integer and quantized volumes that use their full range have many samples at the
+        // extremes, but about as many at the next value inside. Clipping piles samples up at the
+        // extreme, so it must also stand out against its neighbour. A constant volume has no
+        // neighbour and is not clipped.
+        auto isSpike = [&](std::int64_t extremeCount, std::int64_t neighbourCount) {
+            return (neighbourCount > 0) && ((double)extremeCount / stats.count > m_clipFraction) && (extremeCount > clipSpikeRatio * neighbourCount);
+        };
+        report.isClipped = isSpike(report.minValueCount, report.minNeighbourCount) || isSpike(report.maxValueCount, report.maxNeighbourCount);
+    }
+
+    const double scale = std::max({ 1.0, std::abs(stats.minValue), std::abs(stats.maxValue) });
+    const double eps = 1e-6 * scale;
+
+    report.storedDataRange = reader.dataRange();
+    if (stats.count > 0)
+    {
+        report.dataRangeConsistent = (stats.minValue >= report.storedDataRange.first - eps) && (stats.maxValue <= report.storedDataRange.second + eps);
+    }
+
+    report.storedStatistics = reader.storedStatistics();
+    if (report.storedStatistics.count > 0)
+    {
+        const auto& stored = report.storedStatistics;
+        report.statisticsConsistent = (stored.count == stats.count) && (std::abs(stored.minValue - stats.minValue) <= eps) &&
+                                      (std::abs(stored.maxValue - stats.maxValue) <= eps) && (std::abs(stored.mean() - stats.mean()) <= 1e-3 * scale);
+    }
+
+    const auto* histogram = reader.histogram();
+    if ((histogram != nullptr) && !histogram->Yvalues.empty())
+    {
+        double count = 0.0;
+        double weighted = 0.0;
+        for (size_t n = 0; n < histogram->Yvalues.size(); n++)
+        {
+            count += histogram->Yvalues[n];
+            weighted += histogram->Xvalues[n] * histogram->Yvalues[n];
+        }
+
+        report.storedHistogramCount = (std::int64_t)count;
+        report.storedHistogramMean = (count > 0.0) ? weighted / count : 0.0;
+
+        // the mean of the binned values can be off by up to one bin from the sample mean
+        const double binWidth = (histogram->Xvalues.size() > 1) ? histogram->Xvalues[1] - histogram->Xvalues[0] : scale;
+        report.histogramConsistent = (report.storedHistogramCount == stats.count) && (std::abs(report.storedHistogramMean - stats.mean()) <= std::abs(binWidth) + eps);
+    }
+
+    return report;
+}
+
+}
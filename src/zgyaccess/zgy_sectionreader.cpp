@@ -0,0 +1,154 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_sectionreader.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+InlineSectionReader::InlineSectionReader(std::shared_ptr<ZGYReader> reader)
+    : m_reader(reader)
+    , m_inlineIndex(-1)
+    , m_zStart(0)
+    , m_samplesRead(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+InlineSectionReader::~InlineSectionReader()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Forget the previous window, so the next call reads the full window.
+//--------------------------------------------------------------------------------------------------
+void InlineSectionReader::reset()
+{
+    m_slice = nullptr;
+    m_inlineIndex = -1;
+    m_zStart = 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int64_t InlineSectionReader::samplesRead() const
+{
+    return m_samplesRead;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> InlineSectionReader::inlineSlice(int inlineIndex, int zStartIndex, int zSize)
+{
+    m_samplesRead = 0;
+
+    if ((m_reader == nullptr) || (inlineIndex < 0) || (inlineIndex >= m_reader->inlineSize()) || (zStartIndex < 0) || (zSize <= 0) ||
+        (zStartIndex + zSize > m_reader->zSize()))
+    {
+        reset();
+        return std::make_shared<SeismicSliceData>(0, 0);
+    }
+
+    const int width = m_reader->xlineSize();
+    const int shift = zStartIndex - m_zStart;
+
+    const bool canReuse = (m_slice != nullptr) && (m_inlineIndex == inlineIndex) && (m_slice->width() == width) && (m_slice->depth() == zSize) &&
+                          (std::abs(shift) < zSize);
+
+    if (canReuse && (shift == 0)) return m_slice;
+
+    bool ok = false;
+    if (canReuse)
+    {
+        // move the overlapping samples of each trace to their new position, then fill the gap
+        const int overlap = zSize - std::abs(shift);
+        for (int trace = 0; trace < width; trace++)
+        {
+            float* values = m_slice->values() + (size_t)trace * zSize;
+            if (shift > 0)
+                std::memmove(values, values + shift, overlap * sizeof(float));
+            else
+                std::memmove(values - shift, values, overlap * sizeof(float));
+        }
+
+        if (shift > 0)
+            ok = readRange(zStartIndex + overlap, shift, overlap);
+        else
+            ok = readRange(zStartIndex, -shift, 0);
+    }
+    else
+    {
+        if ((m_slice == nullptr) || (m_slice->width() != width) || (m_slice->depth() != zSize)) m_slice = std::make_shared<SeismicSliceData>(width, zSize);
+
+        m_inlineIndex = inlineIndex;
+        ok = !m_slice->isEmpty() && readRange(zStartIndex, zSize, 0);
+    }
+
+    if (!ok)
+    {
+        // a slice refused by the memory governor is handed out so the caller can tell
+        auto refused = ((m_slice != nullptr) && m_slice->isOutOfMemory()) ? m_slice : std::make_shared<SeismicSliceData>(0, 0);
+        reset();
+        return refused;
+    }
+
+    m_zStart = zStartIndex;
+    return m_slice;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read a z range of the current inline into each trace of the slice, starting at zOffset.
+//--------------------------------------------------------------------------------------------------
+bool InlineSectionReader::readRange(int zStartIndex, int zSize, int zOffset)
+{
+    const int width = m_slice->width();
+    const int depth = m_slice->depth();
+
+    // a full window lands directly in the slice, a partial one goes through a buffer
+    if ((zOffset == 0) && (zSize == depth))
+    {
+        if (!m_reader->readVolume(0, { m_inlineIndex, 0, zStartIndex }, { 1, width, zSize }, m_slice->values())) return false;
+    }
+    else
+    {
+        std::vector<float> buffer((size_t)width * zSize);
+        if (!m_reader->readVolume(0, { m_inlineIndex, 0, zStartIndex }, { 1, width, zSize }, buffer.data())) return false;
+
+        for (int trace = 0; trace < width; trace++)
+        {
+            std::copy(buffer.data() + (size_t)trace * zSize, buffer.data() + (size_t)(trace + 1) * zSize, m_slice->values() + (size_t)trace * depth + zOffset);
+        }
+    }
+
+    m_samplesRead = (std::int64_t)width * zSize;
+    return true;
+}
+
+}
@@ -0,0 +1,245 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_segy.h"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    inline std::uint32_t readBigEndian32(const std::uint8_t* data)
+    {
+        return ((std::uint32_t)data[0] << 24) | ((std::uint32_t)data[1] << 16) | ((std::uint32_t)data[2] << 8) | (std::uint32_t)data[3];
+    }
+
+    inline void writeBigEndian32(std::uint8_t* data, std::uint32_t word)
+    {
+        data[0] = (std::uint8_t)(word >> 24);
+        data[1] = (std::uint8_t)(word >> 16);
+        data[2] = (std::uint8_t)(word >> 8);
+        data[3] = (std::uint8_t)word;
+    }
+
+    // IEEE single to IBM single precision, without branches so that the loop can be vectorized.
+    // Zero and denormals become zero, infinities, NaN and values beyond the IBM range saturate.
+    inline std::uint32_t ieeeToIbm(std::uint32_t bits)
+    {
+        const std::uint32_t sign = bits & 0x80000000u;
+        const std::int32_t exponent = (std::int32_t)((bits >> 23) & 0xff);
+        const std::uint32_t fraction = (bits & 0x007fffffu) | 0x00800000u;
+
+        // value = fraction / 2^24 * 2^e2, rewritten as (fraction >> shift) / 2^24 * 16^e16
+        const std::int32_t e2 = exponent - 126;
+        const std::int32_t e16 = (e2 + 3) >> 2;
+        const std::int32_t shift = 4 * e16 - e2;
+        const std::int32_t ibmExponent = e16 + 64;
+
+        const std::uint32_t ibm = sign | ((std::uint32_t)ibmExponent << 24) | (fraction >> shift);
+        const std::uint32_t saturated = sign | 0x7fffffffu;
+
+        return (exponent == 0) ? 0u : (exponent == 255 || ibmExponent > 127) ? saturated : (ibmExponent < 0) ? 0u : ibm;
+    }
+
+    template<typename T>
+    T saturate(float value)
+    {
+        const float rounded = std::nearbyint(value);
+        const float lo = (float)std::numeric_limits<T>::min();
+        const float hi = (float)std::numeric_limits<T>::max();
+        return (rounded >= hi) ? std::numeric_limits<T>::max() : (rounded > lo) ? (T)rounded : std::numeric_limits<T>::min();
+    }
+
+    // 2^(4 * (exponent - 64) - 24) for each IBM exponent, in double as the largest exponents are
+    // beyond the float range even though small mantissas with them are not
+    std::array<double, 128> ibmScaleTable()
+    {
+        std::array<double, 128> table;
+        for (int e = 0; e < 128; e++)
+        {
+            table[e] = std::ldexp(1.0, 4 * (e - 64) - 24);
+        }
+        return table;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int SegyFormat::bytesPerSample(SampleFormat format)
+{
+    switch (format)
+    {
+    case SampleFormat::IbmFloat:
+    case SampleFormat::Int32:
+    case SampleFormat::IeeeFloat:
+        return 4;
+    case SampleFormat::Int16:
+        return 2;
+    case SampleFormat::Int8:
+        return 1;
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SegyFormat::isSupported(int formatCode)
+{
+    return (formatCode == 1) || (formatCode == 2) || (formatCode == 3) || (formatCode == 5) || (formatCode == 8);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int16_t SegyFormat::readInt16(const std::uint8_t* data)
+{
+    return (std::int16_t)(((std::uint16_t)data[0] << 8) | (std::uint16_t)data[1]);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::int32_t SegyFormat::readInt32(const std::uint8_t* data)
+{
+    return (std::int32_t)readBigEndian32(data);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SegyFormat::writeInt16(std::uint8_t* data, std::int16_t value)
+{
+    data[0] = (std::uint8_t)((std::uint16_t)value >> 8);
+    data[1] = (std::uint8_t)value;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SegyFormat::writeInt32(std::uint8_t* data, std::int32_t value)
+{
+    writeBigEndian32(data, (std::uint32_t)value);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Convert big endian SEG-Y samples to native floats.
+//--------------------------------------------------------------------------------------------------
+void SegyFormat::toFloat(const std::uint8_t* data, SampleFormat format, size_t nSamples, float* values)
+{
+    static const std::array<double, 128> ibmScale = ibmScaleTable();
+
+    switch (format)
+    {
+    case SampleFormat::IbmFloat:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            const std::uint32_t word = readBigEndian32(data + 4 * i);
+            // values beyond the float range saturate to infinity
+            const double scaled = (double)(word & 0x00ffffff) * ibmScale[(word >> 24) & 0x7f];
+            const float magnitude = (scaled > std::numeric_limits<float>::max()) ? std::numeric_limits<float>::infinity() : (float)scaled;
+            values[i] = (word & 0x80000000) ? -magnitude : magnitude;
+        }
+        break;
+
+    case SampleFormat::IeeeFloat:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            const std::uint32_t word = readBigEndian32(data + 4 * i);
+            static_assert(sizeof(float) == sizeof(std::uint32_t));
+            std::memcpy(&values[i], &word, sizeof(float));
+        }
+        break;
+
+    case SampleFormat::Int32:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            values[i] = (float)(std::int32_t)readBigEndian32(data + 4 * i);
+        }
+        break;
+
+    case SampleFormat::Int16:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            values[i] = (float)readInt16(data + 2 * i);
+        }
+        break;
+
+    case SampleFormat::Int8:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            values[i] = (float)(std::int8_t)data[i];
+        }
+        break;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Convert native floats to big endian SEG-Y samples. Integer formats are rounded and saturated.
+//--------------------------------------------------------------------------------------------------
+void SegyFormat::fromFloat(const float* values, SampleFormat format, size_t nSamples, std::uint8_t* data)
+{
+    switch (format)
+    {
+    case SampleFormat::IbmFloat:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            writeBigEndian32(data + 4 * i, ieeeToIbm(bits));
+        }
+        break;
+
+    case SampleFormat::IeeeFloat:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            writeBigEndian32(data + 4 * i, bits);
+        }
+        break;
+
+    case SampleFormat::Int32:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            writeBigEndian32(data + 4 * i, (std::uint32_t)saturate<std::int32_t>(values[i]));
+        }
+        break;
+
+    case SampleFormat::Int16:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            writeInt16(data + 2 * i, saturate<std::int16_t>(values[i]));
+        }
+        break;
+
+    case SampleFormat::Int8:
+        for (size_t i = 0; i < nSamples; i++)
+        {
+            data[i] = (std::uint8_t)saturate<std::int8_t>(values[i]);
+        }
+        break;
+    }
+}
+
+}
@@ -0,0 +1,297 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_segyexport.h"
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    // 40 lines of 80 characters, stored as ASCII as allowed by SEG-Y revision 2
+    std::vector<char> textHeader(const ZGYReader& reader, SegyFormat::SampleFormat format)
+    {
+        std::vector<std::string> lines;
+        char line[81];
+
+        lines.push_back("EXPORTED FROM ZGY");
+
+        const int il0 = reader.inlineRange().first;
+        const int xl0 = reader.xlineRange().first;
+        std::snprintf(line, sizeof(line), "INLINES %d-%d STEP %d, CROSSLINES %d-%d STEP %d", il0, il0 + (reader.inlineSize() - 1) * reader.inlineStep(),
+                      reader.inlineStep(), xl0, xl0 + (reader.xlineSize() - 1) * reader.xlineStep(), reader.xlineStep());
+        lines.push_back(line);
+
+        std::snprintf(line, sizeof(line), "SAMPLES %d, START %g, INTERVAL %g, FORMAT CODE %d", reader.zSize(), reader.zRange().first, reader.zStep(), (int)format);
+        lines.push_back(line);
+
+        std::snprintf(line, sizeof(line), "INLINE BYTE %d, CROSSLINE BYTE %d, CDP X BYTE %d, CDP Y BYTE %d", SegyFormat::inlineByte, SegyFormat::xlineByte,
+                      SegyFormat::cdpXByte, SegyFormat::cdpYByte);
+        lines.push_back(line);
+
+        std::vector<char> header(SegyFormat::textHeaderSize, ' ');
+        for (int n = 0; n < 40; n++)
+        {
+            std::string text = (n == 39) ? "END TEXTUAL HEADER" : ((n < (int)lines.size()) ? lines[n] : "");
+            std::snprintf(line, sizeof(line), "C%2d %-75.75s", n + 1, text.c_str());
+            std::copy(line, line + 80, header.begin() + 80 * n);
+        }
+
+        return header;
+    }
+
+    // the largest power of ten, up to 100, that keeps the scaled coordinates within 32 bits
+    std::int16_t coordinateScalar(double maxCoordinate)
+    {
+        if (maxCoordinate * 100.0 < 2.0e9) return -100;
+        if (maxCoordinate * 10.0 < 2.0e9) return -10;
+        return 1;
+    }
+
+    std::int32_t scaleCoordinate(double value, std::int16_t scalar)
+    {
+        return (std::int32_t)std::llround(scalar < 0 ? value * -scalar : value);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SegyExporter::SegyExporter()
+    : m_format(SegyFormat::SampleFormat::IeeeFloat)
+    , m_memoryBudget(std::int64_t(1) << 30)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SegyExporter::~SegyExporter()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SegyExporter::setSampleFormat(SegyFormat::SampleFormat format)
+{
+    m_format = format;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Upper limit for the trace buffers in flight. Two slabs of inlines are in use at any time, one
+/// being filled and one being written.
+//--------------------------------------------------------------------------------------------------
+void SegyExporter::setMemoryBudget(std::int64_t bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string SegyExporter::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write the full resolution volume as a fixed length SEG-Y file, inline by inline.
+//--------------------------------------------------------------------------------------------------
+bool SegyExporter::exportToFile(const ZGYReader& reader, std::string segyFilename)
+{
+    m_errorMessage.clear();
+
+    const int ni = reader.inlineSize();
+    const int nj = reader.xlineSize();
+    const int nk = reader.zSize();
+
+    if ((ni <= 0) || (nj <= 0) || (nk <= 0))
+    {
+        m_errorMessage = "No volume to export";
+        return false;
+    }
+
+    if (nk > 32767)
+    {
+        m_errorMessage = "Too many samples per trace for SEG-Y";
+        return false;
+    }
+
+    // vertical unit is assumed to be ms or m, stored as us or mm
+    const long sampleInterval = std::lround(reader.zStep() * 1000.0);
+    if ((sampleInterval <= 0) || (sampleInterval > 65535))
+    {
+        m_errorMessage = "Sample interval can not be represented in SEG-Y";
+        return false;
+    }
+
+    const std::int16_t delay = (std::int16_t)std::clamp<long>(std::lround(reader.zRange().first), -32768, 32767);
+
+    const int bytesPerSample = SegyFormat::bytesPerSample(m_format);
+    const size_t traceBytes = SegyFormat::traceHeaderSize + (size_t)nk * bytesPerSample;
+
+    // the world coordinates are affine in the annotation, so three lookups give the whole grid
+    const int il0 = reader.inlineRange().first;
+    const int xl0 = reader.xlineRange().first;
+    const int ilStep = reader.inlineStep();
+    const int xlStep = reader.xlineStep();
+
+    const auto origin = reader.toWorldCoordinate(il0, xl0);
+    const auto alongInline = reader.toWorldCoordinate(il0 + ilStep, xl0);
+    const auto alongXline = reader.toWorldCoordinate(il0, xl0 + xlStep);
+
+    const std::array<double, 2> di = { alongInline.first - origin.first, alongInline.second - origin.second };
+    const std::array<double, 2> dj = { alongXline.first - origin.first, alongXline.second - origin.second };
+
+    double maxCoordinate = 0.0;
+    for (int ci : { 0, ni - 1 })
+    {
+        for (int cj : { 0, nj - 1 })
+        {
+            maxCoordinate = std::max(maxCoordinate, std::abs(origin.first + di[0] * ci + dj[0] * cj));
+            maxCoordinate = std::max(maxCoordinate, std::abs(origin.second + di[1] * ci + dj[1] * cj));
+        }
+    }
+    const std::int16_t scalar = coordinateScalar(maxCoordinate);
+
+    std::ofstream file(segyFilename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        m_errorMessage = "Could not create " + segyFilename;
+        return false;
+    }
+
+    // a partially written file is not left behind for someone to mistake for a complete export
+    auto fail = [this, &file, &segyFilename](const std::string& message) {
+        m_errorMessage = message;
+        file.close();
+
+        std::error_code ec;
+        std::filesystem::remove(segyFilename, ec);
+
+        return false;
+    };
+
+    const auto text = textHeader(reader, m_format);
+    file.write(text.data(), text.size());
+
+    std::vector<std::uint8_t> binary(SegyFormat::binaryHeaderSize, 0);
+    const int binaryStart = SegyFormat::textHeaderSize;
+    SegyFormat::writeInt16(binary.data() + SegyFormat::sampleIntervalOffset - binaryStart, (std::int16_t)(std::uint16_t)sampleInterval);
+    SegyFormat::writeInt16(binary.data() + SegyFormat::sampleCountOffset - binaryStart, (std::int16_t)nk);
+    SegyFormat::writeInt16(binary.data() + SegyFormat::sampleFormatOffset - binaryStart, (std::int16_t)m_format);
+    SegyFormat::writeInt16(binary.data() + SegyFormat::revisionOffset - binaryStart, 0x0200);
+    SegyFormat::writeInt16(binary.data() + SegyFormat::fixedLengthOffset - binaryStart, 1);
+    file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+
+    // slabs of whole inlines, so that each slab is one contiguous write. A full brick row of inlines
+    // is used when it fits in half the budget, otherwise bricks are decoded once per slab they touch.
+    const auto bricksize = reader.brickSize();
+    const std::int64_t bytesPerInline = (std::int64_t)nj * traceBytes;
+    const int slabInlines = (int)std::clamp<std::int64_t>(m_memoryBudget / 2 / bytesPerInline, 1, bricksize[0]);
+    const int nColumns = (nj + bricksize[1] - 1) / bricksize[1];
+
+    // both slab buffers are reserved up front, so a burst of writers can not exceed the memory budget
+    MemoryReservation reservation(MemoryCategory::WriteBuffers, 2 * slabInlines * bytesPerInline);
+    if (!reservation.isValid()) return fail("Memory budget exceeded");
+
+    std::vector<std::uint8_t> buffers[2];
+    std::future<void> pendingWrite;
+
+    int current = 0;
+    for (int i0 = 0; i0 < ni; i0 += slabInlines)
+    {
+        const int ci = std::min(slabInlines, ni - i0);
+
+        auto& buffer = buffers[current];
+        buffer.assign((size_t)ci * nj * traceBytes, 0);
+
+        std::atomic<bool> readFailed(false);
+
+        // decode and convert one brick column at a time, straight into the trace positions of the slab
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < nColumns; c++)
+        {
+            const int j0 = c * bricksize[1];
+            const int cj = std::min(bricksize[1], nj - j0);
+
+            std::vector<float> samples((size_t)ci * cj * nk);
+            if (!reader.readVolume(0, { i0, j0, 0 }, { ci, cj, nk }, samples.data()))
+            {
+                readFailed = true;
+                continue;
+            }
+
+            for (int i = 0; i < ci; i++)
+            {
+                for (int j = 0; j < cj; j++)
+                {
+                    const int ii = i0 + i;
+                    const int jj = j0 + j;
+                    std::uint8_t* trace = buffer.data() + ((size_t)i * nj + jj) * traceBytes;
+
+                    SegyFormat::writeInt32(trace + SegyFormat::traceSequenceByte - 1, (std::int32_t)((std::int64_t)ii * nj + jj + 1));
+                    SegyFormat::writeInt16(trace + SegyFormat::coordinateScalarByte - 1, scalar);
+                    SegyFormat::writeInt16(trace + SegyFormat::delayTimeByte - 1, delay);
+                    SegyFormat::writeInt16(trace + SegyFormat::traceSampleCountByte - 1, (std::int16_t)nk);
+                    SegyFormat::writeInt16(trace + SegyFormat::traceSampleIntervalByte - 1, (std::int16_t)(std::uint16_t)sampleInterval);
+                    SegyFormat::writeInt32(trace + SegyFormat::cdpXByte - 1, scaleCoordinate(origin.first + di[0] * ii + dj[0] * jj, scalar));
+                    SegyFormat::writeInt32(trace + SegyFormat::cdpYByte - 1, scaleCoordinate(origin.second + di[1] * ii + dj[1] * jj, scalar));
+                    SegyFormat::writeInt32(trace + SegyFormat::inlineByte - 1, il0 + ii * ilStep);
+                    SegyFormat::writeInt32(trace + SegyFormat::xlineByte - 1, xl0 + jj * xlStep);
+
+                    SegyFormat::fromFloat(samples.data() + ((size_t)i * cj + j) * nk, m_format, nk, trace + SegyFormat::traceHeaderSize);
+                }
+            }
+        }
+
+        // the previous slab must be written before its buffer is reused
+        if (pendingWrite.valid()) pendingWrite.get();
+
+        if (readFailed) return fail("Failed to read inlines from index " + std::to_string(i0));
+
+        pendingWrite = std::async(std::launch::async, [&file, &buffer]() {
+            file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        });
+
+        current = 1 - current;
+    }
+
+    if (pendingWrite.valid()) pendingWrite.get();
+
+    file.close();
+    if (!file) return fail("Failed to write " + segyFilename);
+
+    return true;
+}
+
+}
@@ -0,0 +1,414 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_segyimport.h"
+#include "zgyaccess/zgy_segy.h"
+
+#include "zgy_mappedfile.h"
+#include "zgy_slabwriter.h"
+
+#include "exception.h"
+#include "api.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    const int brickSize = 64;
+
+    // grid positions allowed per trace, beyond which the line numbers are taken to be garbage
+    const std::int64_t maxGridPerTrace = 64;
+
+    // Per chunk of traces results of the header scan, merged after the parallel loop
+    class HeaderSummary
+    {
+    public:
+        std::int32_t inlineMin = std::numeric_limits<std::int32_t>::max();
+        std::int32_t inlineMax = std::numeric_limits<std::int32_t>::min();
+        std::int32_t xlineMin = std::numeric_limits<std::int32_t>::max();
+        std::int32_t xlineMax = std::numeric_limits<std::int32_t>::min();
+
+        void merge(const HeaderSummary& other)
+        {
+            inlineMin = std::min(inlineMin, other.inlineMin);
+            inlineMax = std::max(inlineMax, other.inlineMax);
+            xlineMin = std::min(xlineMin, other.xlineMin);
+            xlineMax = std::max(xlineMax, other.xlineMax);
+        }
+    };
+
+    // Sums for a least squares fit of world = a + b * inline + c * xline
+    class AffineSums
+    {
+    public:
+        std::array<double, 6> grid{ 0, 0, 0, 0, 0, 0 };  // n, i, j, ii, ij, jj
+        std::array<double, 3> x{ 0, 0, 0 };             // x, ix, jx
+        std::array<double, 3> y{ 0, 0, 0 };             // y, iy, jy
+
+        void add(double i, double j, double wx, double wy)
+        {
+            grid[0] += 1; grid[1] += i; grid[2] += j; grid[3] += i * i; grid[4] += i * j; grid[5] += j * j;
+            x[0] += wx; x[1] += i * wx; x[2] += j * wx;
+            y[0] += wy; y[1] += i * wy; y[2] += j * wy;
+        }
+
+        void merge(const AffineSums& other)
+        {
+            for (int n = 0; n < 6; n++) grid[n] += other.grid[n];
+            for (int n = 0; n < 3; n++) x[n] += other.x[n];
+            for (int n = 0; n < 3; n++) y[n] += other.y[n];
+        }
+
+        // solve the normal equations with Cramer's rule, returns false for a degenerate geometry
+        bool solve(const std::array<double, 3>& rhs, std::array<double, 3>& coeff) const
+        {
+            const double m[3][3] = { { grid[0], grid[1], grid[2] }, { grid[1], grid[3], grid[4] }, { grid[2], grid[4], grid[5] } };
+
+            auto det3 = [](const double a[3][3]) {
+                return a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1]) - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0]) + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+            };
+
+            const double det = det3(m);
+            if (std::abs(det) < 1e-9 * std::max(1.0, grid[0] * grid[3] * grid[5])) return false;
+
+            for (int c = 0; c < 3; c++)
+            {
+                double mc[3][3];
+                for (int r = 0; r < 3; r++)
+                {
+                    for (int k = 0; k < 3; k++) mc[r][k] = (k == c) ? rhs[r] : m[r][k];
+                }
+                coeff[c] = det3(mc) / det;
+            }
+            return true;
+        }
+    };
+
+    double applyScalar(std::int32_t value, std::int16_t scalar)
+    {
+        if (scalar > 0) return (double)value * scalar;
+        if (scalar < 0) return (double)value / -scalar;
+        return (double)value;
+    }
+
+    // the 32-bit field must lie within the trace header
+    bool isHeaderPosition(int byte)
+    {
+        return (byte >= 1) && (byte <= SegyFormat::traceHeaderSize - 3);
+    }
+
+    int chunkCount(std::int64_t nItems)
+    {
+        return (int)std::min<std::int64_t>(nItems, 256);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SegyImporter::SegyImporter()
+    : m_inlineByte(SegyFormat::inlineByte)
+    , m_xlineByte(SegyFormat::xlineByte)
+    , m_cdpXByte(SegyFormat::cdpXByte)
+    , m_cdpYByte(SegyFormat::cdpYByte)
+    , m_snr(0.0f)
+    , m_memoryBudget(std::int64_t(1) << 30)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SegyImporter::~SegyImporter()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// 1-based byte positions of the 32-bit trace header fields used to build the geometry. Positions
+/// outside the 240 byte trace header make import() fail.
+//--------------------------------------------------------------------------------------------------
+void SegyImporter::setHeaderPositions(int inlineByte, int xlineByte, int cdpXByte, int cdpYByte)
+{
+    m_inlineByte = inlineByte;
+    m_xlineByte = xlineByte;
+    m_cdpXByte = cdpXByte;
+    m_cdpYByte = cdpYByte;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write ZFP compressed data with the given signal to noise ratio (dB). Zero means uncompressed.
+//--------------------------------------------------------------------------------------------------
+void SegyImporter::setCompression(float snr)
+{
+    m_snr = snr;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Upper limit for the sample buffers in flight. Two slabs of bricks are in use at any time, one
+/// being filled and one being written.
+//--------------------------------------------------------------------------------------------------
+void SegyImporter::setMemoryBudget(std::int64_t bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string SegyImporter::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Convert a 3D post-stack SEG-Y file to float ZGY. The geometry is inferred from the inline,
+/// crossline and CDP coordinate trace headers. Missing traces are written as zero.
+//--------------------------------------------------------------------------------------------------
+bool SegyImporter::import(std::string segyFilename, std::string zgyFilename)
+{
+    m_errorMessage.clear();
+
+    if (!isHeaderPosition(m_inlineByte) || !isHeaderPosition(m_xlineByte) || !isHeaderPosition(m_cdpXByte) || !isHeaderPosition(m_cdpYByte))
+    {
+        m_errorMessage = "Trace header byte positions must be within the 240 byte trace header";
+        return false;
+    }
+
+    MappedFile segy;
+    if (!segy.open(segyFilename))
+    {
+        m_errorMessage = "Could not open " + segyFilename;
+        return false;
+    }
+
+    const std::uint8_t* file = segy.data();
+    const std::uint64_t fileSize = segy.size();
+
+    if (fileSize < (std::uint64_t)(SegyFormat::textHeaderSize + SegyFormat::binaryHeaderSize))
+    {
+        m_errorMessage = "File too small to be SEG-Y";
+        return false;
+    }
+
+    const int formatCode = SegyFormat::readInt16(file + SegyFormat::sampleFormatOffset);
+    const int nSamples = (std::uint16_t)SegyFormat::readInt16(file + SegyFormat::sampleCountOffset);
+    const int sampleInterval = (std::uint16_t)SegyFormat::readInt16(file + SegyFormat::sampleIntervalOffset);
+    const int extendedHeaders = std::max<int>(0, SegyFormat::readInt16(file + SegyFormat::extendedHeaderCountOffset));
+
+    if (!SegyFormat::isSupported(formatCode) || (nSamples <= 0))
+    {
+        m_errorMessage = "Unsupported sample format or sample count";
+        return false;
+    }
+
+    const auto format = (SegyFormat::SampleFormat)formatCode;
+    const std::uint64_t dataStart = SegyFormat::textHeaderSize + SegyFormat::binaryHeaderSize + (std::uint64_t)extendedHeaders * SegyFormat::textHeaderSize;
+    const std::uint64_t traceBytes = SegyFormat::traceHeaderSize + (std::uint64_t)nSamples * SegyFormat::bytesPerSample(format);
+    const std::int64_t nTraces = (fileSize > dataStart) ? (std::int64_t)((fileSize - dataStart) / traceBytes) : 0;
+
+    if (nTraces == 0)
+    {
+        m_errorMessage = "No traces found";
+        return false;
+    }
+
+    auto traceHeader = [&](std::int64_t t) { return file + dataStart + t * traceBytes; };
+
+    // scan the trace headers in parallel chunks
+    std::vector<std::int32_t> inlines(nTraces);
+    std::vector<std::int32_t> xlines(nTraces);
+
+    const int nChunks = chunkCount(nTraces);
+    std::vector<HeaderSummary> summaries(nChunks);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nChunks; c++)
+    {
+        const std::int64_t first = nTraces * c / nChunks;
+        const std::int64_t last = nTraces * (c + 1) / nChunks;
+
+        auto& summary = summaries[c];
+        for (std::int64_t t = first; t < last; t++)
+        {
+            const std::uint8_t* header = traceHeader(t);
+            inlines[t] = SegyFormat::readInt32(header + m_inlineByte - 1);
+            xlines[t] = SegyFormat::readInt32(header + m_xlineByte - 1);
+
+            summary.inlineMin = std::min(summary.inlineMin, inlines[t]);
+            summary.inlineMax = std::max(summary.inlineMax, inlines[t]);
+            summary.xlineMin = std::min(summary.xlineMin, xlines[t]);
+            summary.xlineMax = std::max(summary.xlineMax, xlines[t]);
+        }
+    }
+
+    HeaderSummary summary;
+    for (auto& s : summaries)
+    {
+        summary.merge(s);
+    }
+
+    // line increments are the largest steps that put every trace on the grid, in 64 bits as the
+    // line numbers may span the whole 32-bit range
+    std::int64_t inlineInc = 0;
+    std::int64_t xlineInc = 0;
+    for (std::int64_t t = 0; t < nTraces; t++)
+    {
+        inlineInc = std::gcd(inlineInc, (std::int64_t)inlines[t] - summary.inlineMin);
+        xlineInc = std::gcd(xlineInc, (std::int64_t)xlines[t] - summary.xlineMin);
+    }
+    inlineInc = std::max<std::int64_t>(inlineInc, 1);
+    xlineInc = std::max<std::int64_t>(xlineInc, 1);
+
+    const std::int64_t gridInlines = ((std::int64_t)summary.inlineMax - summary.inlineMin) / inlineInc + 1;
+    const std::int64_t gridXlines = ((std::int64_t)summary.xlineMax - summary.xlineMin) / xlineInc + 1;
+
+    // a grid much larger than the number of traces comes from headers at the wrong positions
+    if ((gridInlines > std::numeric_limits<int>::max()) || (gridXlines > std::numeric_limits<int>::max()) ||
+        (gridInlines * gridXlines > nTraces * maxGridPerTrace))
+    {
+        m_errorMessage = "Inline and crossline headers do not form a plausible grid of " + std::to_string(gridInlines) + " x " + std::to_string(gridXlines) + " for " + std::to_string(nTraces) + " traces";
+        return false;
+    }
+
+    const int ni = (int)gridInlines;
+    const int nj = (int)gridXlines;
+    const int nk = nSamples;
+
+    std::vector<std::int64_t> traceAt((size_t)ni * nj, -1);
+    std::vector<AffineSums> sums(nChunks);
+
+    for (std::int64_t t = 0; t < nTraces; t++)
+    {
+        const int i = (int)(((std::int64_t)inlines[t] - summary.inlineMin) / inlineInc);
+        const int j = (int)(((std::int64_t)xlines[t] - summary.xlineMin) / xlineInc);
+        traceAt[(size_t)i * nj + j] = t;
+    }
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nChunks; c++)
+    {
+        const std::int64_t first = nTraces * c / nChunks;
+        const std::int64_t last = nTraces * (c + 1) / nChunks;
+
+        for (std::int64_t t = first; t < last; t++)
+        {
+            const std::uint8_t* header = traceHeader(t);
+            const std::int16_t scalar = SegyFormat::readInt16(header + SegyFormat::coordinateScalarByte - 1);
+            const double wx = applyScalar(SegyFormat::readInt32(header + m_cdpXByte - 1), scalar);
+            const double wy = applyScalar(SegyFormat::readInt32(header + m_cdpYByte - 1), scalar);
+
+            sums[c].add((double)(((std::int64_t)inlines[t] - summary.inlineMin) / inlineInc), (double)(((std::int64_t)xlines[t] - summary.xlineMin) / xlineInc), wx, wy);
+        }
+    }
+
+    inlines = std::vector<std::int32_t>();
+    xlines = std::vector<std::int32_t>();
+
+    AffineSums total;
+    for (auto& s : sums)
+    {
+        total.merge(s);
+    }
+
+    // without a usable fit (a single line, or no coordinates) fall back to unit spacing
+    std::array<double, 3> cx{ 0.0, 1.0, 0.0 };
+    std::array<double, 3> cy{ 0.0, 0.0, 1.0 };
+    std::array<double, 3> fitX;
+    std::array<double, 3> fitY;
+    if (total.solve(total.x, fitX) && total.solve(total.y, fitY) && (std::abs(fitX[1] * fitY[2] - fitX[2] * fitY[1]) > 0.0))
+    {
+        cx = fitX;
+        cy = fitY;
+    }
+
+    auto corner = [&](int i, int j) { return std::array<double, 2>{ cx[0] + cx[1] * i + cx[2] * j, cy[0] + cy[1] * i + cy[2] * j }; };
+
+    const std::int16_t delay = SegyFormat::readInt16(traceHeader(0) + SegyFormat::delayTimeByte - 1);
+
+    OpenZGY::ZgyWriterArgs args;
+    args.filename(zgyFilename)
+        .size(ni, nj, nk)
+        .bricksize(brickSize, brickSize, brickSize)
+        .datatype(OpenZGY::SampleDataType::float32)
+        .ilstart((float)summary.inlineMin)
+        .ilinc((float)inlineInc)
+        .xlstart((float)summary.xlineMin)
+        .xlinc((float)xlineInc)
+        .zstart((float)delay)
+        .zinc(sampleInterval / 1000.0f)
+        .zunit(OpenZGY::UnitDimension::time, "ms", 1000.0)
+        .hunit(OpenZGY::UnitDimension::length, "m", 1.0)
+        .corners({ corner(0, 0), corner(ni - 1, 0), corner(0, nj - 1), corner(ni - 1, nj - 1) });
+
+    if (m_snr > 0.0f) args.zfp_compressor(m_snr);
+
+    SlabWriter slabWriter({ ni, nj, nk }, { brickSize, brickSize, brickSize }, m_memoryBudget);
+    if (!slabWriter.isValid())
+    {
+        m_errorMessage = "Memory budget exceeded";
+        return false;
+    }
+
+    try
+    {
+        auto writer = OpenZGY::IZgyWriter::open(args);
+
+        slabWriter.write(writer, [&](std::array<int, 3> start, std::array<int, 3> size, float* buffer) {
+            const int nSlabTraces = size[0] * size[1];
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (int n = 0; n < nSlabTraces; n++)
+            {
+                const int i = n / size[1];
+                const int j = n % size[1];
+                const std::int64_t t = traceAt[(size_t)(start[0] + i) * nj + start[1] + j];
+                float* values = buffer + (size_t)n * nk;
+
+                if (t < 0)
+                    std::fill(values, values + nk, 0.0f);
+                else
+                    SegyFormat::toFloat(traceHeader(t) + SegyFormat::traceHeaderSize, format, nk, values);
+            }
+        });
+
+        writer->finalize();
+        writer->close();
+    }
+    catch (const std::exception& err)
+    {
+        m_errorMessage = err.what();
+        return false;
+    }
+
+    return true;
+}
+
+}
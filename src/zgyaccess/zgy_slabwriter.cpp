@@ -0,0 +1,102 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgy_slabwriter.h"
+
+#include "exception.h"
+#include "api.h"
+
+#include <algorithm>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SlabWriter::SlabWriter(std::array<int, 3> size, std::array<int, 3> bricksize, std::int64_t memoryBudget, std::int64_t scratchBytesPerSample)
+    : m_size(size)
+    , m_bricksize(bricksize)
+{
+    const std::int64_t bytesPerBrickColumn = (std::int64_t)bricksize[0] * bricksize[1] * size[2] * ((std::int64_t)sizeof(float) + scratchBytesPerSample);
+    const int slabBricks = (int)std::clamp<std::int64_t>(memoryBudget / 2 / bytesPerBrickColumn, 1, (size[1] + bricksize[1] - 1) / bricksize[1]);
+    m_slabWidth = slabBricks * bricksize[1];
+
+    m_reservation = std::make_unique<MemoryReservation>(MemoryCategory::WriteBuffers, 2 * slabBricks * bytesPerBrickColumn);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SlabWriter::~SlabWriter()
+{
+    if (m_pendingWrite.valid()) m_pendingWrite.wait();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SlabWriter::isValid() const
+{
+    return m_reservation->isValid();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SlabWriter::write(std::shared_ptr<OpenZGY::IZgyWriter> writer, const std::function<void(std::array<int, 3>, std::array<int, 3>, float*)>& fill)
+{
+    const int ni = m_size[0];
+    const int nj = m_size[1];
+    const int nk = m_size[2];
+
+    try
+    {
+        int current = 0;
+        for (int i0 = 0; i0 < ni; i0 += m_bricksize[0])
+        {
+            for (int j0 = 0; j0 < nj; j0 += m_slabWidth)
+            {
+                const int ci = std::min(m_bricksize[0], ni - i0);
+                const int cj = std::min(m_slabWidth, nj - j0);
+
+                auto& buffer = m_buffers[current];
+                buffer.resize((size_t)ci * cj * nk);
+                fill({ i0, j0, 0 }, { ci, cj, nk }, buffer.data());
+
+                // the previous slab must be written before its buffer is reused, and the writer is
+                // only used from one thread at a time
+                if (m_pendingWrite.valid()) m_pendingWrite.get();
+
+                m_pendingWrite = std::async(std::launch::async, [writer, &buffer, i0, j0, ci, cj, nk]() {
+                    writer->write({ i0, j0, 0 }, { ci, cj, nk }, buffer.data());
+                });
+
+                current = 1 - current;
+            }
+        }
+
+        if (m_pendingWrite.valid()) m_pendingWrite.get();
+    }
+    catch (...)
+    {
+        if (m_pendingWrite.valid()) m_pendingWrite.wait();
+        throw;
+    }
+}
+
+}
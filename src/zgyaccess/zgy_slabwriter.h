@@ -0,0 +1,64 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "zgyaccess/zgy_memorygovernor.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace OpenZGY
+{
+    class IZgyWriter;
+}
+
+namespace ZGYAccess
+{
+
+    // Writes a float volume in slabs of whole bricks: one brick row of inlines, and as many crossline
+    // bricks as fit in half the memory budget. The caller fills one slab while the previous one is
+    // written on another thread. Both slab buffers, and any scratch memory the caller needs per
+    // sample, are reserved from the memory governor up front.
+    class SlabWriter
+    {
+    public:
+        SlabWriter(std::array<int, 3> size, std::array<int, 3> bricksize, std::int64_t memoryBudget, std::int64_t scratchBytesPerSample = 0);
+        ~SlabWriter();
+
+        // false if the memory governor refused the slab buffers
+        bool isValid() const;
+
+        // fill gets the start and size of each slab and a buffer to fill, z fastest. Exceptions from
+        // fill or the writer are passed on once any pending write has finished.
+        void write(std::shared_ptr<OpenZGY::IZgyWriter> writer, const std::function<void(std::array<int, 3>, std::array<int, 3>, float*)>& fill);
+
+    private:
+        std::array<int, 3> m_size;
+        std::array<int, 3> m_bricksize;
+        int m_slabWidth;
+
+        std::unique_ptr<MemoryReservation> m_reservation;
+        std::vector<float> m_buffers[2];
+        std::future<void> m_pendingWrite;
+    };
+
+}
@@ -0,0 +1,495 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_sliceencoding.h"
+#include "zgyaccess/seismicslice.h"
+
+#include "zfp.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    const std::uint8_t encodingMagic[4] = { 'Z', 'G', 'Y', 'S' };
+    const std::uint8_t encodingVersion = 1;
+    const size_t fixedHeaderBytes = 20;
+    const int losslessBlockSize = 128;
+    const size_t maxPaletteSize = 65536;
+
+    void putU32(std::vector<std::uint8_t>& buffer, std::uint32_t value)
+    {
+        for (int b = 0; b < 4; b++) buffer.push_back((std::uint8_t)(value >> (8 * b)));
+    }
+
+    std::uint32_t getU32(const std::uint8_t* data)
+    {
+        return (std::uint32_t)data[0] | ((std::uint32_t)data[1] << 8) | ((std::uint32_t)data[2] << 16) | ((std::uint32_t)data[3] << 24);
+    }
+
+    void putF64(std::vector<std::uint8_t>& buffer, double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putU32(buffer, (std::uint32_t)bits);
+        putU32(buffer, (std::uint32_t)(bits >> 32));
+    }
+
+    double getF64(const std::uint8_t* data)
+    {
+        const std::uint64_t bits = (std::uint64_t)getU32(data) | ((std::uint64_t)getU32(data + 4) << 32);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // float bits mapped so that unsigned order is value order, keeping distinct bit patterns apart
+    std::uint32_t sortKey(float value)
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    float keyValue(std::uint32_t key)
+    {
+        const std::uint32_t bits = (key & 0x80000000u) ? (key & 0x7fffffffu) : ~key;
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::uint32_t zigzag(std::int32_t value)
+    {
+        return ((std::uint32_t)value << 1) ^ (std::uint32_t)(value >> 31);
+    }
+
+    std::int32_t unzigzag(std::uint32_t value)
+    {
+        return (std::int32_t)(value >> 1) ^ -(std::int32_t)(value & 1);
+    }
+
+    // palette indices as differences from the previous sample, in blocks of a bit width byte
+    // followed by the zigzag coded differences packed at that width
+    void packIndices(const std::vector<std::uint32_t>& indices, std::vector<std::uint8_t>& output)
+    {
+        std::uint32_t previous = 0;
+        std::vector<std::uint32_t> codes(losslessBlockSize);
+
+        for (size_t blockStart = 0; blockStart < indices.size(); blockStart += losslessBlockSize)
+        {
+            const size_t count = std::min(indices.size() - blockStart, (size_t)losslessBlockSize);
+
+            std::uint32_t bitsUsed = 0;
+            for (size_t n = 0; n < count; n++)
+            {
+                const std::uint32_t index = indices[blockStart + n];
+                codes[n] = zigzag((std::int32_t)index - (std::int32_t)previous);
+                bitsUsed |= codes[n];
+                previous = index;
+            }
+
+            int nBits = 0;
+            while (bitsUsed >> nBits) nBits++;
+            output.push_back((std::uint8_t)nBits);
+
+            std::uint64_t accumulator = 0;
+            int accumulated = 0;
+            for (size_t n = 0; n < count; n++)
+            {
+                accumulator |= (std::uint64_t)codes[n] << accumulated;
+                accumulated += nBits;
+                while (accumulated >= 8)
+                {
+                    output.push_back((std::uint8_t)accumulator);
+                    accumulator >>= 8;
+                    accumulated -= 8;
+                }
+            }
+            if (accumulated > 0) output.push_back((std::uint8_t)accumulator);
+        }
+    }
+
+    bool unpackIndices(const std::uint8_t* data, size_t size, size_t nIndices, std::uint32_t paletteSize, float* output, const std::vector<float>& palette)
+    {
+        std::uint32_t previous = 0;
+        size_t pos = 0;
+
+        for (size_t blockStart = 0; blockStart < nIndices; blockStart += losslessBlockSize)
+        {
+            const size_t count = std::min(nIndices - blockStart, (size_t)losslessBlockSize);
+            if (pos >= size) return false;
+
+            const int nBits = data[pos++];
+            const size_t blockBytes = (count * nBits + 7) / 8;
+            if ((nBits > 32) || (pos + blockBytes > size)) return false;
+
+            const std::uint32_t mask = (nBits == 32) ? 0xffffffffu : ((1u << nBits) - 1);
+            std::uint64_t accumulator = 0;
+            int accumulated = 0;
+            for (size_t n = 0; n < count; n++)
+            {
+                while (accumulated < nBits)
+                {
+                    accumulator |= (std::uint64_t)data[pos++] << accumulated;
+                    accumulated += 8;
+                }
+                const std::uint32_t code = (std::uint32_t)accumulator & mask;
+                accumulator >>= nBits;
+                accumulated -= nBits;
+
+                previous = (std::uint32_t)((std::int32_t)previous + unzigzag(code));
+                if (previous >= paletteSize) return false;
+                output[blockStart + n] = palette[previous];
+            }
+        }
+
+        return pos == size;
+    }
+
+    bool compressTile(float* values, int depth, int traces, double tolerance, std::vector<std::uint8_t>& output)
+    {
+        // samples are stored with depth fastest, which is x in zfp terms
+        zfp_field* field = zfp_field_2d(values, zfp_type_float, depth, traces);
+        zfp_stream* zfp = zfp_stream_open(nullptr);
+        zfp_stream_set_accuracy(zfp, tolerance);
+
+        output.resize(zfp_stream_maximum_size(zfp, field));
+        bitstream* stream = stream_open(output.data(), output.size());
+        zfp_stream_set_bit_stream(zfp, stream);
+
+        zfp_stream_rewind(zfp);
+        const size_t bytes = zfp_compress(zfp, field);
+
+        zfp_field_free(field);
+        zfp_stream_close(zfp);
+        stream_close(stream);
+
+        output.resize(bytes);
+        return bytes != 0;
+    }
+
+    // zfp does not check the end of its input, so the tile is copied into a zero padded buffer of
+    // the largest size a tile of this shape can compress to, in whole 64 bit stream words, which
+    // the decoder never reads past
+    bool decompressTile(const std::uint8_t* data, size_t size, double tolerance, int depth, int traces, float* output)
+    {
+        zfp_field* field = zfp_field_2d(output, zfp_type_float, depth, traces);
+        zfp_stream* zfp = zfp_stream_open(nullptr);
+        zfp_stream_set_accuracy(zfp, tolerance);
+
+        const size_t maxBytes = zfp_stream_maximum_size(zfp, field);
+        bool decoded = false;
+
+        if ((size > 0) && (size <= maxBytes))
+        {
+            const size_t wordBytes = sizeof(std::uint64_t);
+            std::vector<std::uint8_t> padded((maxBytes + wordBytes - 1) / wordBytes * wordBytes, 0);
+            std::memcpy(padded.data(), data, size);
+
+            bitstream* stream = stream_open(padded.data(), padded.size());
+            zfp_stream_set_bit_stream(zfp, stream);
+
+            zfp_stream_rewind(zfp);
+            const size_t consumed = zfp_decompress(zfp, field);
+            decoded = (consumed != 0) && (consumed <= (size + wordBytes - 1) / wordBytes * wordBytes);
+
+            stream_close(stream);
+        }
+
+        zfp_field_free(field);
+        zfp_stream_close(zfp);
+
+        return decoded;
+    }
+
+    void writeFixedHeader(std::vector<std::uint8_t>& buffer, SliceCodec codec, int width, int depth, int tileTraces)
+    {
+        buffer.insert(buffer.end(), encodingMagic, encodingMagic + 4);
+        buffer.push_back(encodingVersion);
+        buffer.push_back((std::uint8_t)codec);
+        buffer.push_back(0);
+        buffer.push_back(0);
+        putU32(buffer, (std::uint32_t)width);
+        putU32(buffer, (std::uint32_t)depth);
+        putU32(buffer, (std::uint32_t)tileTraces);
+    }
+
+    std::vector<std::uint8_t> assemble(std::vector<std::uint8_t>& header, const std::vector<std::vector<std::uint8_t>>& tiles)
+    {
+        size_t totalBytes = header.size() + 4 * tiles.size();
+        for (auto& tile : tiles) totalBytes += tile.size();
+
+        std::vector<std::uint8_t> encoded;
+        encoded.reserve(totalBytes);
+        encoded.swap(header);
+        for (auto& tile : tiles) putU32(encoded, (std::uint32_t)tile.size());
+        for (auto& tile : tiles) encoded.insert(encoded.end(), tile.begin(), tile.end());
+
+        return encoded;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SliceEncoder::SliceEncoder()
+    : m_tileTraces(64)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SliceEncoder::~SliceEncoder()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SliceEncoder::setTileTraces(int traces)
+{
+    m_tileTraces = std::max(1, traces);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Every decoded sample is within the tolerance of the original. Expects finite samples.
+//--------------------------------------------------------------------------------------------------
+std::vector<std::uint8_t> SliceEncoder::encodeZfp(std::shared_ptr<SeismicSliceData> slice, double tolerance) const
+{
+    if ((slice == nullptr) || slice->isEmpty() || !(tolerance > 0.0)) return {};
+
+    const int width = slice->width();
+    const int depth = slice->depth();
+    const int nTiles = (width + m_tileTraces - 1) / m_tileTraces;
+
+    std::vector<std::vector<std::uint8_t>> tiles(nTiles);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < nTiles; t++)
+    {
+        if (failed) continue;
+
+        const int firstTrace = t * m_tileTraces;
+        const int traces = std::min(m_tileTraces, width - firstTrace);
+        if (!compressTile(slice->values() + (size_t)firstTrace * depth, depth, traces, tolerance, tiles[t])) failed = true;
+    }
+
+    if (failed) return {};
+
+    std::vector<std::uint8_t> header;
+    writeFixedHeader(header, SliceCodec::Zfp, width, depth, m_tileTraces);
+    putF64(header, tolerance);
+
+    return assemble(header, tiles);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Bit exact, NaN included. Returns an empty buffer if the slice has more than 65536 distinct
+/// values, as it is then not from an integer file and would not shrink.
+//--------------------------------------------------------------------------------------------------
+std::vector<std::uint8_t> SliceEncoder::encodeLossless(std::shared_ptr<SeismicSliceData> slice) const
+{
+    if ((slice == nullptr) || slice->isEmpty()) return {};
+
+    const int width = slice->width();
+    const int depth = slice->depth();
+    const int nTiles = (width + m_tileTraces - 1) / m_tileTraces;
+    const float* values = slice->values();
+
+    // distinct values of each tile, merged into one sorted palette
+    std::vector<std::vector<std::uint32_t>> tileKeys(nTiles);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < nTiles; t++)
+    {
+        const int firstTrace = t * m_tileTraces;
+        const size_t nSamples = (size_t)std::min(m_tileTraces, width - firstTrace) * depth;
+        const float* tileValues = values + (size_t)firstTrace * depth;
+
+        auto& keys = tileKeys[t];
+        keys.resize(nSamples);
+        for (size_t n = 0; n < nSamples; n++) keys[n] = sortKey(tileValues[n]);
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+    std::vector<std::uint32_t> palette;
+    for (auto& keys : tileKeys)
+    {
+        if (keys.size() > maxPaletteSize) return {};
+
+        std::vector<std::uint32_t> merged;
+        merged.reserve(palette.size() + keys.size());
+        std::set_union(palette.begin(), palette.end(), keys.begin(), keys.end(), std::back_inserter(merged));
+        palette.swap(merged);
+
+        if (palette.size() > maxPaletteSize) return {};
+    }
+
+    std::vector<std::vector<std::uint8_t>> tiles(nTiles);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < nTiles; t++)
+    {
+        const int firstTrace = t * m_tileTraces;
+        const size_t nSamples = (size_t)std::min(m_tileTraces, width - firstTrace) * depth;
+        const float* tileValues = values + (size_t)firstTrace * depth;
+
+        std::vector<std::uint32_t> indices(nSamples);
+        for (size_t n = 0; n < nSamples; n++)
+        {
+            indices[n] = (std::uint32_t)(std::lower_bound(palette.begin(), palette.end(), sortKey(tileValues[n])) - palette.begin());
+        }
+
+        tiles[t].reserve(nSamples / 2);
+        packIndices(indices, tiles[t]);
+    }
+
+    std::vector<std::uint8_t> header;
+    writeFixedHeader(header, SliceCodec::Lossless, width, depth, m_tileTraces);
+    putU32(header, (std::uint32_t)palette.size());
+    for (auto key : palette) putU32(header, key);
+
+    return assemble(header, tiles);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Codec and slice size of an encoded buffer, without decoding it. Sizes with more samples than a
+/// slice can hold are rejected.
+//--------------------------------------------------------------------------------------------------
+bool SliceEncoder::readHeader(const std::uint8_t* data, size_t size, SliceCodec& codec, int& width, int& depth)
+{
+    if ((data == nullptr) || (size < fixedHeaderBytes)) return false;
+    if ((std::memcmp(data, encodingMagic, 4) != 0) || (data[4] != encodingVersion)) return false;
+    if ((data[5] != (std::uint8_t)SliceCodec::Zfp) && (data[5] != (std::uint8_t)SliceCodec::Lossless)) return false;
+
+    const std::uint32_t w = getU32(data + 8);
+    const std::uint32_t d = getU32(data + 12);
+    if ((w == 0) || (d == 0) || ((std::uint64_t)w * d > (std::uint64_t)INT_MAX)) return false;
+
+    codec = (SliceCodec)data[5];
+    width = (int)w;
+    depth = (int)d;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Returns an empty slice if the buffer is not a valid encoding. The buffer may come from anywhere,
+/// so every size in it is checked against the slice size before anything is allocated or decoded.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> SliceEncoder::decode(const std::uint8_t* data, size_t size)
+{
+    SliceCodec codec;
+    int width, depth;
+    if (!readHeader(data, size, codec, width, depth)) return std::make_shared<SeismicSliceData>(0, 0);
+
+    const int tileTraces = (int)std::min(getU32(data + 16), (std::uint32_t)width);
+    if (tileTraces == 0) return std::make_shared<SeismicSliceData>(0, 0);
+
+    size_t pos = fixedHeaderBytes;
+    double tolerance = 0.0;
+    std::vector<float> palette;
+
+    if (codec == SliceCodec::Zfp)
+    {
+        if (pos + 8 > size) return std::make_shared<SeismicSliceData>(0, 0);
+        tolerance = getF64(data + pos);
+        pos += 8;
+        if (!(tolerance > 0.0) || !std::isfinite(tolerance)) return std::make_shared<SeismicSliceData>(0, 0);
+    }
+    else
+    {
+        if (pos + 4 > size) return std::make_shared<SeismicSliceData>(0, 0);
+        const std::uint32_t paletteSize = getU32(data + pos);
+        pos += 4;
+        if ((paletteSize == 0) || (paletteSize > maxPaletteSize) || (paletteSize > (std::uint64_t)width * depth) || ((size - pos) / 4 < paletteSize))
+            return std::make_shared<SeismicSliceData>(0, 0);
+
+        palette.resize(paletteSize);
+        for (std::uint32_t n = 0; n < paletteSize; n++) palette[n] = keyValue(getU32(data + pos + 4 * n));
+        pos += 4 * (size_t)paletteSize;
+    }
+
+    const int nTiles = (width + tileTraces - 1) / tileTraces;
+    if ((size - pos) / 4 < (size_t)nTiles) return std::make_shared<SeismicSliceData>(0, 0);
+
+    std::vector<size_t> tileOffsets(nTiles + 1);
+    tileOffsets[0] = pos + 4 * (size_t)nTiles;
+    for (int t = 0; t < nTiles; t++) tileOffsets[t + 1] = tileOffsets[t] + getU32(data + pos + 4 * (size_t)t);
+    if (tileOffsets[nTiles] != size) return std::make_shared<SeismicSliceData>(0, 0);
+
+    // a lossless tile has one bit width byte per block and at most 32 bits per sample
+    if (codec == SliceCodec::Lossless)
+    {
+        for (int t = 0; t < nTiles; t++)
+        {
+            const size_t nSamples = (size_t)std::min(tileTraces, width - t * tileTraces) * depth;
+            const size_t nBlocks = (nSamples + losslessBlockSize - 1) / losslessBlockSize;
+            const size_t tileBytes = tileOffsets[t + 1] - tileOffsets[t];
+            if ((tileBytes < nBlocks) || (tileBytes > nBlocks + 4 * nSamples)) return std::make_shared<SeismicSliceData>(0, 0);
+        }
+    }
+
+    auto retData = std::make_shared<SeismicSliceData>(width, depth);
+    if (retData->isEmpty()) return retData;
+
+    float* output = retData->values();
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int t = 0; t < nTiles; t++)
+    {
+        if (failed) continue;
+
+        const int firstTrace = t * tileTraces;
+        const int traces = std::min(tileTraces, width - firstTrace);
+        const std::uint8_t* tileData = data + tileOffsets[t];
+        const size_t tileBytes = tileOffsets[t + 1] - tileOffsets[t];
+        float* tileOutput = output + (size_t)firstTrace * depth;
+
+        const bool decoded = (codec == SliceCodec::Zfp)
+            ? decompressTile(tileData, tileBytes, tolerance, depth, traces, tileOutput)
+            : unpackIndices(tileData, tileBytes, (size_t)traces * depth, (std::uint32_t)palette.size(), tileOutput, palette);
+
+        if (!decoded) failed = true;
+    }
+
+    if (failed) return std::make_shared<SeismicSliceData>(0, 0);
+
+    return retData;
+}
+
+}
@@ -0,0 +1,161 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_sliceview.h"
+
+#include <algorithm>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SeismicSliceView::SeismicSliceView()
+    : m_inlineIndex(0)
+    , m_zStart(0)
+    , m_zSize(0)
+    , m_width(0)
+    , m_brickSize{ 1, 1, 1 }
+    , m_bricksPerTrace(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The bricks must cover the whole window, ordered by crossline brick and then by z brick.
+//--------------------------------------------------------------------------------------------------
+SeismicSliceView::SeismicSliceView(int inlineIndex, int zStart, int zSize, int width, std::array<int, 3> brickSize, std::vector<std::shared_ptr<const DecodedBrick>> bricks, std::shared_ptr<void> cacheHold)
+    : m_inlineIndex(inlineIndex)
+    , m_zStart(zStart)
+    , m_zSize(zSize)
+    , m_width(width)
+    , m_brickSize(brickSize)
+    , m_bricksPerTrace((zStart + zSize - 1) / brickSize[2] - zStart / brickSize[2] + 1)
+    , m_bricks(std::move(bricks))
+    , m_cacheHold(std::move(cacheHold))
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SeismicSliceView::~SeismicSliceView()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int SeismicSliceView::width() const
+{
+    return m_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int SeismicSliceView::depth() const
+{
+    return m_zSize;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SeismicSliceView::isEmpty() const
+{
+    return (m_width == 0) || (m_zSize == 0) || m_bricks.empty();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Number of contiguous runs each trace is split into, one per brick in z.
+//--------------------------------------------------------------------------------------------------
+int SeismicSliceView::segmentCount() const
+{
+    return isEmpty() ? 0 : m_bricksPerTrace;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const DecodedBrick* SeismicSliceView::brickFor(int trace, int segmentIndex) const
+{
+    return m_bricks[(size_t)(trace / m_brickSize[1]) * m_bricksPerTrace + segmentIndex].get();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Pointer to the samples of one trace within one z brick, pointing into the brick itself.
+//--------------------------------------------------------------------------------------------------
+const float* SeismicSliceView::segment(int trace, int segmentIndex, int& nSamples) const
+{
+    nSamples = 0;
+    if ((trace < 0) || (trace >= m_width) || (segmentIndex < 0) || (segmentIndex >= segmentCount())) return nullptr;
+
+    const DecodedBrick* brick = brickFor(trace, segmentIndex);
+
+    const int z0 = std::max(m_zStart, brick->start[2]);
+    const int z1 = std::min(m_zStart + m_zSize, brick->start[2] + brick->size[2]);
+
+    nSamples = z1 - z0;
+    return brick->trace(m_inlineIndex, trace) + (z0 - brick->start[2]);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+float SeismicSliceView::valueAt(int width, int depth) const
+{
+    if (isEmpty() || (width < 0) || (width >= m_width) || (depth < 0) || (depth >= m_zSize)) return 0.0f;
+
+    const int z = m_zStart + depth;
+    const DecodedBrick* brick = brickFor(width, z / m_brickSize[2] - m_zStart / m_brickSize[2]);
+
+    return brick->trace(m_inlineIndex, width)[z - brick->start[2]];
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SeismicSliceView::copyTrace(int trace, float* values) const
+{
+    for (int s = 0; s < segmentCount(); s++)
+    {
+        int nSamples = 0;
+        const float* samples = segment(trace, s, nSamples);
+        values = std::copy(samples, samples + nSamples, values);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Copy into a contiguous slice, for callers that need all traces in one array.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> SeismicSliceView::gather() const
+{
+    if (isEmpty()) return std::make_shared<SeismicSliceData>(0, 0);
+
+    auto retData = std::make_shared<SeismicSliceData>(m_width, m_zSize);
+    if (retData->isEmpty()) return retData;
+
+    for (int trace = 0; trace < m_width; trace++)
+    {
+        copyTrace(trace, retData->values() + (size_t)trace * m_zSize);
+    }
+
+    return retData;
+}
+
+}
@@ -0,0 +1,124 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SampleStatistics::SampleStatistics()
+{
+    reset();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SampleStatistics::reset()
+{
+    count = 0;
+    sum = 0.0;
+    sumSquares = 0.0;
+    minValue = std::numeric_limits<double>::infinity();
+    maxValue = -std::numeric_limits<double>::infinity();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Non-finite values are ignored.
+//--------------------------------------------------------------------------------------------------
+void SampleStatistics::add(const float* values, size_t nValues)
+{
+    float minVal = std::numeric_limits<float>::infinity();
+    float maxVal = -std::numeric_limits<float>::infinity();
+    double localSum = 0.0;
+    double localSumSquares = 0.0;
+    std::int64_t localCount = 0;
+
+    for (size_t i = 0; i < nValues; i++)
+    {
+        const float value = values[i];
+        if (!std::isfinite(value)) continue;
+
+        minVal = std::min(minVal, value);
+        maxVal = std::max(maxVal, value);
+        localSum += value;
+        localSumSquares += (double)value * value;
+        localCount++;
+    }
+
+    if (localCount == 0) return;
+
+    count += localCount;
+    sum += localSum;
+    sumSquares += localSumSquares;
+    minValue = std::min(minValue, (double)minVal);
+    maxValue = std::max(maxValue, (double)maxVal);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SampleStatistics::merge(const SampleStatistics& other)
+{
+    if (other.count == 0) return;
+
+    count += other.count;
+    sum += other.sum;
+    sumSquares += other.sumSquares;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double SampleStatistics::mean() const
+{
+    if (count == 0) return 0.0;
+
+    return sum / count;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double SampleStatistics::rms() const
+{
+    if (count == 0) return 0.0;
+
+    return std::sqrt(sumSquares / count);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+double SampleStatistics::stdDev() const
+{
+    if (count == 0) return 0.0;
+
+    const double avg = mean();
+    return std::sqrt(std::max(0.0, sumSquares / count - avg * avg));
+}
+
+}
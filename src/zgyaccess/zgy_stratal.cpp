@@ -0,0 +1,176 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_stratal.h"
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/seismicslice.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+StratalSlicer::StratalSlicer()
+    : m_fillValue(std::numeric_limits<float>::quiet_NaN())
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+StratalSlicer::~StratalSlicer()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Value used where a horizon is undefined or the stratal position is outside the volume.
+//--------------------------------------------------------------------------------------------------
+void StratalSlicer::setFillValue(float fillValue)
+{
+    m_fillValue = fillValue;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// One slice per proportion, 0 at the top horizon and 1 at the base, linearly interpolated between
+/// samples. Each brick column is read once over the z range spanned by the horizons in that column,
+/// and all proportions are sampled from the same buffer, so a stack of slices costs one sweep of the
+/// interval. Returns an empty list on failure.
+//--------------------------------------------------------------------------------------------------
+std::vector<std::shared_ptr<SeismicSliceData>> StratalSlicer::slices(const ZGYReader& reader,
+                                                                     std::shared_ptr<SeismicSliceData> top,
+                                                                     std::shared_ptr<SeismicSliceData> base,
+                                                                     const std::vector<double>& proportions) const
+{
+    std::vector<std::shared_ptr<SeismicSliceData>> retSlices;
+
+    const int widthI = reader.inlineSize();
+    const int widthX = reader.xlineSize();
+    const int nz = reader.zSize();
+
+    if ((nz == 0) || (top == nullptr) || (base == nullptr) || proportions.empty()) return retSlices;
+    if ((top->width() != widthI) || (top->depth() != widthX) || (base->width() != widthI) || (base->depth() != widthX)) return retSlices;
+
+    const int nSlices = (int)proportions.size();
+    std::vector<float*> outputs;
+    for (int s = 0; s < nSlices; s++)
+    {
+        auto slice = std::make_shared<SeismicSliceData>(widthI, widthX);
+        if (slice->isEmpty()) return {};
+
+        std::fill(slice->values(), slice->values() + slice->size(), m_fillValue);
+        outputs.push_back(slice->values());
+        retSlices.push_back(slice);
+    }
+
+    const double z0 = reader.zRange().first;
+    const double dz = reader.zStep();
+    if (dz <= 0.0) return {};
+
+    const float* topValues = top->values();
+    const float* baseValues = base->values();
+
+    const auto bricksize = reader.brickSize();
+    const int columnsI = (widthI + bricksize[0] - 1) / bricksize[0];
+    const int columnsX = (widthX + bricksize[1] - 1) / bricksize[1];
+    const int nColumns = columnsI * columnsX;
+
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nColumns; c++)
+    {
+        if (failed) continue;
+
+        const int i0 = (c / columnsX) * bricksize[0];
+        const int j0 = (c % columnsX) * bricksize[1];
+        const int ni = std::min(bricksize[0], widthI - i0);
+        const int nj = std::min(bricksize[1], widthX - j0);
+
+        // fractional sample index of every slice in every trace, NaN where nothing is sampled
+        std::vector<double> positions((size_t)ni * nj * nSlices, std::numeric_limits<double>::quiet_NaN());
+        int kMin = nz;
+        int kMax = -1;
+
+        for (int i = 0; i < ni; i++)
+        {
+            for (int j = 0; j < nj; j++)
+            {
+                const size_t trace = (size_t)(i0 + i) * widthX + (j0 + j);
+                const double zTop = topValues[trace];
+                const double zBase = baseValues[trace];
+                if (std::isnan(zTop) || std::isnan(zBase)) continue;
+
+                double* position = &positions[((size_t)i * nj + j) * nSlices];
+                for (int s = 0; s < nSlices; s++)
+                {
+                    const double k = (zTop + proportions[s] * (zBase - zTop) - z0) / dz;
+                    if ((k < 0.0) || (k > nz - 1)) continue;
+
+                    position[s] = k;
+                    kMin = std::min(kMin, (int)k);
+                    kMax = std::max(kMax, std::min((int)k + 1, nz - 1));
+                }
+            }
+        }
+
+        if (kMax < kMin) continue;
+
+        const int nk = kMax - kMin + 1;
+        std::vector<float> buffer((size_t)ni * nj * nk);
+        if (!reader.readVolume(0, { i0, j0, kMin }, { ni, nj, nk }, buffer.data()))
+        {
+            failed = true;
+            continue;
+        }
+
+        for (int i = 0; i < ni; i++)
+        {
+            for (int j = 0; j < nj; j++)
+            {
+                const float* samples = &buffer[((size_t)i * nj + j) * nk];
+                const double* position = &positions[((size_t)i * nj + j) * nSlices];
+                const size_t offset = (size_t)(i0 + i) * widthX + (j0 + j);
+
+                for (int s = 0; s < nSlices; s++)
+                {
+                    if (std::isnan(position[s])) continue;
+
+                    const int k = (int)position[s] - kMin;
+                    const double t = position[s] - (int)position[s];
+                    const float upper = samples[k];
+                    const float lower = (k + 1 < nk) ? samples[k + 1] : upper;
+
+                    outputs[s][offset] = (float)(upper + t * (lower - upper));
+                }
+            }
+        }
+    }
+
+    if (failed) return {};
+
+    return retSlices;
+}
+
+}
@@ -0,0 +1,342 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_synthetic.h"
+
+#include "zgy_slabwriter.h"
+
+#include "exception.h"
+#include "api.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    const int brickSize = 64;
+    const double pi = 3.14159265358979323846;
+
+    // Ricker wavelet peak frequency in cycles per sample, 20 Hz at 4 ms sampling
+    const double peakFrequency = 0.08;
+    const int waveletHalfLength = 19;
+
+    const double noiseLevel = 0.02;
+
+    double ricker(double t)
+    {
+        const double a = pi * peakFrequency * t;
+        return (1.0 - 2.0 * a * a) * std::exp(-a * a);
+    }
+
+    // position based noise in [-1, 1), so traces can be generated in any order on any thread
+    double hashNoise(std::uint64_t index, unsigned int seed)
+    {
+        std::uint64_t z = index + 0x9E3779B97F4A7C15ull * (seed + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+        return (double)(z >> 11) / (double)(1ull << 52) - 1.0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SyntheticVolumeGenerator::SyntheticVolumeGenerator(int inlineSize, int xlineSize, int zSize)
+    : m_size{ inlineSize, xlineSize, zSize }
+    , m_sampleType(SyntheticSampleType::Float32)
+    , m_snr(0.0f)
+    , m_seed(1)
+    , m_deadAreas(true)
+    , m_memoryBudget(std::int64_t(1) << 30)
+{
+    buildModel();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+SyntheticVolumeGenerator::~SyntheticVolumeGenerator()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SyntheticVolumeGenerator::setSampleType(SyntheticSampleType sampleType)
+{
+    m_sampleType = sampleType;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write ZFP compressed data with the given signal to noise ratio (dB). Zero means uncompressed.
+/// Only float samples can be compressed.
+//--------------------------------------------------------------------------------------------------
+void SyntheticVolumeGenerator::setCompression(float snr)
+{
+    m_snr = snr;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void SyntheticVolumeGenerator::setSeed(unsigned int seed)
+{
+    m_seed = seed;
+    buildModel();
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Zero traces outside an elliptic survey outline and inside an obstruction near the centre.
+//--------------------------------------------------------------------------------------------------
+void SyntheticVolumeGenerator::setDeadAreas(bool enable)
+{
+    m_deadAreas = enable;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Upper limit for the sample buffers in flight. Two slabs of bricks are in use at any time, one
+/// being generated and one being written.
+//--------------------------------------------------------------------------------------------------
+void SyntheticVolumeGenerator::setMemoryBudget(std::int64_t bytes)
+{
+    m_memoryBudget = bytes;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::string SyntheticVolumeGenerator::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Samples are clipped to plus/minus this value, which is also the data range of integer files.
+//--------------------------------------------------------------------------------------------------
+float SyntheticVolumeGenerator::amplitudeLimit() const
+{
+    return 3.0f;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Random layer stack and structural undulations, all derived from the seed.
+//--------------------------------------------------------------------------------------------------
+void SyntheticVolumeGenerator::buildModel()
+{
+    std::mt19937 random(m_seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 0.5);
+
+    const double nk = m_size[2];
+    const double lateralSize = std::max(m_size[0], m_size[1]);
+
+    // layers from above the top to below the bottom, so the structure never exposes empty space
+    m_layers.clear();
+    for (double depth = -0.3 * nk; depth < 1.3 * nk; depth += 3.0 + 10.0 * uniform(random))
+    {
+        Layer layer;
+        layer.depth = depth;
+        layer.reflectivity = normal(random) * ((uniform(random) < 0.1) ? 3.0 : 1.0);
+        m_layers.push_back(layer);
+    }
+
+    m_undulations.clear();
+    for (int n = 0; n < 3; n++)
+    {
+        const double wavelength = (0.3 + 1.2 * uniform(random)) * lateralSize;
+        const double direction = 2.0 * pi * uniform(random);
+
+        Undulation undulation;
+        undulation.amplitude = (0.02 + 0.04 * uniform(random)) * nk;
+        undulation.waveInline = 2.0 * pi / wavelength * std::cos(direction);
+        undulation.waveXline = 2.0 * pi / wavelength * std::sin(direction);
+        undulation.phase = 2.0 * pi * uniform(random);
+        m_undulations.push_back(undulation);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Vertical displacement in samples at the given trace, including a normal fault across the survey.
+//--------------------------------------------------------------------------------------------------
+double SyntheticVolumeGenerator::structure(int inlineIndex, int xlineIndex) const
+{
+    double displacement = 0.0;
+    for (const auto& undulation : m_undulations)
+    {
+        displacement += undulation.amplitude * std::sin(undulation.waveInline * inlineIndex + undulation.waveXline * xlineIndex + undulation.phase);
+    }
+
+    const double faultPosition = 0.6 * m_size[0] + 0.15 * xlineIndex;
+    if (inlineIndex > faultPosition) displacement += 0.03 * m_size[2];
+
+    return displacement;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SyntheticVolumeGenerator::isDeadTrace(int inlineIndex, int xlineIndex) const
+{
+    if (!m_deadAreas) return false;
+
+    const double u = (inlineIndex - 0.5 * (m_size[0] - 1)) / (0.62 * m_size[0]);
+    const double v = (xlineIndex - 0.5 * (m_size[1] - 1)) / (0.62 * m_size[1]);
+    if (u * u + v * v > 1.0) return true;
+
+    const double radius = 0.08 * std::min(m_size[0], m_size[1]);
+    const double di = inlineIndex - 0.3 * m_size[0];
+    const double dj = xlineIndex - 0.65 * m_size[1];
+    return di * di + dj * dj < radius * radius;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Reflectivity of the displaced layer stack convolved with a Ricker wavelet, plus a little noise.
+//--------------------------------------------------------------------------------------------------
+void SyntheticVolumeGenerator::generateTrace(int inlineIndex, int xlineIndex, float* values) const
+{
+    const int nk = m_size[2];
+    std::fill(values, values + nk, 0.0f);
+
+    if (isDeadTrace(inlineIndex, xlineIndex)) return;
+
+    const double displacement = structure(inlineIndex, xlineIndex);
+
+    for (const auto& layer : m_layers)
+    {
+        // deeper layers are displaced more, so the layers thicken with depth
+        const double depth = layer.depth + displacement * (0.5 + layer.depth / nk);
+
+        const int k0 = std::max(0, (int)std::floor(depth) - waveletHalfLength);
+        const int k1 = std::min(nk - 1, (int)std::ceil(depth) + waveletHalfLength);
+        for (int k = k0; k <= k1; k++)
+        {
+            values[k] += (float)(layer.reflectivity * ricker(k - depth));
+        }
+    }
+
+    const std::uint64_t traceIndex = ((std::uint64_t)inlineIndex * m_size[1] + xlineIndex) * nk;
+    const float limit = amplitudeLimit();
+    for (int k = 0; k < nk; k++)
+    {
+        const float value = values[k] + (float)(noiseLevel * hashNoise(traceIndex + k, m_seed));
+        values[k] = std::clamp(value, -limit, limit);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Generate and write the whole volume, one slab of bricks at a time. Traces are generated in
+/// parallel while the previous slab is written.
+//--------------------------------------------------------------------------------------------------
+bool SyntheticVolumeGenerator::write(std::string zgyFilename)
+{
+    m_errorMessage.clear();
+
+    const int ni = m_size[0];
+    const int nj = m_size[1];
+    const int nk = m_size[2];
+
+    if ((ni <= 0) || (nj <= 0) || (nk <= 0))
+    {
+        m_errorMessage = "Invalid volume size";
+        return false;
+    }
+
+    if ((m_snr > 0.0f) && (m_sampleType != SyntheticSampleType::Float32))
+    {
+        m_errorMessage = "Compression requires float samples";
+        return false;
+    }
+
+    // 25 m bins on a grid rotated 30 degrees from north
+    const double spacing = 25.0;
+    const double angle = pi / 6.0;
+    const std::array<double, 2> origin = { 450000.0, 6780000.0 };
+    auto corner = [&](int i, int j) {
+        return std::array<double, 2>{ origin[0] + spacing * (i * std::sin(angle) + j * std::cos(angle)), origin[1] + spacing * (i * std::cos(angle) - j * std::sin(angle)) };
+    };
+
+    OpenZGY::ZgyWriterArgs args;
+    args.filename(zgyFilename)
+        .size(ni, nj, nk)
+        .bricksize(brickSize, brickSize, brickSize)
+        .ilstart(1.0f)
+        .ilinc(1.0f)
+        .xlstart(1.0f)
+        .xlinc(1.0f)
+        .zstart(0.0f)
+        .zinc(4.0f)
+        .zunit(OpenZGY::UnitDimension::time, "ms", 1000.0)
+        .hunit(OpenZGY::UnitDimension::length, "m", 1.0)
+        .corners({ corner(0, 0), corner(ni - 1, 0), corner(0, nj - 1), corner(ni - 1, nj - 1) });
+
+    const float limit = amplitudeLimit();
+    switch (m_sampleType)
+    {
+    case SyntheticSampleType::Int8:
+        args.datatype(OpenZGY::SampleDataType::int8).datarange(-limit, limit);
+        break;
+    case SyntheticSampleType::Int16:
+        args.datatype(OpenZGY::SampleDataType::int16).datarange(-limit, limit);
+        break;
+    case SyntheticSampleType::Float32:
+        args.datatype(OpenZGY::SampleDataType::float32);
+        break;
+    }
+
+    if (m_snr > 0.0f) args.zfp_compressor(m_snr);
+
+    SlabWriter slabWriter({ ni, nj, nk }, { brickSize, brickSize, brickSize }, m_memoryBudget);
+    if (!slabWriter.isValid())
+    {
+        m_errorMessage = "Memory budget exceeded";
+        return false;
+    }
+
+    try
+    {
+        auto writer = OpenZGY::IZgyWriter::open(args);
+
+        slabWriter.write(writer, [&](std::array<int, 3> start, std::array<int, 3> size, float* buffer) {
+            const int nSlabTraces = size[0] * size[1];
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int n = 0; n < nSlabTraces; n++)
+            {
+                generateTrace(start[0] + n / size[1], start[1] + n % size[1], buffer + (size_t)n * nk);
+            }
+        });
+
+        writer->finalize();
+        writer->close();
+    }
+    catch (const std::exception& err)
+    {
+        m_errorMessage = err.what();
+        return false;
+    }
+
+    return true;
+}
+
+}
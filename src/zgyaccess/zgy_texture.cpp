@@ -0,0 +1,200 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_texture.h"
+#include "zgyaccess/zgyreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace ZGYAccess
+{
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TextureBrickExporter::TextureBrickExporter(int brickSize, int border, TextureFormat format)
+    : m_brickSize(std::max(1, brickSize))
+    , m_border(std::max(0, border))
+    , m_format(format)
+    , m_useValueRange(false)
+    , m_minVal(0.0f)
+    , m_maxVal(0.0f)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TextureBrickExporter::~TextureBrickExporter()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Values outside the range are clamped. If not set, the data range of the file is used.
+//--------------------------------------------------------------------------------------------------
+void TextureBrickExporter::setValueRange(float minVal, float maxVal)
+{
+    m_useValueRange = true;
+    m_minVal = minVal;
+    m_maxVal = maxVal;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Export the sub-volume given by start and size (full resolution indices) as padded texture
+/// bricks at the given level of detail. Each brick has brickSize^3 interior samples surrounded by
+/// border samples taken from the neighbouring data, clamped at the edge of the survey. Samples are
+/// stored with z varying fastest. The bricks are converted in parallel.
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<TextureBrickSet> TextureBrickExporter::exportVolume(const ZGYReader& reader, int lod, std::array<int, 3> start, std::array<int, 3> size) const
+{
+    auto retData = std::make_unique<TextureBrickSet>();
+    retData->lod = lod;
+    retData->brickSize = m_brickSize;
+    retData->border = m_border;
+    retData->format = m_format;
+
+    const auto lodSize = reader.sizeAtLod(lod);
+    if ((lodSize[0] <= 0) || (lodSize[1] <= 0) || (lodSize[2] <= 0)) return retData;
+
+    float minVal = m_minVal;
+    float maxVal = m_maxVal;
+    if (!m_useValueRange)
+    {
+        const auto [dataMin, dataMax] = reader.dataRange();
+        minVal = (float)dataMin;
+        maxVal = (float)dataMax;
+    }
+    retData->minValue = minVal;
+    retData->maxValue = maxVal;
+
+    const int factor = 1 << lod;
+
+    std::array<int, 3> lodStart;
+    std::array<int, 3> lodEnd;
+    for (int d = 0; d < 3; d++)
+    {
+        lodStart[d] = std::clamp(start[d], 0, lodSize[d] * factor) / factor;
+        lodEnd[d] = std::min(lodSize[d], (std::max(0, start[d] + size[d]) + factor - 1) / factor);
+        if (lodEnd[d] <= lodStart[d]) return retData;
+
+        retData->brickCount[d] = (lodEnd[d] - lodStart[d] + m_brickSize - 1) / m_brickSize;
+    }
+
+    for (int i = 0; i < retData->brickCount[0]; i++)
+    {
+        for (int j = 0; j < retData->brickCount[1]; j++)
+        {
+            for (int k = 0; k < retData->brickCount[2]; k++)
+            {
+                TextureBrick brick;
+                brick.origin = { lodStart[0] + i * m_brickSize, lodStart[1] + j * m_brickSize, lodStart[2] + k * m_brickSize };
+                for (int d = 0; d < 3; d++)
+                {
+                    brick.size[d] = std::min(m_brickSize, lodEnd[d] - brick.origin[d]);
+                }
+                retData->bricks.push_back(brick);
+            }
+        }
+    }
+
+    const int nBricks = (int)retData->bricks.size();
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < nBricks; b++)
+    {
+        if (failed) continue;
+
+        TextureBrick& brick = retData->bricks[b];
+        convertBrick(reader, lod, lodSize, brick, minVal, maxVal);
+        if (brick.data.empty()) failed = true;
+    }
+
+    if (failed)
+    {
+        retData->bricks.clear();
+        retData->brickCount = { 0, 0, 0 };
+    }
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void TextureBrickExporter::convertBrick(const ZGYReader& reader, int lod, std::array<int, 3> lodSize, TextureBrick& brick, float minVal, float maxVal) const
+{
+    const int padded = m_brickSize + 2 * m_border;
+
+    std::array<int, 3> readStart;
+    std::array<int, 3> readSize;
+    for (int d = 0; d < 3; d++)
+    {
+        readStart[d] = std::max(0, brick.origin[d] - m_border);
+        readSize[d] = std::min(lodSize[d], brick.origin[d] + brick.size[d] + m_border) - readStart[d];
+    }
+
+    std::vector<float> buffer((size_t)readSize[0] * readSize[1] * readSize[2]);
+    if (!reader.readVolume(lod, readStart, readSize, buffer.data())) return;
+
+    // padded sample index -> index into the read buffer, repeating the edge where there is no data
+    std::array<std::vector<int>, 3> indexMap;
+    for (int d = 0; d < 3; d++)
+    {
+        indexMap[d].resize(padded);
+        for (int p = 0; p < padded; p++)
+        {
+            indexMap[d][p] = std::clamp(brick.origin[d] - m_border + p - readStart[d], 0, readSize[d] - 1);
+        }
+    }
+
+    const bool wide = (m_format == TextureFormat::UNorm16);
+    const float maxCode = wide ? 65535.0f : 255.0f;
+    const float scale = (maxVal > minVal) ? maxCode / (maxVal - minVal) : 0.0f;
+
+    brick.data.resize((size_t)padded * padded * padded * (wide ? 2 : 1));
+    std::uint8_t* out8 = brick.data.data();
+    std::uint16_t* out16 = reinterpret_cast<std::uint16_t*>(brick.data.data());
+
+    size_t outIndex = 0;
+    for (int pi = 0; pi < padded; pi++)
+    {
+        for (int pj = 0; pj < padded; pj++)
+        {
+            const float* srcTrace = buffer.data() + ((size_t)indexMap[0][pi] * readSize[1] + indexMap[1][pj]) * readSize[2];
+            const int* kMap = indexMap[2].data();
+
+            for (int pk = 0; pk < padded; pk++, outIndex++)
+            {
+                float code = (srcTrace[kMap[pk]] - minVal) * scale;
+                // written so that NaN ends up as zero
+                code = (code > 0.0f) ? std::min(code, maxCode) : 0.0f;
+
+                if (wide)
+                    out16[outIndex] = (std::uint16_t)(code + 0.5f);
+                else
+                    out8[outIndex] = (std::uint8_t)(code + 0.5f);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,444 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_thumbnail.h"
+#include "zgyaccess/zgyreader.h"
+#include "zgy_filestamp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <new>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    const char sidecarMagic[8] = { 'Z', 'G', 'Y', 'T', 'H', 'M', 'B', '1' };
+
+    bool writeImage(std::ofstream& file, const ThumbnailImage& image)
+    {
+        const std::int32_t sizes[2] = { image.width(), image.height() };
+
+        file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+        file.write(reinterpret_cast<const char*>(image.data()), image.byteSize());
+
+        return file.good();
+    }
+
+    bool readImage(std::ifstream& file, ThumbnailImage& image)
+    {
+        std::int32_t sizes[2] = { 0, 0 };
+        file.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+        if (!file || (sizes[0] < 0) || (sizes[1] < 0) || (sizes[0] > 65536) || (sizes[1] > 65536)) return false;
+
+        ThumbnailImage retImage(sizes[0], sizes[1]);
+        if (retImage.isOutOfMemory()) return false;
+
+        file.read(reinterpret_cast<char*>(retImage.data()), retImage.byteSize());
+        if (!file) return false;
+
+        image = std::move(retImage);
+        return true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ThumbnailImage::ThumbnailImage()
+    : m_width(0)
+    , m_height(0)
+    , m_outOfMemory(false)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ThumbnailImage::ThumbnailImage(int width, int height)
+    : m_width(width)
+    , m_height(height)
+    , m_outOfMemory(false)
+{
+    const std::int64_t bytes = (std::int64_t)width * height * 4;
+    bool allocated = false;
+
+    // counted against the memory budget as slice data, and left empty and flagged when refused
+    if ((width >= 0) && (height >= 0))
+    {
+        m_reservation = std::make_unique<MemoryReservation>(MemoryCategory::SliceData, bytes);
+
+        try
+        {
+            if (m_reservation->isValid())
+            {
+                m_rgba.resize((size_t)bytes);
+                allocated = true;
+            }
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+    }
+
+    if (!allocated)
+    {
+        m_reservation.reset();
+        m_width = 0;
+        m_height = 0;
+        m_outOfMemory = true;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ThumbnailImage::~ThumbnailImage()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int ThumbnailImage::width() const
+{
+    return m_width;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int ThumbnailImage::height() const
+{
+    return m_height;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ThumbnailImage::isEmpty() const
+{
+    return m_rgba.empty();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ThumbnailImage::isOutOfMemory() const
+{
+    return m_outOfMemory;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::uint8_t* ThumbnailImage::data()
+{
+    return m_rgba.data();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+const std::uint8_t* ThumbnailImage::data() const
+{
+    return m_rgba.data();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+size_t ThumbnailImage::byteSize() const
+{
+    return m_rgba.size();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::array<std::uint8_t, 4> ThumbnailImage::pixel(int x, int y) const
+{
+    if ((x < 0) || (x >= m_width) || (y < 0) || (y >= m_height)) return { 0, 0, 0, 0 };
+
+    const std::uint8_t* p = m_rgba.data() + ((size_t)y * m_width + x) * 4;
+    return { p[0], p[1], p[2], p[3] };
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SurveyThumbnails::isEmpty() const
+{
+    return inlineImage.isEmpty() || xlineImage.isEmpty() || zImage.isEmpty();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SurveyThumbnails::save(std::string filename, std::uint64_t sourceStamp) const
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    const std::int32_t settings[3] = { lod, maxSize, (std::int32_t)colorMap };
+    const float clip[2] = { clipMin, clipMax };
+
+    file.write(sidecarMagic, sizeof(sidecarMagic));
+    file.write(reinterpret_cast<const char*>(&sourceStamp), sizeof(sourceStamp));
+    file.write(reinterpret_cast<const char*>(settings), sizeof(settings));
+    file.write(reinterpret_cast<const char*>(&clipPercentile), sizeof(clipPercentile));
+    file.write(reinterpret_cast<const char*>(clip), sizeof(clip));
+
+    return writeImage(file, inlineImage) && writeImage(file, xlineImage) && writeImage(file, zImage);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool SurveyThumbnails::load(std::string filename, std::uint64_t sourceStamp)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) return false;
+
+    char magic[sizeof(sidecarMagic)];
+    std::uint64_t stamp = 0;
+    std::int32_t settings[3] = { 0, 0, 0 };
+    float clip[2] = { 0.0f, 0.0f };
+
+    SurveyThumbnails thumbnails;
+
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&stamp), sizeof(stamp));
+    file.read(reinterpret_cast<char*>(settings), sizeof(settings));
+    file.read(reinterpret_cast<char*>(&thumbnails.clipPercentile), sizeof(thumbnails.clipPercentile));
+    file.read(reinterpret_cast<char*>(clip), sizeof(clip));
+
+    if (!file || (std::memcmp(magic, sidecarMagic, sizeof(magic)) != 0) || (stamp != sourceStamp)) return false;
+
+    thumbnails.lod = settings[0];
+    thumbnails.maxSize = settings[1];
+    thumbnails.colorMap = (ThumbnailColorMap)settings[2];
+    thumbnails.clipMin = clip[0];
+    thumbnails.clipMax = clip[1];
+
+    if (!readImage(file, thumbnails.inlineImage) || !readImage(file, thumbnails.xlineImage) || !readImage(file, thumbnails.zImage)) return false;
+
+    *this = std::move(thumbnails);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ThumbnailGenerator::ThumbnailGenerator()
+    : m_maxSize(128)
+    , m_clipPercentile(99.0)
+    , m_colorMap(ThumbnailColorMap::Grey)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+ThumbnailGenerator::~ThumbnailGenerator()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ThumbnailGenerator::setMaxSize(int pixels)
+{
+    m_maxSize = std::max(1, pixels);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ThumbnailGenerator::setClipPercentile(double percentile)
+{
+    m_clipPercentile = std::clamp(percentile, 50.0, 100.0);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void ThumbnailGenerator::setColorMap(ThumbnailColorMap colorMap)
+{
+    m_colorMap = colorMap;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read the middle slices of the coarsest level of detail and render them. Returns an empty set
+/// if the reader is not open or a read fails.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SurveyThumbnails> ThumbnailGenerator::generate(const ZGYReader& reader) const
+{
+    auto retData = std::make_shared<SurveyThumbnails>();
+
+    const int lod = reader.lodCount() - 1;
+    if (lod < 0) return retData;
+
+    const auto size = reader.sizeAtLod(lod);
+    const std::array<std::array<int, 3>, 3> starts = { { { size[0] / 2, 0, 0 }, { 0, size[1] / 2, 0 }, { 0, 0, size[2] / 2 } } };
+    const std::array<std::array<int, 3>, 3> sizes = { { { 1, size[1], size[2] }, { size[0], 1, size[2] }, { size[0], size[1], 1 } } };
+
+    std::array<std::vector<float>, 3> samples;
+    std::vector<float> finite;
+    for (int s = 0; s < 3; s++)
+    {
+        samples[s].resize((size_t)sizes[s][0] * sizes[s][1] * sizes[s][2]);
+        if (!reader.readVolume(lod, starts[s], sizes[s], samples[s].data())) return retData;
+
+        std::copy_if(samples[s].begin(), samples[s].end(), std::back_inserter(finite), [](float v) { return std::isfinite(v); });
+    }
+
+    float clipMin = 0.0f;
+    float clipMax = 0.0f;
+    if (!finite.empty())
+    {
+        const size_t last = finite.size() - 1;
+        const size_t high = (size_t)std::llround(last * m_clipPercentile / 100.0);
+
+        std::nth_element(finite.begin(), finite.begin() + high, finite.end());
+        clipMax = finite[high];
+        std::nth_element(finite.begin(), finite.begin() + (last - high), finite.end());
+        clipMin = finite[last - high];
+
+        if (m_colorMap == ThumbnailColorMap::Seismic)
+        {
+            clipMax = std::max(std::abs(clipMin), std::abs(clipMax));
+            clipMin = -clipMax;
+        }
+    }
+
+    retData->inlineImage = render(samples[0], size[1], size[2], clipMin, clipMax);
+    retData->xlineImage = render(samples[1], size[0], size[2], clipMin, clipMax);
+    retData->zImage = render(samples[2], size[0], size[1], clipMin, clipMax);
+
+    retData->lod = lod;
+    retData->clipMin = clipMin;
+    retData->clipMax = clipMax;
+    retData->maxSize = m_maxSize;
+    retData->colorMap = m_colorMap;
+    retData->clipPercentile = m_clipPercentile;
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Scale a slice, depth fastest, so its longest side is the max size, picking the nearest sample.
+//--------------------------------------------------------------------------------------------------
+ThumbnailImage ThumbnailGenerator::render(const std::vector<float>& samples, int width, int depth, float clipMin, float clipMax) const
+{
+    if ((width <= 0) || (depth <= 0)) return ThumbnailImage();
+
+    const double scale = (double)m_maxSize / std::max(width, depth);
+    const int imageWidth = std::max(1, (int)std::lround(width * scale));
+    const int imageHeight = std::max(1, (int)std::lround(depth * scale));
+    const float range = (clipMax > clipMin) ? clipMax - clipMin : 1.0f;
+
+    ThumbnailImage image(imageWidth, imageHeight);
+    if (image.isOutOfMemory()) return image;
+
+    std::uint8_t* rgba = image.data();
+
+    for (int y = 0; y < imageHeight; y++)
+    {
+        const int d = std::min(depth - 1, (int)((y + 0.5) * depth / imageHeight));
+
+        for (int x = 0; x < imageWidth; x++, rgba += 4)
+        {
+            const int w = std::min(width - 1, (int)((x + 0.5) * width / imageWidth));
+            const float value = samples[(size_t)w * depth + d];
+
+            if (std::isnan(value))
+            {
+                rgba[0] = rgba[1] = rgba[2] = rgba[3] = 0;
+                continue;
+            }
+
+            const float t = std::clamp((value - clipMin) / range, 0.0f, 1.0f);
+
+            if (m_colorMap == ThumbnailColorMap::Seismic)
+            {
+                // blue through white to red
+                const std::uint8_t fade = (std::uint8_t)std::lround(255.0f * (t < 0.5f ? 2.0f * t : 2.0f - 2.0f * t));
+                rgba[0] = (t < 0.5f) ? fade : 255;
+                rgba[1] = fade;
+                rgba[2] = (t < 0.5f) ? 255 : fade;
+            }
+            else
+            {
+                rgba[0] = rgba[1] = rgba[2] = (std::uint8_t)std::lround(255.0f * t);
+            }
+            rgba[3] = 255;
+        }
+    }
+
+    return image;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Use the sidecar file if it matches the ZGY file and the current settings, otherwise open the
+/// file, make the thumbnails and update the sidecar.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SurveyThumbnails> ThumbnailGenerator::thumbnails(std::string filename) const
+{
+    const std::string sidecar = filename + ".thumbnails";
+    const std::uint64_t stamp = fileStamp(filename);
+
+    auto cached = std::make_shared<SurveyThumbnails>();
+    if ((stamp != 0) && cached->load(sidecar, stamp) && (cached->maxSize == m_maxSize) && (cached->colorMap == m_colorMap) && (cached->clipPercentile == m_clipPercentile))
+    {
+        return cached;
+    }
+
+    ZGYReader reader;
+    if (!reader.open(filename)) return std::make_shared<SurveyThumbnails>();
+
+    auto retData = generate(reader);
+    reader.close();
+
+    if (!retData->isEmpty() && (stamp != 0)) retData->save(sidecar, stamp);
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Thumbnails of many files, several files at a time. Files that can not be read give empty sets.
+//--------------------------------------------------------------------------------------------------
+std::vector<std::shared_ptr<SurveyThumbnails>> ThumbnailGenerator::thumbnails(const std::vector<std::string>& filenames) const
+{
+    std::vector<std::shared_ptr<SurveyThumbnails>> retData(filenames.size());
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int f = 0; f < (int)filenames.size(); f++)
+    {
+        retData[f] = thumbnails(filenames[f]);
+    }
+
+    return retData;
+}
+
+}
@@ -0,0 +1,263 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgy_tiffwriter.h"
+
+#include <cstring>
+#include <limits>
+
+namespace ZGYAccess
+{
+
+namespace
+{
+    const std::uint16_t typeAscii = 2;
+    const std::uint16_t typeShort = 3;
+    const std::uint16_t typeLong = 4;
+    const std::uint16_t typeDouble = 12;
+
+    const std::uint16_t tagImageWidth = 256;
+    const std::uint16_t tagImageLength = 257;
+    const std::uint16_t tagBitsPerSample = 258;
+    const std::uint16_t tagCompression = 259;
+    const std::uint16_t tagPhotometric = 262;
+    const std::uint16_t tagSamplesPerPixel = 277;
+    const std::uint16_t tagPlanarConfig = 284;
+    const std::uint16_t tagTileWidth = 322;
+    const std::uint16_t tagTileLength = 323;
+    const std::uint16_t tagTileOffsets = 324;
+    const std::uint16_t tagTileByteCounts = 325;
+    const std::uint16_t tagSampleFormat = 339;
+
+    void put(std::vector<std::uint8_t>& buffer, std::uint64_t value, int bytes)
+    {
+        for (int b = 0; b < bytes; b++)
+        {
+            buffer.push_back((std::uint8_t)(value >> (8 * b)));
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TiffWriter::TiffWriter()
+    : m_width(0)
+    , m_height(0)
+    , m_tileSize(0)
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TiffWriter::~TiffWriter()
+{
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Tile size must be a multiple of 16. Fails if the image cannot be addressed by a classic TIFF.
+//--------------------------------------------------------------------------------------------------
+bool TiffWriter::open(std::string filename, int width, int height, int tileSize)
+{
+    if ((width <= 0) || (height <= 0) || (tileSize <= 0) || (tileSize % 16 != 0)) return false;
+
+    const std::uint64_t tilesX = (width + tileSize - 1) / tileSize;
+    const std::uint64_t tilesY = (height + tileSize - 1) / tileSize;
+    const std::uint64_t totalBytes = tilesX * tilesY * tileSize * tileSize * sizeof(float);
+    if (totalBytes + (1 << 20) + tilesX * tilesY * 8 > std::numeric_limits<std::uint32_t>::max()) return false;
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!m_file) return false;
+
+    m_width = width;
+    m_height = height;
+    m_tileSize = tileSize;
+    m_tileOffsets.clear();
+    m_entries.clear();
+
+    // byte order, version, and a placeholder for the directory offset
+    const char header[8] = { 'I', 'I', 42, 0, 0, 0, 0, 0 };
+    m_file.write(header, sizeof(header));
+
+    return (bool)m_file;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// One full tile of tileSize * tileSize values, rows first. Values are written in host byte order,
+/// which must be little endian to match the header.
+//--------------------------------------------------------------------------------------------------
+bool TiffWriter::writeTile(const float* values)
+{
+    if (!m_file.is_open() || ((int)m_tileOffsets.size() >= tileCount())) return false;
+
+    m_tileOffsets.push_back((std::uint32_t)m_file.tellp());
+    m_file.write(reinterpret_cast<const char*>(values), (std::streamsize)m_tileSize * m_tileSize * sizeof(float));
+
+    return (bool)m_file;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int TiffWriter::tileCount() const
+{
+    if (m_tileSize == 0) return 0;
+
+    return ((m_width + m_tileSize - 1) / m_tileSize) * ((m_height + m_tileSize - 1) / m_tileSize);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void TiffWriter::setEntry(std::uint16_t tag, std::uint16_t type, std::uint32_t count, const void* data, size_t bytes)
+{
+    Entry entry;
+    entry.type = type;
+    entry.count = count;
+    entry.data.resize(bytes);
+    if (bytes > 0) std::memcpy(entry.data.data(), data, bytes);
+
+    m_entries[tag] = entry;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void TiffWriter::setShortTag(std::uint16_t tag, std::vector<std::uint16_t> values)
+{
+    std::vector<std::uint8_t> data;
+    for (auto value : values)
+    {
+        put(data, value, 2);
+    }
+    setEntry(tag, typeShort, (std::uint32_t)values.size(), data.data(), data.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void TiffWriter::setDoubleTag(std::uint16_t tag, std::vector<double> values)
+{
+    std::vector<std::uint8_t> data;
+    for (auto value : values)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        put(data, bits, 8);
+    }
+    setEntry(tag, typeDouble, (std::uint32_t)values.size(), data.data(), data.size());
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+void TiffWriter::setAsciiTag(std::uint16_t tag, std::string value)
+{
+    setEntry(tag, typeAscii, (std::uint32_t)value.size() + 1, value.c_str(), value.size() + 1);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Write the image file directory after the tiles, with values that do not fit in an entry after
+/// the directory, and point the header at it.
+//--------------------------------------------------------------------------------------------------
+bool TiffWriter::close()
+{
+    if (!m_file.is_open()) return false;
+
+    if ((int)m_tileOffsets.size() != tileCount())
+    {
+        m_file.close();
+        return false;
+    }
+
+    std::vector<std::uint8_t> data;
+    auto setLongs = [&](std::uint16_t tag, const std::vector<std::uint32_t>& values) {
+        data.clear();
+        for (auto value : values)
+        {
+            put(data, value, 4);
+        }
+        setEntry(tag, typeLong, (std::uint32_t)values.size(), data.data(), data.size());
+    };
+
+    setLongs(tagImageWidth, { (std::uint32_t)m_width });
+    setLongs(tagImageLength, { (std::uint32_t)m_height });
+    setShortTag(tagBitsPerSample, { 32 });
+    setShortTag(tagCompression, { 1 });
+    setShortTag(tagPhotometric, { 1 });
+    setShortTag(tagSamplesPerPixel, { 1 });
+    setShortTag(tagPlanarConfig, { 1 });
+    setLongs(tagTileWidth, { (std::uint32_t)m_tileSize });
+    setLongs(tagTileLength, { (std::uint32_t)m_tileSize });
+    setLongs(tagTileOffsets, m_tileOffsets);
+    setLongs(tagTileByteCounts, std::vector<std::uint32_t>(m_tileOffsets.size(), (std::uint32_t)(m_tileSize * m_tileSize * sizeof(float))));
+    setShortTag(tagSampleFormat, { 3 });
+
+    std::uint64_t directoryOffset = (std::uint64_t)m_file.tellp();
+    directoryOffset += directoryOffset % 2;
+
+    const std::uint64_t directorySize = 2 + 12 * m_entries.size() + 4;
+    std::uint64_t extraOffset = directoryOffset + directorySize;
+
+    std::vector<std::uint8_t> directory;
+    std::vector<std::uint8_t> extra;
+
+    // entries sorted by tag, as std::map keeps them
+    put(directory, m_entries.size(), 2);
+    for (auto& [tag, entry] : m_entries)
+    {
+        put(directory, tag, 2);
+        put(directory, entry.type, 2);
+        put(directory, entry.count, 4);
+
+        if (entry.data.size() <= 4)
+        {
+            directory.insert(directory.end(), entry.data.begin(), entry.data.end());
+            put(directory, 0, 4 - (int)entry.data.size());
+        }
+        else
+        {
+            put(directory, extraOffset + extra.size(), 4);
+            extra.insert(extra.end(), entry.data.begin(), entry.data.end());
+            if (extra.size() % 2) extra.push_back(0);
+        }
+    }
+    put(directory, 0, 4);
+
+    if ((directoryOffset + directory.size() + extra.size()) > std::numeric_limits<std::uint32_t>::max())
+    {
+        m_file.close();
+        return false;
+    }
+
+    if ((std::uint64_t)m_file.tellp() < directoryOffset) m_file.put(0);
+    m_file.write(reinterpret_cast<const char*>(directory.data()), directory.size());
+    m_file.write(reinterpret_cast<const char*>(extra.data()), extra.size());
+
+    std::vector<std::uint8_t> offset;
+    put(offset, directoryOffset, 4);
+    m_file.seekp(4);
+    m_file.write(reinterpret_cast<const char*>(offset.data()), offset.size());
+
+    const bool ok = (bool)m_file;
+    m_file.close();
+
+    return ok;
+}
+
+}
@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ZGYAccess
+{
+
+    // Minimal writer for little endian, uncompressed, tiled, single band float32 TIFF files. Tiles are
+    // written in row major tile order as they are produced, and the directory is written on close.
+    class TiffWriter
+    {
+    public:
+        TiffWriter();
+        ~TiffWriter();
+
+        TiffWriter(const TiffWriter&) = delete;
+        TiffWriter& operator=(const TiffWriter&) = delete;
+
+        bool open(std::string filename, int width, int height, int tileSize);
+        bool writeTile(const float* values);
+        bool close();
+
+        void setShortTag(std::uint16_t tag, std::vector<std::uint16_t> values);
+        void setDoubleTag(std::uint16_t tag, std::vector<double> values);
+        void setAsciiTag(std::uint16_t tag, std::string value);
+
+        int tileCount() const;
+
+    private:
+        class Entry
+        {
+        public:
+            std::uint16_t type = 0;
+            std::uint32_t count = 0;
+            std::vector<std::uint8_t> data;
+        };
+
+        void setEntry(std::uint16_t tag, std::uint16_t type, std::uint32_t count, const void* data, size_t bytes);
+
+    private:
+        std::ofstream m_file;
+        int m_width;
+        int m_height;
+        int m_tileSize;
+
+        std::vector<std::uint32_t> m_tileOffsets;
+        std::map<std::uint16_t, Entry> m_entries;
+    };
+
+}
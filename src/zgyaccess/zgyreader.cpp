@@ -17,16 +17,54 @@
 
 #include "zgyaccess/zgyreader.h"
 
+#include "zgy_brickcache.h"
+#include "zgy_filestamp.h"
+
 #include "exception.h"
 #include "api.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace ZGYAccess
 {
 
+namespace
+{
+    // brick cache that gives its bricks back when the memory governor runs short
+    std::shared_ptr<BrickCache> makeBrickCache(size_t maxBricks)
+    {
+        auto cache = std::make_shared<BrickCache>(maxBricks);
+        MemoryGovernor::instance().addReclaimer(cache);
+        return cache;
+    }
+
+    // owns the open file on behalf of a reader and all of its clones, and closes it once the
+    // last of them lets go
+    struct ReaderOwner
+    {
+        std::shared_ptr<OpenZGY::IZgyReader> reader;
+
+        ~ReaderOwner()
+        {
+            if (reader == nullptr) return;
+
+            try
+            {
+                reader->close();
+            }
+            catch (const std::exception&)
+            {
+            }
+        }
+    };
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
 ZGYReader::ZGYReader()
+    : m_brickCache(makeBrickCache(64))
 {
 
 }
@@ -48,7 +86,9 @@ bool ZGYReader::open(std::string filename)
 
     try
     {
-        m_reader = OpenZGY::IZgyReader::open(filename);
+        auto owner = std::make_shared<ReaderOwner>();
+        owner->reader = OpenZGY::IZgyReader::open(filename);
+        m_reader = std::shared_ptr<OpenZGY::IZgyReader>(owner, owner->reader.get());
     }
     catch (const std::exception&)
     {
@@ -56,6 +96,8 @@ bool ZGYReader::open(std::string filename)
         return false;
     }
 
+    m_filename = filename;
+
     return true;
 }
 
@@ -66,19 +108,43 @@ void ZGYReader::close()
 {
     if (m_reader == nullptr) return;
 
-    try
-    {
-        m_reader->close();
-    }
-    catch (const std::exception&)
-    {
-    }
+    // the file and the brick cache stay open until the last clone using them is closed
+    m_brickCache = makeBrickCache(m_brickCache->maxBricks());
 
     m_reader = nullptr;
+    m_filename.clear();
+    m_liveTraceMask = nullptr;
 
     return;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Name of the open file, empty when closed.
+//--------------------------------------------------------------------------------------------------
+std::string ZGYReader::filename() const
+{
+    return m_filename;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// New handle to the same open file, for use on another thread. The clone shares the parsed
+/// headers and lookup tables, the brick cache and the live trace mask with this reader, but has
+/// its own histogram and lazily computed state, so each thread can use its own handle without
+/// locking. The file is closed when the last handle is closed. Returns nullptr if not open.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<ZGYReader> ZGYReader::clone() const
+{
+    if (m_reader == nullptr) return nullptr;
+
+    auto retReader = std::make_shared<ZGYReader>();
+    retReader->m_filename = m_filename;
+    retReader->m_reader = m_reader;
+    retReader->m_liveTraceMask = m_liveTraceMask;
+    retReader->m_brickCache = m_brickCache;
+
+    return retReader;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -329,6 +395,134 @@ std::pair<double, double> ZGYReader::dataRange() const
     return std::make_pair(datarange[0], datarange[1]);
 }
 
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int ZGYReader::lodCount() const
+{
+    if (m_reader == nullptr) return 0;
+
+    return (int)m_reader->nlods();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+std::array<int, 3> ZGYReader::brickSize() const
+{
+    if (m_reader == nullptr) return { 0, 0, 0 };
+
+    const auto bricksize = m_reader->bricksize();
+    return { (int)bricksize[0], (int)bricksize[1], (int)bricksize[2] };
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Number of samples in each direction at the given level of detail. Each level halves the
+/// resolution, rounding up.
+//--------------------------------------------------------------------------------------------------
+std::array<int, 3> ZGYReader::sizeAtLod(int lod) const
+{
+    if ((m_reader == nullptr) || (lod < 0) || (lod >= lodCount())) return { 0, 0, 0 };
+
+    const auto totalsize = m_reader->size();
+    const std::int64_t factor = std::int64_t(1) << lod;
+
+    std::array<int, 3> retval;
+    for (int i = 0; i < 3; i++)
+    {
+        retval[i] = (int)((totalsize[i] + factor - 1) / factor);
+    }
+    return retval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read a box of samples at the given level of detail into buffer, which must hold
+/// size[0]*size[1]*size[2] floats. Samples are stored with z varying fastest. The indices are
+/// given in the index space of that level. Safe to call from several threads at once.
+//--------------------------------------------------------------------------------------------------
+bool ZGYReader::readVolume(int lod, std::array<int, 3> start, std::array<int, 3> size, float* buffer) const
+{
+    if ((m_reader == nullptr) || (buffer == nullptr)) return false;
+
+    OpenZGY::IZgyMeta::size3i_t readStart = { start[0], start[1], start[2] };
+    OpenZGY::IZgyMeta::size3i_t readSize = { size[0], size[1], size[2] };
+
+    try
+    {
+        m_reader->read(readStart, readSize, buffer, lod);
+    }
+    catch (OpenZGY::Errors::ZgyError& err)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Full resolution brick from the cache, decoded and cached on a miss.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<const DecodedBrick> ZGYReader::decodedBrick(std::array<int, 3> brickIndex) const
+{
+    auto cached = m_brickCache->find(brickIndex);
+    if (cached != nullptr) return cached;
+
+    const auto bricksize = brickSize();
+    const auto size = sizeAtLod(0);
+
+    auto brick = std::make_shared<DecodedBrick>();
+    for (int d = 0; d < 3; d++)
+    {
+        brick->start[d] = brickIndex[d] * bricksize[d];
+        brick->size[d] = std::min(bricksize[d], size[d] - brick->start[d]);
+        if (brick->size[d] <= 0) return nullptr;
+    }
+
+    const std::int64_t nSamples = (std::int64_t)brick->size[0] * brick->size[1] * brick->size[2];
+    brick->reservation = std::make_unique<MemoryReservation>(MemoryCategory::DecodedBricks, nSamples * (std::int64_t)sizeof(float));
+    if (!brick->reservation->isValid()) return nullptr;
+
+    brick->samples.resize((size_t)brick->size[0] * brick->size[1] * brick->size[2]);
+    if (!readVolume(0, brick->start, brick->size, brick->samples.data())) return nullptr;
+
+    return m_brickCache->insert(brickIndex, brick);
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Maximum number of decoded full resolution bricks kept for slice views. Zero disables caching.
+/// Each live inline slice view adds room for the bricks it covers, which is given back when the
+/// view is released.
+//--------------------------------------------------------------------------------------------------
+void ZGYReader::setBrickCacheSize(int bricks)
+{
+    m_brickCache->setMaxBricks((size_t)std::max(0, bricks));
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Check if a box of samples is stored as a constant value, without decompressing any data.
+//--------------------------------------------------------------------------------------------------
+bool ZGYReader::isConstant(int lod, std::array<int, 3> start, std::array<int, 3> size, float& value) const
+{
+    if (m_reader == nullptr) return false;
+
+    OpenZGY::IZgyMeta::size3i_t readStart = { start[0], start[1], start[2] };
+    OpenZGY::IZgyMeta::size3i_t readSize = { size[0], size[1], size[2] };
+
+    try
+    {
+        const auto [isConst, constValue] = m_reader->readconst(readStart, readSize, lod, true);
+        if (!isConst) return false;
+
+        value = (float)constValue;
+    }
+    catch (OpenZGY::Errors::ZgyError& err)
+    {
+        return false;
+    }
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -354,6 +548,195 @@ HistogramData* ZGYReader::histogram()
     return &m_histogram;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Statistics stored in the file when it was written, without reading any samples.
+//--------------------------------------------------------------------------------------------------
+SampleStatistics ZGYReader::storedStatistics() const
+{
+    SampleStatistics retval;
+    if (m_reader == nullptr) return retval;
+
+    const auto stats = m_reader->statistics();
+    if (stats.cnt == 0) return retval;
+
+    retval.count = stats.cnt;
+    retval.sum = stats.sum;
+    retval.sumSquares = stats.ssq;
+    retval.minValue = stats.min;
+    retval.maxValue = stats.max;
+
+    return retval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Statistics of the samples inside the mask, within the given z range.
+//--------------------------------------------------------------------------------------------------
+SampleStatistics ZGYReader::statistics(const OutlineMask& mask, int zStartIndex, int zSize) const
+{
+    SampleStatistics retval;
+
+    const auto columns = maskedBrickColumns(mask);
+    const int nColumns = (int)columns.size();
+
+    std::vector<SampleStatistics> columnStats(nColumns);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nColumns; c++)
+    {
+        if (failed) continue;
+
+        auto& stats = columnStats[c];
+        if (!readMaskedColumn(mask, columns[c], zStartIndex, zSize, [&stats](const float* values, size_t nValues) { stats.add(values, nValues); }))
+        {
+            failed = true;
+        }
+    }
+
+    if (failed) return retval;
+
+    for (auto& stats : columnStats)
+    {
+        retval.merge(stats);
+    }
+
+    return retval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Histogram of the samples inside the mask, within the given z range, binned over the data
+/// range of the file.
+//--------------------------------------------------------------------------------------------------
+std::unique_ptr<HistogramData> ZGYReader::histogram(const OutlineMask& mask, int nBins, int zStartIndex, int zSize) const
+{
+    auto retData = std::make_unique<HistogramData>();
+
+    const auto [minVal, maxVal] = dataRange();
+
+    const auto columns = maskedBrickColumns(mask);
+    const int nColumns = (int)columns.size();
+
+    std::vector<std::unique_ptr<HistogramData>> columnHistograms(nColumns);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nColumns; c++)
+    {
+        if (failed) continue;
+
+        HistogramGenerator generator(nBins, (float)minVal, (float)maxVal);
+        std::vector<float> values;
+
+        if (!readMaskedColumn(mask, columns[c], zStartIndex, zSize, [&values](const float* data, size_t nValues) { values.insert(values.end(), data, data + nValues); }))
+        {
+            failed = true;
+            continue;
+        }
+
+        generator.addData(values);
+        columnHistograms[c] = generator.getHistogram();
+    }
+
+    if (failed) return retData;
+
+    for (auto& hist : columnHistograms)
+    {
+        if (hist == nullptr) continue;
+
+        if (retData->Xvalues.empty())
+        {
+            *retData = *hist;
+            continue;
+        }
+
+        for (size_t i = 0; i < hist->Yvalues.size(); i++)
+        {
+            retData->Yvalues[i] += hist->Yvalues[i];
+        }
+    }
+
+    return retData;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// The brick columns (inline and crossline brick numbers) that have at least one trace inside
+/// the mask.
+//--------------------------------------------------------------------------------------------------
+std::vector<std::array<int, 2>> ZGYReader::maskedBrickColumns(const OutlineMask& mask) const
+{
+    std::vector<std::array<int, 2>> retval;
+
+    if ((m_reader == nullptr) || (mask.inlineSize() != inlineSize()) || (mask.xlineSize() != xlineSize())) return retval;
+
+    const auto bricksize = brickSize();
+
+    for (int i0 = 0; i0 < inlineSize(); i0 += bricksize[0])
+    {
+        for (int j0 = 0; j0 < xlineSize(); j0 += bricksize[1])
+        {
+            if (mask.coverage(i0, bricksize[0], j0, bricksize[1]) == OutlineMask::Coverage::Outside) continue;
+
+            retval.push_back({ i0 / bricksize[0], j0 / bricksize[1] });
+        }
+    }
+
+    return retval;
+}
+
+//--------------------------------------------------------------------------------------------------
+/// Read one brick column, one brick at a time in z, and pass the samples inside the mask to the
+/// callback. Columns fully inside the mask are passed on a brick at a time, otherwise one trace
+/// segment at a time.
+//--------------------------------------------------------------------------------------------------
+bool ZGYReader::readMaskedColumn(const OutlineMask& mask, std::array<int, 2> column, int zStartIndex, int zSize, const std::function<void(const float*, size_t)>& callback) const
+{
+    const auto bricksize = brickSize();
+
+    const int i0 = column[0] * bricksize[0];
+    const int j0 = column[1] * bricksize[1];
+    const int ni = std::min(bricksize[0], inlineSize() - i0);
+    const int nj = std::min(bricksize[1], xlineSize() - j0);
+
+    const int zStart = std::max(0, zStartIndex);
+    const int zEnd = std::min(this->zSize(), zStartIndex + zSize);
+
+    const bool allInside = (mask.coverage(i0, ni, j0, nj) == OutlineMask::Coverage::Inside);
+
+    std::vector<float> buffer;
+
+    for (int z0 = zStart; z0 < zEnd; z0 = (z0 / bricksize[2] + 1) * bricksize[2])
+    {
+        const int nz = std::min((z0 / bricksize[2] + 1) * bricksize[2], zEnd) - z0;
+
+        buffer.resize((size_t)ni * nj * nz);
+        if (!readVolume(0, { i0, j0, z0 }, { ni, nj, nz }, buffer.data())) return false;
+
+        if (allInside)
+        {
+            callback(buffer.data(), buffer.size());
+            continue;
+        }
+
+        for (int i = 0; i < ni; i++)
+        {
+            for (auto& [first, last] : mask.spans(i0 + i))
+            {
+                const int lo = std::max(first, j0);
+                const int hi = std::min(last, j0 + nj - 1);
+                if (hi < lo) continue;
+
+                callback(buffer.data() + ((size_t)i * nj + (lo - j0)) * nz, (size_t)(hi - lo + 1) * nz);
+            }
+        }
+    }
+
+    return true;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -373,6 +756,39 @@ Outline ZGYReader::seismicWorldOutline()
     return retval;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Which traces hold data. Computed on first use and stored in a sidecar file next to the ZGY
+/// file, so that later opens of the same file can reuse it.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<const LiveTraceMask> ZGYReader::liveTraceMask()
+{
+    if (m_liveTraceMask != nullptr) return m_liveTraceMask;
+    if (m_reader == nullptr) return std::make_shared<LiveTraceMask>();
+
+    const std::string sidecar = m_filename + ".livemask";
+    const std::uint64_t stamp = fileStamp(m_filename);
+
+    auto mask = std::make_shared<LiveTraceMask>();
+    if ((stamp == 0) || !mask->load(sidecar, stamp) || (mask->inlineSize() != inlineSize()) || (mask->xlineSize() != xlineSize()))
+    {
+        mask = LiveTraceMask::compute(*this);
+        if (mask->isEmpty()) return mask;
+
+        if (stamp != 0) mask->save(sidecar, stamp);
+    }
+
+    m_liveTraceMask = mask;
+    return m_liveTraceMask;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+bool ZGYReader::isLiveTrace(int inlineIndex, int xlineIndex)
+{
+    return liveTraceMask()->isLive(inlineIndex, xlineIndex);
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -401,6 +817,20 @@ std::pair<int, int> ZGYReader::toInlineXline(double worldX, double worldY) const
     return std::make_pair((int)std::round(indexCoord[0]), (int)std::round(indexCoord[1]));
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Fractional inline and crossline grid indices (not annotation values) of a world position.
+//--------------------------------------------------------------------------------------------------
+std::pair<double, double> ZGYReader::toInlineXlineIndex(double worldX, double worldY) const
+{
+    if (m_reader == nullptr) return { 0, 0 };
+
+    std::array<double, 2> worldCoord{ worldX, worldY };
+
+    auto indexCoord = m_reader->worldToIndex(worldCoord);
+
+    return std::make_pair(indexCoord[0], indexCoord[1]);
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -420,6 +850,7 @@ std::shared_ptr<SeismicSliceData> ZGYReader::inlineSlice(int inlineIndex, int zS
     int depth = zSize;
 
     std::shared_ptr<SeismicSliceData> retData = std::make_shared<SeismicSliceData>(width, depth);
+    if (retData->isEmpty()) return retData;
 
     OpenZGY::IZgyMeta::size3i_t sliceStart = { inlineIndex, 0, zStartIndex };
     OpenZGY::IZgyMeta::size3i_t sliceSize = { 1, width, depth };
@@ -436,6 +867,43 @@ std::shared_ptr<SeismicSliceData> ZGYReader::inlineSlice(int inlineIndex, int zS
     return retData;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Inline z window backed by cached decoded bricks, so no samples are copied. Windows starting and
+/// ending on brick boundaries decode no samples outside the window.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceView> ZGYReader::inlineSliceView(int inlineIndex, int zStartIndex, int zSize)
+{
+    if ((m_reader == nullptr) || (inlineIndex < 0) || (inlineIndex >= inlineSize()) || (zStartIndex < 0) || (zSize <= 0) || (zStartIndex + zSize > this->zSize()))
+        return std::make_shared<SeismicSliceView>();
+
+    const auto bricksize = brickSize();
+    const int bi = inlineIndex / bricksize[0];
+    const int nbj = (xlineSize() + bricksize[1] - 1) / bricksize[1];
+    const int bk0 = zStartIndex / bricksize[2];
+    const int nbk = (zStartIndex + zSize - 1) / bricksize[2] - bk0 + 1;
+    const int nBricks = nbj * nbk;
+
+    // the cache keeps room for the bricks of the window while the view lives, so the neighbouring
+    // inlines are served without decoding
+    auto cacheHold = m_brickCache->holdCapacity((size_t)nBricks);
+
+    std::vector<std::shared_ptr<const DecodedBrick>> bricks(nBricks);
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int b = 0; b < nBricks; b++)
+    {
+        bricks[b] = decodedBrick({ bi, b / nbk, bk0 + b % nbk });
+        if (bricks[b] == nullptr) failed = true;
+    }
+
+    if (failed) return std::make_shared<SeismicSliceView>();
+
+    return std::make_shared<SeismicSliceView>(inlineIndex, zStartIndex, zSize, xlineSize(), bricksize, std::move(bricks), std::move(cacheHold));
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -455,6 +923,7 @@ std::shared_ptr<SeismicSliceData> ZGYReader::xlineSlice(int xlineIndex, int zSta
     int depth = zSize;
 
     std::shared_ptr<SeismicSliceData> retData = std::make_shared<SeismicSliceData>(width, depth);
+    if (retData->isEmpty()) return retData;
 
     OpenZGY::IZgyMeta::size3i_t sliceStart = { 0, xlineIndex, zStartIndex };
     OpenZGY::IZgyMeta::size3i_t sliceSize = { width, 1, depth };
@@ -482,6 +951,7 @@ std::shared_ptr<SeismicSliceData> ZGYReader::zSlice(int zIndex)
     int widthX = xlineSize();
 
     std::shared_ptr<SeismicSliceData> retData = std::make_shared<SeismicSliceData>(widthI, widthX);
+    if (retData->isEmpty()) return retData;
 
     OpenZGY::IZgyMeta::size3i_t sliceStart = { 0, 0, zIndex };
     OpenZGY::IZgyMeta::size3i_t sliceSize = { widthI, widthX, 1 };
@@ -498,6 +968,69 @@ std::shared_ptr<SeismicSliceData> ZGYReader::zSlice(int zIndex)
     return retData;
 }
 
+//--------------------------------------------------------------------------------------------------
+/// Z slice where only the traces inside the mask are read. Bricks completely outside the mask are
+/// skipped, and samples outside the mask are set to fillValue.
+//--------------------------------------------------------------------------------------------------
+std::shared_ptr<SeismicSliceData> ZGYReader::zSlice(int zIndex, const OutlineMask& mask, float fillValue)
+{
+    if (m_reader == nullptr) return std::make_shared<SeismicSliceData>(0, 0);
+
+    const int widthI = inlineSize();
+    const int widthX = xlineSize();
+
+    if ((mask.inlineSize() != widthI) || (mask.xlineSize() != widthX) || (zIndex < 0) || (zIndex >= zSize()))
+        return std::make_shared<SeismicSliceData>(0, 0);
+
+    std::shared_ptr<SeismicSliceData> retData = std::make_shared<SeismicSliceData>(widthI, widthX);
+    if (retData->isEmpty()) return retData;
+
+    std::fill(retData->values(), retData->values() + retData->size(), fillValue);
+
+    const auto columns = maskedBrickColumns(mask);
+    const int nColumns = (int)columns.size();
+    const auto bricksize = brickSize();
+    float* output = retData->values();
+
+    std::atomic<bool> failed(false);
+
+#ifdef USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int c = 0; c < nColumns; c++)
+    {
+        if (failed) continue;
+
+        const int i0 = columns[c][0] * bricksize[0];
+        const int j0 = columns[c][1] * bricksize[1];
+        const int ni = std::min(bricksize[0], widthI - i0);
+        const int nj = std::min(bricksize[1], widthX - j0);
+
+        std::vector<float> buffer((size_t)ni * nj);
+        if (!readVolume(0, { i0, j0, zIndex }, { ni, nj, 1 }, buffer.data()))
+        {
+            failed = true;
+            continue;
+        }
+
+        for (int i = 0; i < ni; i++)
+        {
+            for (auto& [first, last] : mask.spans(i0 + i))
+            {
+                const int lo = std::max(first, j0);
+                const int hi = std::min(last, j0 + nj - 1);
+                if (hi < lo) continue;
+
+                std::copy(buffer.data() + (size_t)i * nj + (lo - j0), buffer.data() + (size_t)i * nj + (hi - j0) + 1, output + (size_t)(i0 + i) * widthX + lo);
+            }
+        }
+    }
+
+    if (failed) retData->reset();
+
+    return retData;
+}
+
 //--------------------------------------------------------------------------------------------------
 ///
 //--------------------------------------------------------------------------------------------------
@@ -514,6 +1047,7 @@ std::shared_ptr<SeismicSliceData> ZGYReader::zTrace(int inlineIndex, int xlineIn
     if (m_reader == nullptr) return std::make_shared<SeismicSliceData>(0, 0);
 
     std::shared_ptr<SeismicSliceData> retData = std::make_shared<SeismicSliceData>(1, zSize);
+    if (retData->isEmpty()) return retData;
 
     OpenZGY::IZgyMeta::size3i_t sliceStart = { inlineIndex, xlineIndex, zStartIndex };
     OpenZGY::IZgyMeta::size3i_t sliceSize = { 1, 1, zSize };
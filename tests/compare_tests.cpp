@@ -0,0 +1,130 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_compare.h"
+#include "zgyaccess/zgy_segy.h"
+#include "zgyaccess/zgy_segyexport.h"
+#include "zgyaccess/zgy_segyimport.h"
+#include "testdatafolder.h"
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(compare_tests, testCompareIdentical)
+{
+    ZGYAccess::ZGYReader first;
+    ASSERT_TRUE(first.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::ZGYReader second;
+    ASSERT_TRUE(second.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::VolumeComparator comparator;
+    auto result = comparator.compare(first, second);
+
+    ASSERT_TRUE(result.isIdentical());
+    ASSERT_EQ(result.comparedSamples, 112 * 64 * 176);
+    ASSERT_EQ(result.maxDifference, 0.0);
+    ASSERT_EQ(result.rmsDifference, 0.0);
+    ASSERT_TRUE(result.regions.empty());
+
+    // identical bytes settle the comparison without reading any brick
+    ASSERT_TRUE(result.identicalFiles);
+    ASSERT_EQ(result.constantBricks + result.decodedBricks, 0);
+
+    ZGYAccess::ZGYReader closed;
+    ASSERT_FALSE(comparator.compare(first, closed).sameSize);
+
+    first.close();
+    second.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(compare_tests, testCompareModified)
+{
+    const auto folder = std::filesystem::temp_directory_path();
+    const std::string segyFile = (folder / "compare_tests.segy").string();
+    const std::string zgyFile = (folder / "compare_tests.zgy").string();
+
+    ZGYAccess::ZGYReader source;
+    ASSERT_TRUE(source.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::SegyExporter exporter;
+    ASSERT_TRUE(exporter.exportToFile(source, segyFile)) << exporter.errorMessage();
+
+    // change one sample of inline index 70, crossline index 10 by +5
+    const int i = 70, j = 10, k = 100;
+    const float modified = source.zTrace(i, j)->valueAt(0, k) + 5.0f;
+    {
+        const std::int64_t traceBytes = 240 + 4 * source.zSize();
+        std::uint8_t bytes[4];
+        ZGYAccess::SegyFormat::fromFloat(&modified, ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, 1, bytes);
+
+        std::fstream file(segyFile, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(3600 + ((std::int64_t)i * source.xlineSize() + j) * traceBytes + 240 + 4 * k);
+        file.write(reinterpret_cast<const char*>(bytes), 4);
+    }
+
+    ZGYAccess::SegyImporter importer;
+    ASSERT_TRUE(importer.import(segyFile, zgyFile)) << importer.errorMessage();
+
+    ZGYAccess::ZGYReader copy;
+    ASSERT_TRUE(copy.open(zgyFile));
+
+    ZGYAccess::VolumeComparator comparator;
+    auto result = comparator.compare(source, copy);
+
+    ASSERT_TRUE(result.sameSize);
+    ASSERT_FALSE(result.isIdentical());
+    ASSERT_FALSE(result.identicalFiles);
+    ASSERT_EQ(result.constantBricks + result.decodedBricks, 2 * 1 * 3);
+    ASSERT_EQ(result.differingSamples, 1);
+    ASSERT_NEAR(result.maxDifference, 5.0, 1e-4);
+    ASSERT_NEAR(result.rmsDifference, 5.0 / std::sqrt(112.0 * 64 * 176), 1e-6);
+
+    ASSERT_EQ(result.regions.size(), 1);
+    const auto& region = result.regions[0];
+    ASSERT_EQ(region.differingSamples, 1);
+    for (int d = 0; d < 3; d++)
+    {
+        const int index = (d == 0) ? i : ((d == 1) ? j : k);
+        ASSERT_LE(region.start[d], index);
+        ASSERT_LT(index, region.start[d] + region.size[d]);
+    }
+
+    comparator.setTolerance(10.0);
+    result = comparator.compare(source, copy);
+    ASSERT_EQ(result.differingSamples, 0);
+    ASSERT_TRUE(result.regions.empty());
+    ASSERT_NEAR(result.maxDifference, 5.0, 1e-4);
+
+    copy.close();
+    source.close();
+
+    std::filesystem::remove(segyFile);
+    std::filesystem::remove(zgyFile);
+}
@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_compressionadvisor.h"
+#include "testdatafolder.h"
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(compression_tests, testEstimateAccuracy)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::CompressionAdvisor advisor;
+    advisor.setSampleBrickCount(4);
+
+    auto estimates = advisor.estimateAccuracy(reader, { 0.2, 0.06, 0.02 });
+    ASSERT_EQ(estimates.size(), 3);
+    ASSERT_EQ(advisor.sampledBrickCount(), 4);
+
+    for (size_t n = 0; n < estimates.size(); n++)
+    {
+        ASSERT_GT(estimates[n].compressionRatio, 1.0);
+        if (n > 0)
+        {
+            ASSERT_LT(estimates[n].compressionRatio, estimates[n - 1].compressionRatio);
+            ASSERT_LT(estimates[n].rmsError, estimates[n - 1].rmsError);
+            ASSERT_GT(estimates[n].snr, estimates[n - 1].snr);
+        }
+    }
+
+    // the same seed gives the same bricks and the same sizes
+    auto again = advisor.estimateAccuracy(reader, { 0.06 });
+    ASSERT_EQ(again.size(), 1);
+    ASSERT_DOUBLE_EQ(again[0].compressionRatio, estimates[1].compressionRatio);
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(compression_tests, testEstimateBitRate)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::CompressionAdvisor advisor;
+    advisor.setSampleBrickCount(1000);
+
+    auto estimates = advisor.estimateBitRate(reader, { 4.0, 8.0 });
+    ASSERT_EQ(estimates.size(), 2);
+    ASSERT_EQ(advisor.sampledBrickCount(), 2 * 1 * 3);
+
+    // constant bricks and headers aside, fixed rate gives 32 / rate
+    ASSERT_GT(estimates[0].compressionRatio, 32.0 / 4.0 * 0.9);
+    ASSERT_GT(estimates[1].compressionRatio, 32.0 / 8.0 * 0.9);
+    ASSERT_GT(estimates[0].rmsError, estimates[1].rmsError);
+    ASSERT_GT(estimates[0].decodeSpeed, 0.0);
+
+    ZGYAccess::ZGYReader closed;
+    ASSERT_TRUE(advisor.estimateAccuracy(closed, { 0.06 }).empty());
+
+    reader.close();
+}
@@ -0,0 +1,149 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_contour.h"
+#include "testdatafolder.h"
+
+namespace
+{
+    // distance from the centre of the grid
+    std::shared_ptr<ZGYAccess::SeismicSliceData> makeCone(int size)
+    {
+        auto grid = std::make_shared<ZGYAccess::SeismicSliceData>(size, size);
+        const double centre = (size - 1) / 2.0;
+        for (int i = 0; i < size; i++)
+        {
+            for (int j = 0; j < size; j++)
+            {
+                grid->values()[i * size + j] = (float)std::hypot(i - centre, j - centre);
+            }
+        }
+        return grid;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(contour_tests, testClosedContours)
+{
+    auto grid = makeCone(41);
+
+    // small tiles, so that every circle is stitched from several tiles
+    ZGYAccess::ContourGenerator generator({ 5.0, 10.0, 15.0 });
+    generator.setTileSize(8);
+    auto lines = generator.contours(grid);
+
+    ASSERT_EQ(lines.size(), 3);
+    for (auto& line : lines)
+    {
+        ASSERT_TRUE(line.closed);
+        ASSERT_GT(line.points.size(), 8);
+        for (auto& p : line.points)
+        {
+            ASSERT_NEAR(std::hypot(p.x() - 20.0, p.y() - 20.0), line.level, 0.2);
+        }
+    }
+
+    // simplification keeps the shape within the tolerance with fewer points
+    generator.setSimplifyTolerance(0.5);
+    auto simplified = generator.contours(grid);
+    ASSERT_EQ(simplified.size(), 3);
+    for (size_t l = 0; l < lines.size(); l++)
+    {
+        ASSERT_TRUE(simplified[l].closed);
+        ASSERT_LT(simplified[l].points.size(), lines[l].points.size());
+        ASSERT_GE(simplified[l].points.size(), 3);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(contour_tests, testUndefinedCells)
+{
+    auto grid = makeCone(41);
+
+    // a band of undefined values cuts every circle into two open lines
+    for (int j = 0; j < 41; j++)
+    {
+        grid->values()[20 * 41 + j] = std::numeric_limits<float>::quiet_NaN();
+    }
+
+    ZGYAccess::ContourGenerator generator({ 10.0 });
+    generator.setTileSize(16);
+    auto lines = generator.contours(grid);
+
+    ASSERT_EQ(lines.size(), 2);
+    for (auto& line : lines)
+    {
+        ASSERT_FALSE(line.closed);
+        for (auto& p : line.points)
+        {
+            ASSERT_TRUE((p.x() <= 19.0) || (p.x() >= 21.0));
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(contour_tests, testWorldCoordinates)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto slice = reader.zSlice(100);
+    const auto [minVal, maxVal] = reader.dataRange();
+
+    ZGYAccess::ContourGenerator generator({ std::floor((minVal + maxVal) / 2) + 0.5 });
+    generator.setTileSize(32);
+    auto indexLines = generator.contours(slice);
+    auto worldLines = generator.contours(reader, slice);
+
+    ASSERT_FALSE(worldLines.empty());
+    ASSERT_EQ(worldLines.size(), indexLines.size());
+
+    // a point on an inline index maps to the world position of that inline
+    for (size_t l = 0; l < worldLines.size(); l++)
+    {
+        ASSERT_EQ(worldLines[l].points.size(), indexLines[l].points.size());
+
+        for (size_t p = 0; p < indexLines[l].points.size(); p++)
+        {
+            const auto& indexPoint = indexLines[l].points[p];
+            if (indexPoint.x() != std::floor(indexPoint.x())) continue;
+
+            const auto [i, j] = reader.toInlineXlineIndex(worldLines[l].points[p].x(), worldLines[l].points[p].y());
+            ASSERT_NEAR(i, indexPoint.x(), 1e-6);
+            ASSERT_NEAR(j, indexPoint.y(), 1e-6);
+        }
+    }
+
+    ASSERT_TRUE(generator.contours(reader, std::make_shared<ZGYAccess::SeismicSliceData>(3, 3)).empty());
+
+    reader.close();
+}
@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/seismicslice.h"
+#include "zgyaccess/zgy_sliceencoding.h"
+#include "testdatafolder.h"
+
+using ZGYAccess::SliceCodec;
+using ZGYAccess::SliceEncoder;
+
+namespace
+{
+    void putU32(std::vector<std::uint8_t>& buffer, std::uint32_t value)
+    {
+        for (int b = 0; b < 4; b++) buffer.push_back((std::uint8_t)(value >> (8 * b)));
+    }
+
+    // fixed header of an encoded slice, as a sender that can not be trusted would write it
+    std::vector<std::uint8_t> craftedHeader(SliceCodec codec, std::uint32_t width, std::uint32_t depth, std::uint32_t tileTraces)
+    {
+        std::vector<std::uint8_t> buffer = { 'Z', 'G', 'Y', 'S', 1, (std::uint8_t)codec, 0, 0 };
+        putU32(buffer, width);
+        putU32(buffer, depth);
+        putU32(buffer, tileTraces);
+        return buffer;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(encoding_tests, testLosslessRoundTrip)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    SliceEncoder encoder;
+    encoder.setTileTraces(20);
+
+    for (auto slice : { reader.inlineSlice(70), reader.zSlice(130) })
+    {
+        const size_t rawBytes = (size_t)slice->size() * sizeof(float);
+
+        auto encoded = encoder.encodeLossless(slice);
+        ASSERT_FALSE(encoded.empty());
+        ASSERT_LT(encoded.size(), rawBytes / 2);
+
+        SliceCodec codec;
+        int width, depth;
+        ASSERT_TRUE(SliceEncoder::readHeader(encoded.data(), encoded.size(), codec, width, depth));
+        ASSERT_EQ(codec, SliceCodec::Lossless);
+        ASSERT_EQ(width, slice->width());
+        ASSERT_EQ(depth, slice->depth());
+
+        auto decoded = SliceEncoder::decode(encoded.data(), encoded.size());
+        ASSERT_EQ(decoded->width(), slice->width());
+        ASSERT_EQ(decoded->depth(), slice->depth());
+        ASSERT_EQ(std::memcmp(decoded->values(), slice->values(), rawBytes), 0);
+
+        // truncated buffers are rejected
+        ASSERT_TRUE(SliceEncoder::decode(encoded.data(), encoded.size() - 1)->isEmpty());
+    }
+
+    reader.close();
+
+    // bit exact for NaN and signed zero too
+    auto special = std::make_shared<ZGYAccess::SeismicSliceData>(3, 2);
+    const float values[] = { 0.0f, -0.0f, std::numeric_limits<float>::quiet_NaN(), -1.5f, 1e30f, -0.0f };
+    std::memcpy(special->values(), values, sizeof(values));
+
+    auto encoded = encoder.encodeLossless(special);
+    auto decoded = SliceEncoder::decode(encoded.data(), encoded.size());
+    ASSERT_EQ(std::memcmp(decoded->values(), values, sizeof(values)), 0);
+
+    // too many distinct values
+    auto ramp = std::make_shared<ZGYAccess::SeismicSliceData>(300, 300);
+    for (int n = 0; n < ramp->size(); n++) ramp->values()[n] = (float)n;
+    ASSERT_TRUE(encoder.encodeLossless(ramp).empty());
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(encoding_tests, testZfpRoundTrip)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    const auto [minVal, maxVal] = reader.dataRange();
+    const double tolerance = (maxVal - minVal) / 100;
+
+    auto slice = reader.inlineSlice(70);
+    const size_t rawBytes = (size_t)slice->size() * sizeof(float);
+
+    SliceEncoder encoder;
+    auto encoded = encoder.encodeZfp(slice, tolerance);
+    ASSERT_FALSE(encoded.empty());
+    ASSERT_LT(encoded.size(), rawBytes / 2);
+
+    auto decoded = SliceEncoder::decode(encoded.data(), encoded.size());
+    ASSERT_EQ(decoded->width(), slice->width());
+    ASSERT_EQ(decoded->depth(), slice->depth());
+
+    for (int w = 0; w < slice->width(); w++)
+    {
+        for (int d = 0; d < slice->depth(); d++)
+        {
+            ASSERT_NEAR(decoded->valueAt(w, d), slice->valueAt(w, d), tolerance);
+        }
+    }
+
+    ASSERT_TRUE(encoder.encodeZfp(slice, 0.0).empty());
+    ASSERT_TRUE(SliceEncoder::decode(encoded.data() + 1, encoded.size() - 1)->isEmpty());
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(encoding_tests, testCraftedHeaders)
+{
+    SliceCodec codec;
+    int width, depth;
+
+    // a size whose sample count does not fit in a slice, with one empty zfp tile
+    auto huge = craftedHeader(SliceCodec::Zfp, 0x7fffffffu, 0x7fffffffu, 0x7fffffffu);
+    huge.insert(huge.end(), { 0, 0, 0, 0, 0, 0, 0xf0, 0x3f });
+    putU32(huge, 0);
+    ASSERT_EQ(huge.size(), 32u);
+    ASSERT_FALSE(SliceEncoder::readHeader(huge.data(), huge.size(), codec, width, depth));
+    ASSERT_TRUE(SliceEncoder::decode(huge.data(), huge.size())->isEmpty());
+
+    auto wide = craftedHeader(SliceCodec::Zfp, 0x10000u, 0x10000u, 64);
+    ASSERT_FALSE(SliceEncoder::readHeader(wide.data(), wide.size(), codec, width, depth));
+
+    // zfp tiles that are empty or larger than any tile of that size can compress to
+    for (size_t tileBytes : { (size_t)0, (size_t)1 << 20 })
+    {
+        auto zfp = craftedHeader(SliceCodec::Zfp, 64, 64, 64);
+        zfp.insert(zfp.end(), { 0, 0, 0, 0, 0, 0, 0xf0, 0x3f });
+        putU32(zfp, (std::uint32_t)tileBytes);
+        zfp.resize(zfp.size() + tileBytes, 0xff);
+        ASSERT_TRUE(SliceEncoder::readHeader(zfp.data(), zfp.size(), codec, width, depth));
+        ASSERT_TRUE(SliceEncoder::decode(zfp.data(), zfp.size())->isEmpty());
+    }
+
+    // a short zfp tile is decoded from a padded copy, never past the end of the buffer
+    auto shortTile = craftedHeader(SliceCodec::Zfp, 64, 64, 64);
+    shortTile.insert(shortTile.end(), { 0, 0, 0, 0, 0, 0, 0xf0, 0x3f });
+    putU32(shortTile, 3);
+    shortTile.insert(shortTile.end(), { 0xff, 0xff, 0xff });
+    SliceEncoder::decode(shortTile.data(), shortTile.size());
+
+    // a palette larger than the slice, and a lossless tile too short to hold its blocks
+    auto palette = craftedHeader(SliceCodec::Lossless, 2, 2, 2);
+    putU32(palette, 5);
+    for (int n = 0; n < 5; n++) putU32(palette, 0x80000000u);
+    putU32(palette, 0);
+    ASSERT_TRUE(SliceEncoder::decode(palette.data(), palette.size())->isEmpty());
+
+    auto lossless = craftedHeader(SliceCodec::Lossless, 64, 64, 64);
+    putU32(lossless, 1);
+    putU32(lossless, 0x80000000u);
+    putU32(lossless, 1);
+    lossless.push_back(0);
+    ASSERT_TRUE(SliceEncoder::decode(lossless.data(), lossless.size())->isEmpty());
+}
@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_facies.h"
+#include "zgyaccess/zgy_multivolume.h"
+#include "zgyaccess/zgy_outline.h"
+#include "zgyaccess/zgy_outlinemask.h"
+#include "zgyaccess/zgy_synthetic.h"
+#include "testdatafolder.h"
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(facies_tests, testClassifySamples)
+{
+    const std::string zgyFile = (std::filesystem::temp_directory_path() / "facies_tests.zgy").string();
+
+    auto fancy = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(fancy->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::SyntheticVolumeGenerator generator(fancy->inlineSize(), fancy->xlineSize(), fancy->zSize());
+    ASSERT_TRUE(generator.write(zgyFile)) << generator.errorMessage();
+
+    auto synthetic = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(synthetic->open(zgyFile));
+
+    ZGYAccess::MultiVolumeReader volumes;
+    volumes.addVolume(fancy);
+    volumes.addVolume(synthetic);
+
+    ZGYAccess::Outline o;
+    o.addPoint(0.0, 0.0);
+    o.addPoint(111.0, 0.0);
+    o.addPoint(111.0, 63.0);
+    o.addPoint(0.0, 63.0);
+    ZGYAccess::OutlineMask mask(fancy->inlineSize(), fancy->xlineSize(), o);
+
+    ZGYAccess::FaciesClassifier classifier(4);
+    classifier.setIterations(10);
+    classifier.setBatchColumns(2);
+    ASSERT_TRUE(classifier.train(volumes, mask, 0, fancy->zSize())) << classifier.errorMessage();
+    ASSERT_EQ(classifier.channelCount(), 2);
+
+    // every centroid lies inside the data range of each volume
+    for (int k = 0; k < classifier.classCount(); k++)
+    {
+        auto centre = classifier.centroid(k);
+        ASSERT_EQ(centre.size(), 2);
+        ASSERT_GE(centre[0], fancy->dataRange().first - 1e-3);
+        ASSERT_LE(centre[0], fancy->dataRange().second + 1e-3);
+    }
+
+    // labels are the nearest centroid, and invalid samples get no class
+    std::vector<float> samples = { classifier.centroid(2)[0], classifier.centroid(2)[1], std::nanf(""), 0.0f };
+    std::vector<int> labels(2);
+    classifier.classify(samples.data(), 2, labels.data());
+    ASSERT_EQ(labels[0], 2);
+    ASSERT_EQ(labels[1], -1);
+
+    // slices and the written class volume agree with classifying the interleaved samples
+    auto interleaved = volumes.inlineSlice(40, 0, fancy->zSize());
+    auto classes = classifier.inlineSlice(volumes, 40);
+    labels.resize(classes->size());
+    classifier.classify(interleaved->values(), labels.size(), labels.data());
+    for (int n = 0; n < classes->size(); n++)
+    {
+        ASSERT_EQ(classes->values()[n], (float)labels[n]);
+        ASSERT_GE(labels[n], 0);
+        ASSERT_LT(labels[n], 4);
+    }
+
+    const std::string classFile = (std::filesystem::temp_directory_path() / "facies_tests_classes.zgy").string();
+    classifier.setMemoryBudget(1024 * 1024);
+    ASSERT_TRUE(classifier.writeClassVolume(volumes, classFile)) << classifier.errorMessage();
+
+    ZGYAccess::ZGYReader classReader;
+    ASSERT_TRUE(classReader.open(classFile));
+    auto expected = classifier.zSlice(volumes, 100);
+    auto written = classReader.zSlice(100);
+    ASSERT_EQ(written->size(), expected->size());
+    for (int n = 0; n < written->size(); n++)
+    {
+        ASSERT_EQ(written->values()[n], expected->values()[n]);
+    }
+
+    classReader.close();
+    synthetic->close();
+    fancy->close();
+    std::filesystem::remove(zgyFile);
+    std::filesystem::remove(classFile);
+}
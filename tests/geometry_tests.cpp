@@ -24,6 +24,7 @@
 
 #include "zgyaccess/zgy_point.h"
 #include "zgyaccess/zgy_outline.h"
+#include "zgyaccess/zgy_outlinemask.h"
 
 //--------------------------------------------------------------------------------------------------
 ///
@@ -74,3 +75,58 @@ TEST(geometry_tests, testOutline)
     ASSERT_FALSE(o.isEmpty());
     ASSERT_TRUE(o.isValid());
 }
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(geometry_tests, testOutlineMask)
+{
+    ZGYAccess::Outline o;
+    o.addPoint(2.0, 3.0);
+    o.addPoint(5.5, 3.0);
+    o.addPoint(5.5, 7.0);
+    o.addPoint(2.0, 7.0);
+
+    ZGYAccess::OutlineMask mask(10, 20, o);
+
+    ASSERT_FALSE(mask.isEmpty());
+    ASSERT_EQ(mask.traceCount(), 4 * 5);
+
+    ASSERT_TRUE(mask.isInside(2, 3));
+    ASSERT_TRUE(mask.isInside(5, 7));
+    ASSERT_FALSE(mask.isInside(1, 5));
+    ASSERT_FALSE(mask.isInside(6, 5));
+    ASSERT_FALSE(mask.isInside(3, 8));
+
+    ASSERT_EQ(mask.spans(3).size(), 1);
+    ASSERT_EQ(mask.spans(3)[0].first, 3);
+    ASSERT_EQ(mask.spans(3)[0].second, 7);
+    ASSERT_TRUE(mask.spans(0).empty());
+    ASSERT_TRUE(mask.spans(100).empty());
+
+    ASSERT_EQ(mask.coverage(0, 2, 0, 20), ZGYAccess::OutlineMask::Coverage::Outside);
+    ASSERT_EQ(mask.coverage(0, 4, 0, 20), ZGYAccess::OutlineMask::Coverage::Partial);
+    ASSERT_EQ(mask.coverage(3, 2, 4, 3), ZGYAccess::OutlineMask::Coverage::Inside);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(geometry_tests, testOutlineMaskClipped)
+{
+    // triangle partly outside the grid
+    ZGYAccess::Outline o;
+    o.addPoint(-5.0, -5.0);
+    o.addPoint(8.0, -5.0);
+    o.addPoint(-5.0, 8.0);
+
+    ZGYAccess::OutlineMask mask(10, 10, o);
+
+    ASSERT_TRUE(mask.isInside(0, 0));
+    ASSERT_TRUE(mask.isInside(1, 1));
+    ASSERT_FALSE(mask.isInside(3, 3));
+    ASSERT_FALSE(mask.isInside(9, 0));
+
+    ZGYAccess::OutlineMask invalid(10, 10, ZGYAccess::Outline());
+    ASSERT_TRUE(invalid.isEmpty());
+}
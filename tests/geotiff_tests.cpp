@@ -0,0 +1,193 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_geotiff.h"
+#include "testdatafolder.h"
+
+namespace
+{
+    std::uint32_t readUint(const std::vector<char>& bytes, size_t offset, int size)
+    {
+        std::uint32_t value = 0;
+        for (int b = 0; b < size; b++)
+        {
+            value |= (std::uint32_t)(std::uint8_t)bytes[offset + b] << (8 * b);
+        }
+        return value;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(geotiff_tests, testResample)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto slice = reader.zSlice(100);
+    const auto grid = ZGYAccess::GeoTiffExporter::northUpGrid(reader, 20.0);
+    ASSERT_FALSE(grid.isEmpty());
+    ASSERT_LT(grid.spacingY(), 0.0);
+
+    ZGYAccess::GeoTiffExporter exporter(grid);
+    exporter.setFillValue(-999.0f);
+    auto raster = exporter.resample(reader, slice);
+    ASSERT_EQ(raster->width(), grid.sizeX());
+    ASSERT_EQ(raster->depth(), grid.sizeY());
+
+    int inside = 0;
+    for (int ix = 0; ix < grid.sizeX(); ix += 7)
+    {
+        for (int iy = 0; iy < grid.sizeY(); iy += 5)
+        {
+            const auto centre = grid.cellCentre(ix, iy);
+            const auto [u, v] = reader.toInlineXlineIndex(centre.x(), centre.y());
+
+            // stay clear of the survey edge, where rounding decides between fill and data
+            if ((u < 0.01) || (v < 0.01) || (u > reader.inlineSize() - 1.01) || (v > reader.xlineSize() - 1.01))
+            {
+                const bool outside = (u < -0.01) || (v < -0.01) || (u > reader.inlineSize() - 0.99) || (v > reader.xlineSize() - 0.99);
+                if (outside)
+                {
+                    ASSERT_EQ(raster->valueAt(ix, iy), -999.0f);
+                }
+                continue;
+            }
+
+            const int i = (int)u;
+            const int j = (int)v;
+            const double fu = u - i;
+            const double fv = v - j;
+            const double expected = (1 - fu) * (1 - fv) * slice->valueAt(i, j) + fu * (1 - fv) * slice->valueAt(i + 1, j) +
+                                    (1 - fu) * fv * slice->valueAt(i, j + 1) + fu * fv * slice->valueAt(i + 1, j + 1);
+
+            ASSERT_NEAR(raster->valueAt(ix, iy), expected, 1e-3);
+            inside++;
+        }
+    }
+    ASSERT_GT(inside, 0);
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(geotiff_tests, testExportGeoTiff)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    const auto grid = ZGYAccess::GeoTiffExporter::northUpGrid(reader, 20.0);
+    const std::string tiffFile = (std::filesystem::temp_directory_path() / "geotiff_tests.tif").string();
+
+    ZGYAccess::GeoTiffExporter exporter(grid);
+    exporter.setTileSize(32);
+    exporter.setEpsgCode(23031);
+    exporter.setFillValue(1.2345678e-5f);
+    ASSERT_TRUE(exporter.exportZSlice(reader, 100, tiffFile)) << exporter.errorMessage();
+
+    std::ifstream file(tiffFile, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ASSERT_GT(bytes.size(), 8);
+    ASSERT_EQ(bytes[0], 'I');
+    ASSERT_EQ(readUint(bytes, 2, 2), 42);
+
+    // directory entries, with the values stored inline or at an offset
+    const size_t directory = readUint(bytes, 4, 4);
+    const int nEntries = (int)readUint(bytes, directory, 2);
+    std::map<int, std::vector<std::uint32_t>> tags;
+    std::map<int, std::string> asciiTags;
+    int lastTag = 0;
+    for (int e = 0; e < nEntries; e++)
+    {
+        const size_t entry = directory + 2 + 12 * e;
+        const int tag = (int)readUint(bytes, entry, 2);
+        const int type = (int)readUint(bytes, entry + 2, 2);
+        const std::uint32_t count = readUint(bytes, entry + 4, 4);
+        ASSERT_GT(tag, lastTag);
+        lastTag = tag;
+
+        if (type == 2)
+        {
+            const size_t text = (count <= 4) ? entry + 8 : readUint(bytes, entry + 8, 4);
+            asciiTags[tag] = std::string(&bytes[text]);
+            continue;
+        }
+
+        const int size = (type == 3) ? 2 : 4;
+        if ((type != 3) && (type != 4)) continue;
+
+        const size_t values = (count * size <= 4) ? entry + 8 : readUint(bytes, entry + 8, 4);
+        for (std::uint32_t n = 0; n < count; n++)
+        {
+            tags[tag].push_back(readUint(bytes, values + n * size, size));
+        }
+    }
+
+    ASSERT_EQ(tags[256][0], (std::uint32_t)grid.sizeX());
+    ASSERT_EQ(tags[257][0], (std::uint32_t)grid.sizeY());
+    ASSERT_EQ(tags[322][0], 32);
+    ASSERT_EQ(tags[339][0], 3);
+    ASSERT_EQ(tags[34735][15], 23031);
+
+    // the nodata text reads back as the exact fill value
+    ASSERT_EQ(std::strtof(asciiTags[42113].c_str(), nullptr), 1.2345678e-5f);
+
+    const int tilesX = (grid.sizeX() + 31) / 32;
+    const int tilesY = (grid.sizeY() + 31) / 32;
+    ASSERT_EQ(tags[324].size(), (size_t)(tilesX * tilesY));
+
+    // pixels in the tiles match the resampled grid
+    auto raster = exporter.resample(reader, reader.zSlice(100));
+    for (auto [ix, iy] : { std::make_pair(0, 0), std::make_pair(grid.sizeX() / 2, grid.sizeY() / 2), std::make_pair(grid.sizeX() - 1, 40) })
+    {
+        const size_t tile = (size_t)(iy / 32) * tilesX + ix / 32;
+        const size_t offset = tags[324][tile] + ((size_t)(iy % 32) * 32 + ix % 32) * sizeof(float);
+
+        float value;
+        std::memcpy(&value, &bytes[offset], sizeof(float));
+
+        const float expected = raster->valueAt(ix, iy);
+        if (std::isnan(expected))
+            ASSERT_TRUE(std::isnan(value));
+        else
+            ASSERT_EQ(value, expected);
+    }
+
+    // rotated grids cannot be written as a north-up raster
+    ZGYAccess::GeoTiffExporter southUp(ZGYAccess::MapGrid(grid.origin(), 20.0, 20.0, 10, 10));
+    ASSERT_FALSE(southUp.exportZSlice(reader, 100, tiffFile));
+
+    file.close();
+    reader.close();
+    std::filesystem::remove(tiffFile);
+}
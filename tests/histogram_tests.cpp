@@ -24,6 +24,12 @@
 #include <memory>
 
 #include "zgyaccess/zgy_histogram.h"
+#include "zgyaccess/zgy_jointhistogram.h"
+#include "zgyaccess/zgy_multivolume.h"
+#include "zgyaccess/zgy_outline.h"
+#include "zgyaccess/zgy_outlinemask.h"
+#include "zgyaccess/zgyreader.h"
+#include "testdatafolder.h"
 
 //--------------------------------------------------------------------------------------------------
 ///
@@ -68,3 +74,85 @@ TEST(histogram_tests, testHistogram2)
     ASSERT_EQ(hist->Yvalues[3], 1);
     ASSERT_EQ(hist->Yvalues[4], 2);
 }
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(histogram_tests, testJointHistogram)
+{
+    // value pairs, with a NaN pair that is skipped and out of range values in the edge bins
+    std::vector<float> testdata = { -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f, -1.0f, std::nanf(""), 0.0f, 5.0f, -5.0f };
+
+    ZGYAccess::JointHistogramGenerator generator({ 2, 3 }, { -1.0f, -1.5f }, { 1.0f, 1.5f });
+    generator.addData(testdata.data(), 3);
+
+    ZGYAccess::JointHistogramGenerator other({ 2, 3 }, { -1.0f, -1.5f }, { 1.0f, 1.5f });
+    other.addData(testdata.data() + 6, 3);
+    generator.merge(other);
+
+    auto hist = generator.getHistogram();
+
+    ASSERT_EQ(hist->dimensions(), 2);
+    ASSERT_EQ(hist->binCentres[0].size(), 2);
+    ASSERT_EQ(hist->binCentres[1].size(), 3);
+    ASSERT_DOUBLE_EQ(hist->binCentres[1][0], -1.0);
+
+    ASSERT_EQ(hist->count({ 0, 1 }), 2);
+    ASSERT_EQ(hist->count({ 1, 2 }), 1);
+    ASSERT_EQ(hist->count({ 1, 0 }), 2);
+    ASSERT_EQ(hist->count({ 0, 0 }), 0);
+    ASSERT_EQ(hist->count({ 2, 0 }), 0);
+
+    // finite values far outside the range land in the edge bins
+    const float extremes[] = { 1e30f, -1e30f, -3e38f, 3e38f };
+    generator.addData(extremes, 2);
+    hist = generator.getHistogram();
+    ASSERT_EQ(hist->count({ 1, 0 }), 3);
+    ASSERT_EQ(hist->count({ 0, 2 }), 1);
+
+    // too many bins in total gives no histogram
+    ZGYAccess::JointHistogramGenerator huge({ 65536, 65536, 65536 }, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f });
+    ASSERT_EQ(huge.getHistogram()->dimensions(), 0);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(histogram_tests, testCrossplot)
+{
+    auto reader = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::MultiVolumeReader volumes;
+    volumes.addVolume(reader);
+    volumes.addVolume(reader->clone());
+
+    ZGYAccess::Outline o;
+    o.addPoint(10.0, 20.0);
+    o.addPoint(90.0, 20.0);
+    o.addPoint(90.0, 50.0);
+    o.addPoint(10.0, 50.0);
+    ZGYAccess::OutlineMask mask(reader->inlineSize(), reader->xlineSize(), o);
+
+    const int nBins = 16;
+    auto hist = ZGYAccess::JointHistogramGenerator::crossplot(volumes, mask, nBins, 30, 100);
+    ASSERT_EQ(hist->dimensions(), 2);
+
+    // the same volume twice puts every sample on the diagonal
+    double total = 0.0;
+    for (int a = 0; a < nBins; a++)
+    {
+        for (int b = 0; b < nBins; b++)
+        {
+            if (a != b)
+            {
+                ASSERT_EQ(hist->count({ a, b }), 0.0);
+            }
+            total += hist->count({ a, b });
+        }
+    }
+
+    ASSERT_EQ(total, (double)reader->statistics(mask, 30, 100).count);
+
+    reader->close();
+}
@@ -0,0 +1,151 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_stratal.h"
+#include "zgyaccess/zgy_flatten.h"
+#include "testdatafolder.h"
+
+namespace
+{
+    // dipping horizon given in sample indices, converted to z values of the reader
+    std::shared_ptr<ZGYAccess::SeismicSliceData> makeHorizon(ZGYAccess::ZGYReader& reader, double startIndex, double dipPerInline)
+    {
+        auto horizon = std::make_shared<ZGYAccess::SeismicSliceData>(reader.inlineSize(), reader.xlineSize());
+        for (int i = 0; i < reader.inlineSize(); i++)
+        {
+            for (int j = 0; j < reader.xlineSize(); j++)
+            {
+                horizon->values()[i * reader.xlineSize() + j] = (float)(reader.zRange().first + reader.zStep() * (startIndex + dipPerInline * i + 0.05 * j));
+            }
+        }
+        return horizon;
+    }
+
+    float interpolatedSample(ZGYAccess::ZGYReader& reader, int i, int j, double k)
+    {
+        auto trace = reader.zTrace(i, j);
+        const int k0 = (int)k;
+        const double t = k - k0;
+        const float upper = trace->valueAt(0, k0);
+        const float lower = (k0 + 1 < reader.zSize()) ? trace->valueAt(0, k0 + 1) : upper;
+        return (float)(upper + t * (lower - upper));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(horizon_tests, testStratalSlices)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto top = makeHorizon(reader, 10.25, 0.3);
+    auto base = makeHorizon(reader, 70.5, 0.6);
+    top->values()[5 * reader.xlineSize() + 7] = std::numeric_limits<float>::quiet_NaN();
+
+    const std::vector<double> proportions = { 0.0, 0.33, 0.5, 1.0 };
+
+    ZGYAccess::StratalSlicer slicer;
+    slicer.setFillValue(-999.0f);
+    auto slices = slicer.slices(reader, top, base, proportions);
+    ASSERT_EQ(slices.size(), proportions.size());
+
+    for (size_t s = 0; s < proportions.size(); s++)
+    {
+        ASSERT_EQ(slices[s]->width(), reader.inlineSize());
+        ASSERT_EQ(slices[s]->depth(), reader.xlineSize());
+        ASSERT_EQ(slices[s]->valueAt(5, 7), -999.0f);
+
+        for (auto [i, j] : { std::make_pair(0, 0), std::make_pair(40, 30), std::make_pair(70, 63), std::make_pair(111, 10) })
+        {
+            const double kTop = 10.25 + 0.3 * i + 0.05 * j;
+            const double kBase = 70.5 + 0.6 * i + 0.05 * j;
+            const double k = kTop + proportions[s] * (kBase - kTop);
+
+            if (k > reader.zSize() - 1)
+                ASSERT_EQ(slices[s]->valueAt(i, j), -999.0f);
+            else
+                ASSERT_NEAR(slices[s]->valueAt(i, j), interpolatedSample(reader, i, j, k), 1e-3);
+        }
+    }
+
+    auto mismatched = std::make_shared<ZGYAccess::SeismicSliceData>(10, 10);
+    ASSERT_TRUE(slicer.slices(reader, top, mismatched, proportions).empty());
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(horizon_tests, testFlattenedReads)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto horizon = makeHorizon(reader, 30.4, 1.0);
+    horizon->values()[50 * reader.xlineSize() + 3] = std::numeric_limits<float>::quiet_NaN();
+
+    ZGYAccess::HorizonFlattener flattener(horizon);
+    flattener.setFillValue(-999.0f);
+
+    const int zStartOffset = -40;
+    const int zSize = 80;
+
+    // the window reaches above the top of the volume for the first inlines and below the bottom for the last
+    for (int inlineIndex : { 0, 50, 111 })
+    {
+        auto slice = flattener.inlineSlice(reader, inlineIndex, zStartOffset, zSize);
+        ASSERT_EQ(slice->width(), reader.xlineSize());
+        ASSERT_EQ(slice->depth(), zSize);
+
+        for (int j : { 0, 3, 33, 63 })
+        {
+            for (int n = 0; n < zSize; n++)
+            {
+                const double k = 30.4 + 1.0 * inlineIndex + 0.05 * j + zStartOffset + n;
+                const bool undefined = (inlineIndex == 50) && (j == 3);
+
+                if (undefined || (k < 0.0) || (k > reader.zSize() - 1))
+                    ASSERT_EQ(slice->valueAt(j, n), -999.0f);
+                else
+                    ASSERT_NEAR(slice->valueAt(j, n), interpolatedSample(reader, inlineIndex, j, k), 1e-3);
+            }
+        }
+    }
+
+    auto xline = flattener.xlineSlice(reader, 33, zStartOffset, zSize);
+    auto inlineSlice = flattener.inlineSlice(reader, 70, zStartOffset, zSize);
+    for (int n = 0; n < zSize; n++)
+    {
+        ASSERT_EQ(xline->valueAt(70, n), inlineSlice->valueAt(33, n));
+    }
+
+    ASSERT_TRUE(flattener.inlineSlice(reader, 112, zStartOffset, zSize)->isEmpty());
+
+    reader.close();
+}
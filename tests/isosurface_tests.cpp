@@ -0,0 +1,146 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <set>
+#include <string>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_isosurface.h"
+#include "testdatafolder.h"
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(isosurface_tests, testExtract)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    // the test data holds integer values, so a half value never hits a sample exactly
+    auto [minVal, maxVal] = reader.dataRange();
+    float isoValue = std::floor((float)(minVal + maxVal) / 2) + 0.5f;
+
+    ZGYAccess::IsoSurfaceExtractor extractor(isoValue);
+    auto mesh = extractor.extract(reader, 0, { 0, 0, 0 }, { reader.inlineSize(), reader.xlineSize(), reader.zSize() });
+
+    ASSERT_GT(mesh->triangleCount(), 0);
+
+    for (int index : mesh->triangles)
+    {
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, mesh->vertexCount());
+    }
+
+    for (int v = 0; v < mesh->vertexCount(); v++)
+    {
+        ASSERT_GE(mesh->vertices[3 * v + 0], 0.0f);
+        ASSERT_LE(mesh->vertices[3 * v + 0], reader.inlineSize() - 1.0f);
+        ASSERT_GE(mesh->vertices[3 * v + 1], 0.0f);
+        ASSERT_LE(mesh->vertices[3 * v + 1], reader.xlineSize() - 1.0f);
+        ASSERT_GE(mesh->vertices[3 * v + 2], 0.0f);
+        ASSERT_LE(mesh->vertices[3 * v + 2], reader.zSize() - 1.0f);
+    }
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(isosurface_tests, testNoSeamsAcrossBricks)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto [minVal, maxVal] = reader.dataRange();
+    float isoValue = std::floor((float)(minVal + maxVal) / 2) + 0.5f;
+
+    const std::array<float, 3> upper = { reader.inlineSize() - 1.0f, reader.xlineSize() - 1.0f, reader.zSize() - 1.0f };
+
+    ZGYAccess::IsoSurfaceExtractor extractor(isoValue);
+    auto mesh = extractor.extract(reader, 0, { 0, 0, 0 }, { reader.inlineSize(), reader.xlineSize(), reader.zSize() });
+
+    // vertices are shared between bricks, so no two vertices have the same position
+    std::set<std::array<float, 3>> positions;
+    for (int v = 0; v < mesh->vertexCount(); v++)
+    {
+        positions.insert({ mesh->vertices[3 * v], mesh->vertices[3 * v + 1], mesh->vertices[3 * v + 2] });
+    }
+    ASSERT_EQ((int)positions.size(), mesh->vertexCount());
+
+    // an edge used by a single triangle is only allowed on the faces of the region
+    std::map<std::pair<int, int>, int> edgeUse;
+    for (int t = 0; t < mesh->triangleCount(); t++)
+    {
+        for (int e = 0; e < 3; e++)
+        {
+            int a = mesh->triangles[3 * t + e];
+            int b = mesh->triangles[3 * t + (e + 1) % 3];
+            edgeUse[{ std::min(a, b), std::max(a, b) }]++;
+        }
+    }
+
+    for (auto& [edge, count] : edgeUse)
+    {
+        ASSERT_LE(count, 2);
+        if (count == 2) continue;
+
+        bool onFace = false;
+        for (int d = 0; d < 3; d++)
+        {
+            float pa = mesh->vertices[3 * edge.first + d];
+            float pb = mesh->vertices[3 * edge.second + d];
+            if ((pa == pb) && ((pa == 0.0f) || (pa == upper[d]))) onFace = true;
+        }
+        ASSERT_TRUE(onFace);
+    }
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(isosurface_tests, testCoarseLod)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto [minVal, maxVal] = reader.dataRange();
+    float isoValue = std::floor((float)(minVal + maxVal) / 2) + 0.5f;
+
+    ZGYAccess::IsoSurfaceExtractor extractor(isoValue);
+    auto fullMesh = extractor.extract(reader, 0, { 0, 0, 0 }, { reader.inlineSize(), reader.xlineSize(), reader.zSize() });
+    auto coarseMesh = extractor.extract(reader, 1, { 0, 0, 0 }, { reader.inlineSize(), reader.xlineSize(), reader.zSize() });
+
+    ASSERT_GT(coarseMesh->triangleCount(), 0);
+    ASSERT_LT(coarseMesh->triangleCount(), fullMesh->triangleCount());
+
+    auto emptyMesh = extractor.extract(reader, 0, { 10, 10, 10 }, { 1, 20, 20 });
+    ASSERT_EQ(emptyMesh->triangleCount(), 0);
+
+    reader.close();
+}
@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_livemask.h"
+#include "testdatafolder.h"
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(livemask_tests, testLiveTraceMask)
+{
+    ZGYAccess::LiveTraceMask mask(10, 100);
+
+    ASSERT_FALSE(mask.isEmpty());
+    ASSERT_EQ(mask.liveCount(), 0);
+
+    mask.setLive(2, 3, true);
+    mask.setLive(2, 99, true);
+    mask.setLive(9, 0, true);
+    mask.setLive(9, 0, true);
+
+    ASSERT_TRUE(mask.isLive(2, 3));
+    ASSERT_TRUE(mask.isLive(2, 99));
+    ASSERT_FALSE(mask.isLive(3, 2));
+    ASSERT_FALSE(mask.isLive(-1, 0));
+    ASSERT_FALSE(mask.isLive(10, 0));
+
+    ASSERT_EQ(mask.liveCount(2), 2);
+    ASSERT_EQ(mask.liveCount(9), 1);
+    ASSERT_EQ(mask.liveCount(), 3);
+
+    ASSERT_TRUE(mask.hasLiveTraces(0, 5, 0, 10));
+    ASSERT_FALSE(mask.hasLiveTraces(3, 5, 0, 100));
+
+    mask.setLive(2, 3, false);
+    ASSERT_EQ(mask.liveCount(2), 1);
+
+    std::string filename = (std::filesystem::temp_directory_path() / "livemask_tests.livemask").string();
+    ASSERT_TRUE(mask.save(filename, 1234));
+
+    ZGYAccess::LiveTraceMask loaded;
+    ASSERT_FALSE(loaded.load(filename, 4321));
+    ASSERT_TRUE(loaded.load(filename, 1234));
+
+    ASSERT_EQ(loaded.inlineSize(), 10);
+    ASSERT_EQ(loaded.xlineSize(), 100);
+    ASSERT_EQ(loaded.liveCount(), 2);
+    ASSERT_TRUE(loaded.isLive(2, 99));
+    ASSERT_TRUE(loaded.isLive(9, 0));
+
+    std::filesystem::remove(filename);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(livemask_tests, testLiveTraceMaskFromReader)
+{
+    const std::string filename = std::string(TEST_DATA_DIR) + "Fancy-int8.zgy";
+    const std::string sidecar = filename + ".livemask";
+    std::filesystem::remove(sidecar);
+
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(filename));
+
+    auto mask = reader.liveTraceMask();
+    ASSERT_EQ(mask->inlineSize(), reader.inlineSize());
+    ASSERT_EQ(mask->xlineSize(), reader.xlineSize());
+
+    for (int i = 0; i < reader.inlineSize(); i++)
+    {
+        int rowCount = 0;
+        for (int j = 0; j < reader.xlineSize(); j++)
+        {
+            auto trace = reader.zTrace(i, j);
+            auto [minIt, maxIt] = std::minmax_element(trace->values(), trace->values() + trace->size());
+
+            ASSERT_EQ(reader.isLiveTrace(i, j), *minIt != *maxIt);
+            if (*minIt != *maxIt) rowCount++;
+        }
+        ASSERT_EQ(mask->liveCount(i), rowCount);
+    }
+
+    reader.close();
+
+    // the second open uses the sidecar
+    ASSERT_TRUE(std::filesystem::exists(sidecar));
+
+    ZGYAccess::ZGYReader reader2;
+    ASSERT_TRUE(reader2.open(filename));
+    ASSERT_EQ(reader2.liveTraceMask()->liveCount(), mask->liveCount());
+    reader2.close();
+
+    std::filesystem::remove(sidecar);
+}
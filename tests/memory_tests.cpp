@@ -0,0 +1,283 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/seismicslice.h"
+#include "zgyaccess/zgy_memorygovernor.h"
+#include "zgyaccess/zgy_multivolume.h"
+#include "zgyaccess/zgy_packedslice.h"
+#include "zgyaccess/zgy_thumbnail.h"
+#include "testdatafolder.h"
+
+using ZGYAccess::MemoryCategory;
+using ZGYAccess::MemoryGovernor;
+using ZGYAccess::MemoryReservation;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(memory_tests, testSliceAccounting)
+{
+    auto& governor = MemoryGovernor::instance();
+    const std::int64_t before = governor.usage(MemoryCategory::SliceData);
+
+    auto slice = std::make_shared<ZGYAccess::SeismicSliceData>(100, 50);
+    ASSERT_EQ(governor.usage(MemoryCategory::SliceData), before + 100 * 50 * (std::int64_t)sizeof(float));
+    ASSERT_GE(governor.peakUsage(), governor.usage());
+
+    slice->reset();
+    ASSERT_EQ(governor.usage(MemoryCategory::SliceData), before);
+
+    {
+        ZGYAccess::SeismicSliceData scoped(10, 10);
+        ASSERT_EQ(governor.usage(MemoryCategory::SliceData), before + 100 * (std::int64_t)sizeof(float));
+    }
+    ASSERT_EQ(governor.usage(MemoryCategory::SliceData), before);
+
+    // slices that do not fit in the budget are created empty
+    governor.setBudget(governor.usage() + 1000 * sizeof(float));
+
+    auto fits = std::make_shared<ZGYAccess::SeismicSliceData>(10, 100);
+    ASSERT_FALSE(fits->isEmpty());
+
+    const std::int64_t refusedBefore = governor.refusedCount();
+    auto tooBig = std::make_shared<ZGYAccess::SeismicSliceData>(100, 100);
+    ASSERT_TRUE(tooBig->isEmpty());
+    ASSERT_TRUE(tooBig->isOutOfMemory());
+    ASSERT_EQ(tooBig->values(), nullptr);
+    ASSERT_EQ(governor.refusedCount(), refusedBefore + 1);
+
+    // a refused read is told apart from an empty one
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto refused = reader.zSlice(100);
+    ASSERT_TRUE(refused->isEmpty());
+    ASSERT_TRUE(refused->isOutOfMemory());
+
+    auto refusedTrace = reader.zTrace(5, 5, 0, 2000);
+    ASSERT_TRUE(refusedTrace->isOutOfMemory());
+
+    governor.setBudget(0);
+    ASSERT_FALSE(reader.zSlice(100)->isEmpty());
+
+    auto outOfRange = reader.zTrace(5, 5, 0, 2000);
+    ASSERT_TRUE(outOfRange->isEmpty());
+    ASSERT_FALSE(outOfRange->isOutOfMemory());
+
+    reader.close();
+
+    // a sample count beyond int is refused without counting anything
+    const std::int64_t usage = governor.usage();
+    auto overflow = std::make_shared<ZGYAccess::SeismicSliceData>(100000, 100000);
+    ASSERT_TRUE(overflow->isOutOfMemory());
+    ASSERT_EQ(governor.usage(), usage);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(memory_tests, testOtherSliceAccounting)
+{
+    auto& governor = MemoryGovernor::instance();
+    const std::int64_t before = governor.usage(MemoryCategory::SliceData);
+
+    auto reader = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::PackedSliceReader packedReader(reader, ZGYAccess::PackedSampleFormat::UInt8);
+    ZGYAccess::MultiVolumeReader volumes;
+    volumes.addVolume(reader);
+    volumes.addVolume(reader->clone());
+
+    {
+        auto packed = packedReader.zSlice(100);
+        ASSERT_FALSE(packed->isEmpty());
+        ASSERT_EQ(governor.usage(MemoryCategory::SliceData), before + (std::int64_t)packed->byteSize());
+
+        auto interleaved = volumes.zSlice(100);
+        ASSERT_FALSE(interleaved->isEmpty());
+        ASSERT_EQ(governor.usage(MemoryCategory::SliceData), before + (std::int64_t)packed->byteSize() + interleaved->size() * (std::int64_t)sizeof(float));
+
+        ZGYAccess::ThumbnailImage image(16, 8);
+        ASSERT_FALSE(image.isEmpty());
+    }
+    ASSERT_EQ(governor.usage(MemoryCategory::SliceData), before);
+
+    // refused buffers are flagged the same way as for SeismicSliceData
+    governor.setBudget(governor.usage() + 16);
+
+    auto packed = packedReader.zSlice(100);
+    ASSERT_TRUE(packed->isEmpty());
+    ASSERT_TRUE(packed->isOutOfMemory());
+
+    auto interleaved = volumes.zSlice(100);
+    ASSERT_TRUE(interleaved->isEmpty());
+    ASSERT_TRUE(interleaved->isOutOfMemory());
+
+    ZGYAccess::ThumbnailImage image(16, 8);
+    ASSERT_TRUE(image.isEmpty());
+    ASSERT_TRUE(image.isOutOfMemory());
+
+    governor.setBudget(0);
+    reader->close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(memory_tests, testCacheReclaim)
+{
+    auto& governor = MemoryGovernor::instance();
+
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    const std::int64_t before = governor.usage(MemoryCategory::DecodedBricks);
+    ASSERT_FALSE(reader.inlineSliceView(70, 0, reader.zSize())->isEmpty());
+
+    const std::int64_t cached = governor.usage(MemoryCategory::DecodedBricks) - before;
+    ASSERT_GT(cached, 0);
+
+    // the slice only fits once the cache has given up some of its bricks
+    const std::int64_t sliceBytes = (std::int64_t)reader.inlineSize() * reader.xlineSize() * sizeof(float);
+    governor.setBudget(governor.usage() + sliceBytes / 2);
+
+    auto slice = reader.zSlice(100);
+    ASSERT_FALSE(slice->isEmpty());
+    ASSERT_LT(governor.usage(MemoryCategory::DecodedBricks), before + cached);
+    ASSERT_LE(governor.usage(), governor.budget());
+
+    // lowering the budget shrinks the cache right away
+    governor.setBudget(0);
+    ASSERT_FALSE(reader.inlineSliceView(70, 0, reader.zSize())->isEmpty());
+    governor.setBudget(governor.usage() - 1);
+    ASSERT_LE(governor.usage(), governor.budget());
+
+    // bricks held by a view can not be reclaimed, so a view that does not fit is refused
+    ASSERT_TRUE(reader.inlineSliceView(70, 0, reader.zSize())->isEmpty());
+
+    governor.setBudget(0);
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(memory_tests, testBricksHeldAfterEviction)
+{
+    auto& governor = MemoryGovernor::instance();
+
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    const std::int64_t before = governor.usage(MemoryCategory::DecodedBricks);
+    auto view = reader.inlineSliceView(70, 0, reader.zSize());
+    ASSERT_FALSE(view->isEmpty());
+
+    const std::int64_t decoded = governor.usage(MemoryCategory::DecodedBricks) - before;
+    ASSERT_GT(decoded, 0);
+
+    // evicted bricks still held by the view stay counted until the view lets go of them
+    reader.setBrickCacheSize(0);
+    ASSERT_EQ(governor.usage(MemoryCategory::DecodedBricks), before + decoded);
+
+    view = nullptr;
+    ASSERT_EQ(governor.usage(MemoryCategory::DecodedBricks), before);
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(memory_tests, testConsecutiveInlineViews)
+{
+    auto& governor = MemoryGovernor::instance();
+
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    // a cache smaller than one brick row keeps room for the bricks of the live views
+    reader.setBrickCacheSize(1);
+
+    auto view = reader.inlineSliceView(0, 0, reader.zSize());
+    ASSERT_FALSE(view->isEmpty());
+    const std::int64_t decoded = governor.usage(MemoryCategory::DecodedBricks);
+
+    // the following inlines in the same brick row come from the cache without decoding new bricks
+    for (int i = 1; i < reader.brickSize()[0]; i++)
+    {
+        auto next = reader.inlineSliceView(i, 0, reader.zSize());
+        ASSERT_FALSE(next->isEmpty());
+        ASSERT_EQ(governor.usage(MemoryCategory::DecodedBricks), decoded);
+
+        view = next;
+    }
+
+    // the room is given back with the last view
+    view = nullptr;
+    ASSERT_GT(governor.usage(MemoryCategory::DecodedBricks), 0);
+    ASSERT_LT(governor.usage(MemoryCategory::DecodedBricks), decoded);
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(memory_tests, testWaitForRelease)
+{
+    auto& governor = MemoryGovernor::instance();
+    const std::int64_t before = governor.usage(MemoryCategory::WriteBuffers);
+
+    governor.setBudget(governor.usage() + 4096);
+    governor.setWaitTimeout(0);
+
+    auto held = std::make_unique<MemoryReservation>(MemoryCategory::WriteBuffers, 4096);
+    ASSERT_TRUE(held->isValid());
+    ASSERT_FALSE(MemoryReservation(MemoryCategory::WriteBuffers, 1024).isValid());
+
+    // a blocked request goes ahead when another thread releases its memory
+    governor.setWaitTimeout(10000);
+    std::thread releaser([&held]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        held.reset();
+    });
+
+    {
+        MemoryReservation waited(MemoryCategory::WriteBuffers, 1024);
+        releaser.join();
+
+        ASSERT_TRUE(waited.isValid());
+        ASSERT_EQ(governor.usage(MemoryCategory::WriteBuffers), before + 1024);
+    }
+
+    // larger than the whole budget fails without waiting
+    ASSERT_FALSE(MemoryReservation(MemoryCategory::WriteBuffers, 8192).isValid());
+    ASSERT_EQ(governor.usage(MemoryCategory::WriteBuffers), before);
+
+    governor.setWaitTimeout(0);
+    governor.setBudget(0);
+}
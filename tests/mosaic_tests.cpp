@@ -0,0 +1,156 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_mosaic.h"
+#include "testdatafolder.h"
+
+namespace
+{
+    // grid with one cell per trace of the survey, extended by a few cells on each side
+    ZGYAccess::MapGrid surveyGrid(const ZGYAccess::ZGYReader& reader, int extra)
+    {
+        auto [il, ilTo] = reader.inlineRange();
+        auto [xl, xlTo] = reader.xlineRange();
+
+        auto origin = reader.toWorldCoordinate(il, xl);
+        auto nextInline = reader.toWorldCoordinate(il + reader.inlineStep(), xl);
+        auto nextXline = reader.toWorldCoordinate(il, xl + reader.xlineStep());
+
+        double dx = nextInline.first - origin.first;
+        double dy = nextXline.second - origin.second;
+
+        return ZGYAccess::MapGrid(ZGYAccess::Point2d(origin.first - extra * dx, origin.second - extra * dy), dx, dy,
+                                  reader.inlineSize() + 2 * extra, reader.xlineSize() + 2 * extra);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(mosaic_tests, testSingleSurvey)
+{
+    auto reader = std::make_shared<ZGYAccess::ZGYReader>();
+
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    const int extra = 3;
+    const float fillValue = -999.0f;
+    auto grid = surveyGrid(*reader, extra);
+
+    ZGYAccess::ZSliceMosaic mosaic(grid);
+    mosaic.addSurvey(reader, 0);
+
+    const int zIndex = 30;
+    auto expected = reader->zSlice(zIndex);
+    auto data = mosaic.zSlice(reader->zRange().first + zIndex * reader->zStep(), fillValue);
+
+    ASSERT_EQ(data->width(), grid.sizeX());
+    ASSERT_EQ(data->depth(), grid.sizeY());
+
+    for (int ix = 0; ix < grid.sizeX(); ix++)
+    {
+        for (int iy = 0; iy < grid.sizeY(); iy++)
+        {
+            const int i = ix - extra;
+            const int j = iy - extra;
+
+            if ((i < 0) || (j < 0) || (i >= reader->inlineSize()) || (j >= reader->xlineSize()))
+                ASSERT_EQ(data->valueAt(ix, iy), fillValue);
+            else
+                ASSERT_NEAR(data->valueAt(ix, iy), expected->valueAt(i, j), 1e-2);
+        }
+    }
+
+    reader->close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(mosaic_tests, testFeatherOverlap)
+{
+    auto reader1 = std::make_shared<ZGYAccess::ZGYReader>();
+    auto reader2 = std::make_shared<ZGYAccess::ZGYReader>();
+
+    ASSERT_TRUE(reader1->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+    ASSERT_TRUE(reader2->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto grid = surveyGrid(*reader1, 0);
+
+    ZGYAccess::ZSliceMosaic mosaic(grid);
+    mosaic.setBlendMode(ZGYAccess::MosaicBlend::Feather, 100.0);
+    mosaic.addSurvey(reader1, 1);
+    mosaic.addSurvey(reader2, 0);
+
+    const int zIndex = 50;
+    auto expected = reader1->zSlice(zIndex);
+    auto data = mosaic.zSlice(reader1->zRange().first + zIndex * reader1->zStep(), 0.0f);
+
+    // blending a survey with itself gives back the same values
+    for (int ix = 0; ix < grid.sizeX(); ix++)
+    {
+        for (int iy = 0; iy < grid.sizeY(); iy++)
+        {
+            ASSERT_NEAR(data->valueAt(ix, iy), expected->valueAt(ix, iy), 1e-2);
+        }
+    }
+
+    // z outside the survey gives only fill values
+    auto outside = mosaic.zSlice(reader1->zRange().second + 100.0, 5.0f);
+    ASSERT_EQ(outside->valueAt(10, 10), 5.0f);
+
+    reader1->close();
+    reader2->close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(mosaic_tests, testCoarseGrid)
+{
+    auto reader = std::make_shared<ZGYAccess::ZGYReader>();
+
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto fine = surveyGrid(*reader, 0);
+    ZGYAccess::MapGrid coarse(fine.origin(), fine.spacingX() * 4, fine.spacingY() * 4, fine.sizeX() / 4, fine.sizeY() / 4);
+
+    ZGYAccess::ZSliceMosaic mosaic(coarse);
+    mosaic.addSurvey(reader, 0);
+
+    auto data = mosaic.zSlice(reader->zRange().first + 40 * reader->zStep(), -999.0f);
+
+    ASSERT_EQ(data->width(), coarse.sizeX());
+    ASSERT_EQ(data->depth(), coarse.sizeY());
+
+    auto [minVal, maxVal] = reader->dataRange();
+    for (int i = 0; i < data->size(); i++)
+    {
+        ASSERT_GE(data->values()[i], minVal);
+        ASSERT_LE(data->values()[i], maxVal);
+    }
+
+    reader->close();
+}
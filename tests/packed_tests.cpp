@@ -0,0 +1,130 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_packedslice.h"
+#include "testdatafolder.h"
+
+using ZGYAccess::PackedSampleFormat;
+using ZGYAccess::PackedSliceData;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(packed_tests, testHalfConversion)
+{
+    ASSERT_EQ(PackedSliceData::toFloat16(1.0f), 0x3c00);
+    ASSERT_EQ(PackedSliceData::toFloat16(-2.0f), 0xc000);
+    ASSERT_EQ(PackedSliceData::toFloat16(65504.0f), 0x7bff);
+    ASSERT_EQ(PackedSliceData::toFloat16(1e6f), 0x7c00);
+    ASSERT_EQ(PackedSliceData::toFloat16(std::ldexp(1.0f, -24)), 0x0001);
+    ASSERT_EQ(PackedSliceData::toFloat16(0.0f), 0x0000);
+    ASSERT_EQ(PackedSliceData::toFloat16(std::numeric_limits<float>::infinity()), 0x7c00);
+    ASSERT_EQ(PackedSliceData::toFloat16(std::numeric_limits<float>::quiet_NaN()) & 0x7e00, 0x7e00);
+
+    // halfway between two halves rounds to the even one
+    ASSERT_EQ(PackedSliceData::toFloat16(1.0f + std::ldexp(1.0f, -11)), 0x3c00);
+    ASSERT_EQ(PackedSliceData::toFloat16(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3c02);
+
+    for (float value : { 0.0f, 1.0f, -0.333f, 1234.5f, std::ldexp(3.0f, -20), -65504.0f })
+    {
+        const float decoded = PackedSliceData::fromFloat16(PackedSliceData::toFloat16(value));
+        ASSERT_NEAR(decoded, value, std::abs(value) * 1e-3 + 1e-7);
+    }
+
+    ASSERT_EQ(PackedSliceData::toBFloat16(1.0f), 0x3f80);
+    ASSERT_EQ(PackedSliceData::fromBFloat16(PackedSliceData::toBFloat16(-3.5f)), -3.5f);
+    ASSERT_TRUE(std::isnan(PackedSliceData::fromBFloat16(PackedSliceData::toBFloat16(std::numeric_limits<float>::quiet_NaN()))));
+    ASSERT_NEAR(PackedSliceData::fromBFloat16(PackedSliceData::toBFloat16(1234.5f)), 1234.5f, 1234.5f / 128);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(packed_tests, testNormalisedPacking)
+{
+    std::vector<float> values = { -1.0f, 0.0f, 1.0f, 5.0f, -5.0f, std::numeric_limits<float>::quiet_NaN() };
+    std::vector<std::uint8_t> packed(values.size());
+    PackedSliceData::pack(values.data(), values.size(), PackedSampleFormat::UInt8, -1.0f, 1.0f, packed.data());
+
+    ASSERT_EQ(packed[0], 0);
+    ASSERT_EQ(packed[1], 128);
+    ASSERT_EQ(packed[2], 255);
+    ASSERT_EQ(packed[3], 255);
+    ASSERT_EQ(packed[4], 0);
+    ASSERT_EQ(packed[5], 0);
+
+    std::vector<std::uint8_t> packed16(values.size() * 2);
+    PackedSliceData::pack(values.data(), values.size(), PackedSampleFormat::UInt16, -1.0f, 1.0f, packed16.data());
+    ASSERT_NEAR(PackedSliceData::unpack(packed16.data(), 1, PackedSampleFormat::UInt16, -1.0f, 1.0f), 0.0f, 2.0f / 65535);
+    ASSERT_EQ(PackedSliceData::unpack(packed16.data(), 2, PackedSampleFormat::UInt16, -1.0f, 1.0f), 1.0f);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(packed_tests, testPackedSlices)
+{
+    auto reader = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    const auto [minVal, maxVal] = reader->dataRange();
+    const float step8 = (float)(maxVal - minVal) / 255.0f;
+
+    for (auto format : { PackedSampleFormat::Float16, PackedSampleFormat::BFloat16, PackedSampleFormat::UInt16, PackedSampleFormat::UInt8 })
+    {
+        ZGYAccess::PackedSliceReader packedReader(reader, format);
+
+        const float tolerance = (format == PackedSampleFormat::UInt8) ? step8 : (format == PackedSampleFormat::BFloat16) ? 1.0f : step8 / 100;
+
+        // windows crossing brick boundaries, and a z slice packed a tile row at a time
+        auto packedInline = packedReader.inlineSlice(70, 50, 100);
+        auto inlineSlice = reader->inlineSlice(70, 50, 100);
+        auto packedZ = packedReader.zSlice(130);
+        auto zSlice = reader->zSlice(130);
+        auto packedXline = packedReader.xlineSlice(33, 0, reader->zSize());
+        auto xlineSlice = reader->xlineSlice(33);
+
+        for (auto [packed, expected] : { std::make_pair(packedInline, inlineSlice), std::make_pair(packedZ, zSlice), std::make_pair(packedXline, xlineSlice) })
+        {
+            ASSERT_EQ(packed->width(), expected->width());
+            ASSERT_EQ(packed->depth(), expected->depth());
+            ASSERT_EQ(packed->byteSize(), (size_t)expected->size() * PackedSliceData::bytesPerSample(format));
+
+            for (int w = 0; w < packed->width(); w++)
+            {
+                for (int d = 0; d < packed->depth(); d++)
+                {
+                    ASSERT_NEAR(packed->valueAt(w, d), expected->valueAt(w, d), tolerance);
+                }
+            }
+        }
+    }
+
+    ZGYAccess::PackedSliceReader packedReader(reader, PackedSampleFormat::UInt8);
+    ASSERT_TRUE(packedReader.inlineSlice(112, 0, 10)->isEmpty());
+
+    reader->close();
+}
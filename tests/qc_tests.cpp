@@ -0,0 +1,207 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_qc.h"
+#include "zgyaccess/zgy_segy.h"
+#include "zgyaccess/zgy_segyexport.h"
+#include "zgyaccess/zgy_segyimport.h"
+#include "testdatafolder.h"
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(qc_tests, testScanClean)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::QcScanner scanner;
+    auto report = scanner.scan(reader);
+
+    ASSERT_FALSE(report.readFailed);
+    ASSERT_EQ(report.sampleCount, 112 * 64 * 176);
+    ASSERT_EQ(report.traceCount, 112 * 64);
+    ASSERT_EQ(report.nanCount, 0);
+    ASSERT_EQ(report.infCount, 0);
+    ASSERT_EQ(report.statistics.count, report.sampleCount);
+    ASSERT_TRUE(report.dataRangeConsistent);
+    ASSERT_TRUE(report.statisticsConsistent);
+    ASSERT_TRUE(report.histogramConsistent);
+    ASSERT_FALSE(report.isClipped);
+    ASSERT_TRUE(report.passed());
+
+    ZGYAccess::Outline indexOutline;
+    indexOutline.addPoint(-1.0, -1.0);
+    indexOutline.addPoint(200.0, -1.0);
+    indexOutline.addPoint(200.0, 200.0);
+    indexOutline.addPoint(-1.0, 200.0);
+
+    ZGYAccess::OutlineMask mask(reader.inlineSize(), reader.xlineSize(), indexOutline);
+    auto expected = reader.statistics(mask, 0, reader.zSize());
+    ASSERT_EQ(report.statistics.count, expected.count);
+    ASSERT_NEAR(report.statistics.mean(), expected.mean(), 1e-6);
+    ASSERT_EQ(report.statistics.minValue, expected.minValue);
+    ASSERT_EQ(report.statistics.maxValue, expected.maxValue);
+    ASSERT_GE(report.minValueCount, 1);
+    ASSERT_GE(report.maxValueCount, 1);
+
+    const auto json = report.toJson();
+    ASSERT_NE(json.find("\"sampleCount\": " + std::to_string(report.sampleCount)), std::string::npos);
+    ASSERT_NE(json.find("\"nanCount\": 0"), std::string::npos);
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(qc_tests, testScanDefects)
+{
+    const auto folder = std::filesystem::temp_directory_path();
+    const std::string segyFile = (folder / "qc_tests.segy").string();
+    const std::string zgyFile = (folder / "qc_tests.zgy").string();
+
+    ZGYAccess::ZGYReader source;
+    ASSERT_TRUE(source.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::SegyExporter exporter;
+    ASSERT_TRUE(exporter.exportToFile(source, segyFile)) << exporter.errorMessage();
+
+    // zero the trace at inline index 5, crossline index 7, and put a NaN in the trace after it
+    const int nk = source.zSize();
+    const std::int64_t traceBytes = 240 + 4 * nk;
+    const std::int64_t trace = 5 * source.xlineSize() + 7;
+    {
+        const std::vector<float> values(nk, 0.0f);
+        const float nanValue = std::numeric_limits<float>::quiet_NaN();
+
+        std::vector<std::uint8_t> bytes(4 * nk);
+        ZGYAccess::SegyFormat::fromFloat(values.data(), ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, nk, bytes.data());
+
+        std::fstream file(segyFile, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(3600 + trace * traceBytes + 240);
+        file.write(reinterpret_cast<const char*>(bytes.data()), 4 * nk);
+
+        std::uint8_t nan[4];
+        ZGYAccess::SegyFormat::fromFloat(&nanValue, ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, 1, nan);
+        file.seekp(3600 + (trace + 1) * traceBytes + 240 + 4 * 10);
+        file.write(reinterpret_cast<const char*>(nan), 4);
+    }
+    source.close();
+
+    ZGYAccess::SegyImporter importer;
+    ASSERT_TRUE(importer.import(segyFile, zgyFile)) << importer.errorMessage();
+
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(zgyFile));
+
+    ZGYAccess::QcScanner scanner;
+    auto report = scanner.scan(reader);
+
+    ASSERT_FALSE(report.passed());
+    ASSERT_EQ(report.nanCount, 1);
+    ASSERT_EQ(report.statistics.count, report.sampleCount - 1);
+
+    const std::array<int, 2> zeroed = { 5, 7 };
+    ASSERT_NE(std::find(report.zeroTraces.begin(), report.zeroTraces.end(), zeroed), report.zeroTraces.end());
+    ASSERT_EQ((std::int64_t)report.zeroTraces.size(), report.zeroTraceCount);
+
+    scanner.setMaxReportedTraces(0);
+    report = scanner.scan(reader);
+    ASSERT_TRUE(report.zeroTraces.empty());
+    ASSERT_GE(report.zeroTraceCount, 1);
+    ASSERT_NE(report.toJson().find("\"passed\": false"), std::string::npos);
+
+    reader.close();
+
+    std::filesystem::remove(segyFile);
+    std::filesystem::remove(zgyFile);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(qc_tests, testScanClipped)
+{
+    const auto folder = std::filesystem::temp_directory_path();
+    const std::string segyFile = (folder / "qc_clipped_tests.segy").string();
+    const std::string zgyFile = (folder / "qc_clipped_tests.zgy").string();
+
+    ZGYAccess::ZGYReader source;
+    ASSERT_TRUE(source.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::SegyExporter exporter;
+    ASSERT_TRUE(exporter.exportToFile(source, segyFile)) << exporter.errorMessage();
+
+    // clip every trace at half the data range
+    const int nk = source.zSize();
+    const std::int64_t traceBytes = 240 + 4 * nk;
+    const std::int64_t nTraces = (std::int64_t)source.inlineSize() * source.xlineSize();
+    const auto [minVal, maxVal] = source.dataRange();
+    const float clipMin = (float)(minVal / 2);
+    const float clipMax = (float)(maxVal / 2);
+    source.close();
+
+    {
+        std::fstream file(segyFile, std::ios::binary | std::ios::in | std::ios::out);
+        std::vector<std::uint8_t> bytes(4 * nk);
+        std::vector<float> values(nk);
+
+        for (std::int64_t t = 0; t < nTraces; t++)
+        {
+            file.seekg(3600 + t * traceBytes + 240);
+            file.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+            ZGYAccess::SegyFormat::toFloat(bytes.data(), ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, nk, values.data());
+
+            for (auto& value : values) value = std::clamp(value, clipMin, clipMax);
+
+            ZGYAccess::SegyFormat::fromFloat(values.data(), ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, nk, bytes.data());
+            file.seekp(3600 + t * traceBytes + 240);
+            file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+    }
+
+    ZGYAccess::SegyImporter importer;
+    ASSERT_TRUE(importer.import(segyFile, zgyFile)) << importer.errorMessage();
+
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(zgyFile));
+
+    ZGYAccess::QcScanner scanner;
+    auto report = scanner.scan(reader);
+
+    ASSERT_TRUE(report.isClipped);
+    ASSERT_FALSE(report.passed());
+    ASSERT_GT(report.maxValueCount, 4 * report.maxNeighbourCount);
+
+    reader.close();
+
+    std::filesystem::remove(segyFile);
+    std::filesystem::remove(zgyFile);
+}
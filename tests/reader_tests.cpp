@@ -19,11 +19,16 @@
 #include "gtest/gtest.h"
 
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <string>
+#include <thread>
 #include <variant>
 
 #include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_sectionreader.h"
+#include "zgyaccess/zgy_multivolume.h"
+#include "zgyaccess/zgy_synthetic.h"
 #include "testdatafolder.h"
 
 //--------------------------------------------------------------------------------------------------
@@ -414,3 +419,338 @@ TEST(reader_tests, testWorldtoIndexCoord)
 
     reader.close();
 }
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(reader_tests, testReadVolume)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto brickSize = reader.brickSize();
+    ASSERT_GT(brickSize[0], 0);
+
+    auto lodSize = reader.sizeAtLod(0);
+    ASSERT_EQ(lodSize[0], reader.inlineSize());
+    ASSERT_EQ(lodSize[1], reader.xlineSize());
+    ASSERT_EQ(lodSize[2], reader.zSize());
+
+    std::vector<float> buffer(2 * reader.xlineSize() * 10);
+    ASSERT_TRUE(reader.readVolume(0, { 50, 0, 15 }, { 2, reader.xlineSize(), 10 }, buffer.data()));
+
+    auto data = reader.inlineSlice(51, 15, 10);
+    for (int x = 0; x < reader.xlineSize(); x++)
+    {
+        for (int z = 0; z < 10; z++)
+        {
+            ASSERT_EQ(buffer[(reader.xlineSize() + x) * 10 + z], data->valueAt(x, z));
+        }
+    }
+
+    ASSERT_FALSE(reader.readVolume(0, { 500, 0, 0 }, { 1, 1, 1 }, buffer.data()));
+    ASSERT_FALSE(reader.readVolume(reader.lodCount(), { 0, 0, 0 }, { 1, 1, 1 }, buffer.data()));
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(reader_tests, testReadMaskedZSlice)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto [wX1, wY1] = reader.toWorldCoordinate(reader.inlineRange().first + 10 * reader.inlineStep(), reader.xlineRange().first + 5 * reader.xlineStep());
+    auto [wX2, wY2] = reader.toWorldCoordinate(reader.inlineRange().first + 80 * reader.inlineStep(), reader.xlineRange().first + 5 * reader.xlineStep());
+    auto [wX3, wY3] = reader.toWorldCoordinate(reader.inlineRange().first + 10 * reader.inlineStep(), reader.xlineRange().first + 40 * reader.xlineStep());
+
+    ZGYAccess::Outline outline;
+    outline.addPoint(wX1, wY1);
+    outline.addPoint(wX2, wY2);
+    outline.addPoint(wX3, wY3);
+
+    ZGYAccess::OutlineMask mask(reader, outline);
+    ASSERT_FALSE(mask.isEmpty());
+    ASSERT_TRUE(mask.isInside(10, 5));
+    ASSERT_TRUE(mask.isInside(20, 10));
+    ASSERT_FALSE(mask.isInside(70, 35));
+
+    const float fillValue = -999.0f;
+    auto full = reader.zSlice(30);
+    auto masked = reader.zSlice(30, mask, fillValue);
+
+    ASSERT_EQ(masked->width(), full->width());
+    ASSERT_EQ(masked->depth(), full->depth());
+
+    for (int i = 0; i < full->width(); i++)
+    {
+        for (int j = 0; j < full->depth(); j++)
+        {
+            if (mask.isInside(i, j))
+                ASSERT_EQ(masked->valueAt(i, j), full->valueAt(i, j));
+            else
+                ASSERT_EQ(masked->valueAt(i, j), fillValue);
+        }
+    }
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(reader_tests, testMaskedStatistics)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::Outline indexOutline;
+    indexOutline.addPoint(3.0, 2.0);
+    indexOutline.addPoint(90.0, 10.0);
+    indexOutline.addPoint(40.0, 60.0);
+
+    ZGYAccess::OutlineMask mask(reader.inlineSize(), reader.xlineSize(), indexOutline);
+
+    const int zStart = 20;
+    const int zCount = 100;
+
+    auto stats = reader.statistics(mask, zStart, zCount);
+    ASSERT_EQ(stats.count, mask.traceCount() * zCount);
+
+    double sum = 0.0;
+    double minVal = 1e10;
+    double maxVal = -1e10;
+    for (int i = 0; i < reader.inlineSize(); i++)
+    {
+        auto slice = reader.inlineSlice(i, zStart, zCount);
+        for (int j = 0; j < reader.xlineSize(); j++)
+        {
+            if (!mask.isInside(i, j)) continue;
+            for (int k = 0; k < zCount; k++)
+            {
+                sum += slice->valueAt(j, k);
+                minVal = std::min(minVal, (double)slice->valueAt(j, k));
+                maxVal = std::max(maxVal, (double)slice->valueAt(j, k));
+            }
+        }
+    }
+
+    ASSERT_NEAR(stats.sum, sum, 1e-6 * std::abs(sum) + 1e-3);
+    ASSERT_DOUBLE_EQ(stats.minValue, minVal);
+    ASSERT_DOUBLE_EQ(stats.maxValue, maxVal);
+
+    auto hist = reader.histogram(mask, 64, zStart, zCount);
+    ASSERT_EQ(hist->Yvalues.size(), 64);
+
+    double histCount = 0.0;
+    for (double y : hist->Yvalues) histCount += y;
+    ASSERT_DOUBLE_EQ(histCount, (double)stats.count);
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(reader_tests, testInlineSliceView)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    // brick aligned window, and one crossing the brick boundaries in z
+    for (auto [zStart, zSize] : { std::make_pair(64, 64), std::make_pair(50, 100) })
+    {
+        auto view = reader.inlineSliceView(70, zStart, zSize);
+        auto slice = reader.inlineSlice(70, zStart, zSize);
+
+        ASSERT_FALSE(view->isEmpty());
+        ASSERT_EQ(view->width(), slice->width());
+        ASSERT_EQ(view->depth(), slice->depth());
+        ASSERT_EQ(view->segmentCount(), (zStart + zSize - 1) / 64 - zStart / 64 + 1);
+
+        for (int trace = 0; trace < view->width(); trace++)
+        {
+            int k = 0;
+            for (int s = 0; s < view->segmentCount(); s++)
+            {
+                int nSamples = 0;
+                const float* samples = view->segment(trace, s, nSamples);
+                for (int n = 0; n < nSamples; n++, k++)
+                {
+                    ASSERT_EQ(samples[n], slice->valueAt(trace, k));
+                    ASSERT_EQ(view->valueAt(trace, k), slice->valueAt(trace, k));
+                }
+            }
+            ASSERT_EQ(k, zSize);
+        }
+
+        auto gathered = view->gather();
+        ASSERT_TRUE(std::equal(gathered->values(), gathered->values() + gathered->size(), slice->values()));
+    }
+
+    // a second view of the same window references the same cached bricks
+    int nSamples = 0;
+    const float* first = reader.inlineSliceView(70, 64, 64)->segment(10, 0, nSamples);
+    auto view = reader.inlineSliceView(70, 64, 64);
+    ASSERT_EQ(view->segment(10, 0, nSamples), first);
+
+    // the view keeps its bricks alive when the reader lets go of them
+    const float expected = reader.inlineSlice(70, 64, 64)->valueAt(10, 5);
+    reader.close();
+    ASSERT_EQ(view->valueAt(10, 5), expected);
+
+    ASSERT_TRUE(reader.inlineSliceView(70, 0, 10)->isEmpty());
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(reader_tests, testInlineSectionPanning)
+{
+    auto reader = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::InlineSectionReader section(reader);
+    const int width = reader->xlineSize();
+    const int zSize = 60;
+
+    // full read, pan down, pan up past the start, jump without overlap, change inline
+    const std::vector<std::array<int, 3>> steps = { { 30, 40, zSize }, { 30, 55, 15 }, { 30, 20, 35 }, { 30, 100, zSize }, { 31, 100, zSize } };
+
+    for (const auto& step : steps)
+    {
+        auto slice = section.inlineSlice(step[0], step[1], zSize);
+        auto expected = reader->inlineSlice(step[0], step[1], zSize);
+
+        ASSERT_EQ(section.samplesRead(), (std::int64_t)width * step[2]);
+        ASSERT_EQ(slice->size(), expected->size());
+        ASSERT_TRUE(std::equal(slice->values(), slice->values() + slice->size(), expected->values()));
+    }
+
+    // the same window again reads nothing
+    section.inlineSlice(31, 100, zSize);
+    ASSERT_EQ(section.samplesRead(), 0);
+
+    ASSERT_TRUE(section.inlineSlice(31, 150, zSize)->isEmpty());
+
+    reader->close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(reader_tests, testInterleavedMultiVolumeSlices)
+{
+    auto fancy = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(fancy->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    const std::string zgyFile = (std::filesystem::temp_directory_path() / "multivolume_tests.zgy").string();
+    ZGYAccess::SyntheticVolumeGenerator generator(fancy->inlineSize(), fancy->xlineSize(), fancy->zSize());
+    ASSERT_TRUE(generator.write(zgyFile)) << generator.errorMessage();
+
+    auto synthetic = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(synthetic->open(zgyFile));
+
+    ZGYAccess::MultiVolumeReader multi;
+    multi.addVolume(fancy);
+    multi.addVolume(synthetic);
+    ASSERT_EQ(multi.volumeCount(), 2);
+
+    auto compare = [](std::shared_ptr<ZGYAccess::InterleavedSliceData> slice, std::vector<std::shared_ptr<ZGYAccess::SeismicSliceData>> expected)
+    {
+        ASSERT_EQ(slice->channels(), (int)expected.size());
+        for (int c = 0; c < slice->channels(); c++)
+        {
+            ASSERT_EQ(slice->width(), expected[c]->width());
+            ASSERT_EQ(slice->depth(), expected[c]->depth());
+            for (int w = 0; w < slice->width(); w++)
+            {
+                for (int d = 0; d < slice->depth(); d++)
+                {
+                    ASSERT_EQ(slice->valueAt(w, d, c), expected[c]->valueAt(w, d));
+                }
+            }
+        }
+    };
+
+    // windows crossing brick boundaries in every direction
+    compare(multi.inlineSlice(70, 50, 100), { fancy->inlineSlice(70, 50, 100), synthetic->inlineSlice(70, 50, 100) });
+    compare(multi.xlineSlice(33, 0, fancy->zSize()), { fancy->xlineSlice(33), synthetic->xlineSlice(33) });
+    compare(multi.zSlice(130), { fancy->zSlice(130), synthetic->zSlice(130) });
+
+    ASSERT_TRUE(multi.inlineSlice(70, 150, 100)->isEmpty());
+
+    // volumes of different size cannot be interleaved
+    auto other = std::make_shared<ZGYAccess::ZGYReader>();
+    ZGYAccess::SyntheticVolumeGenerator small(10, 10, 10);
+    ASSERT_TRUE(small.write(zgyFile + ".small.zgy"));
+    ASSERT_TRUE(other->open(zgyFile + ".small.zgy"));
+    multi.addVolume(other);
+    ASSERT_TRUE(multi.zSlice(5)->isEmpty());
+
+    other->close();
+    synthetic->close();
+    fancy->close();
+    std::filesystem::remove(zgyFile);
+    std::filesystem::remove(zgyFile + ".small.zgy");
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(reader_tests, testCloneReader)
+{
+    ZGYAccess::ZGYReader closed;
+    ASSERT_EQ(closed.clone(), nullptr);
+
+    auto reader = std::make_shared<ZGYAccess::ZGYReader>();
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    std::vector<std::shared_ptr<ZGYAccess::ZGYReader>> clones;
+    for (int n = 0; n < 4; n++)
+    {
+        clones.push_back(reader->clone());
+    }
+
+    std::vector<std::shared_ptr<ZGYAccess::SeismicSliceData>> expected;
+    for (int n = 0; n < (int)clones.size(); n++)
+    {
+        expected.push_back(reader->inlineSlice(20 * n));
+    }
+
+    // closing the original leaves the clones usable
+    reader->close();
+
+    std::vector<std::shared_ptr<ZGYAccess::SeismicSliceData>> slices(clones.size());
+    std::vector<std::thread> threads;
+    for (int n = 0; n < (int)clones.size(); n++)
+    {
+        threads.emplace_back([&, n]() { slices[n] = clones[n]->inlineSlice(20 * n); });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int n = 0; n < (int)clones.size(); n++)
+    {
+        ASSERT_EQ(clones[n]->inlineSize(), 112);
+        ASSERT_EQ(slices[n]->size(), expected[n]->size());
+        ASSERT_TRUE(std::equal(slices[n]->values(), slices[n]->values() + slices[n]->size(), expected[n]->values()));
+    }
+
+    // the original can be reopened independently of the clones
+    ASSERT_TRUE(reader->open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+    reader->close();
+
+    for (auto& clone : clones)
+    {
+        clone->close();
+        ASSERT_TRUE(clone->inlineSlice(0)->isEmpty());
+    }
+}
@@ -0,0 +1,344 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_segy.h"
+#include "zgyaccess/zgy_segyimport.h"
+#include "zgyaccess/zgy_segyexport.h"
+#include "zgyaccess/zgy_memorygovernor.h"
+#include "testdatafolder.h"
+
+namespace
+{
+    void putInt16(std::vector<std::uint8_t>& buffer, size_t offset, std::int16_t value)
+    {
+        buffer[offset] = (std::uint8_t)((std::uint16_t)value >> 8);
+        buffer[offset + 1] = (std::uint8_t)value;
+    }
+
+    void putInt32(std::vector<std::uint8_t>& buffer, size_t offset, std::int32_t value)
+    {
+        for (int b = 0; b < 4; b++)
+        {
+            buffer[offset + b] = (std::uint8_t)((std::uint32_t)value >> (24 - 8 * b));
+        }
+    }
+
+    float testSample(int i, int j, int k)
+    {
+        return std::sin(0.3f * k + i) * 100.0f + j;
+    }
+
+    // IEEE float SEG-Y with 5 inlines (100-108, step 2) and 7 crosslines (200-212, step 2),
+    // where trace (inline 104, crossline 206) is missing
+    void writeTestSegy(const std::string& filename, int nSamples)
+    {
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+        std::vector<std::uint8_t> header(3600, 0);
+        putInt16(header, 3216, 4000);
+        putInt16(header, 3220, (std::int16_t)nSamples);
+        putInt16(header, 3224, 5);
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+        std::vector<std::uint8_t> trace(240 + 4 * nSamples, 0);
+        for (int i = 0; i < 5; i++)
+        {
+            for (int j = 0; j < 7; j++)
+            {
+                if ((i == 2) && (j == 3)) continue;
+
+                std::fill(trace.begin(), trace.end(), 0);
+                putInt16(trace, 70, -10);
+                putInt16(trace, 108, 500);
+                putInt32(trace, 180, (std::int32_t)std::lround((1000.0 + 25.0 * i) * 10));
+                putInt32(trace, 184, (std::int32_t)std::lround((2000.0 + 12.5 * j) * 10));
+                putInt32(trace, 188, 100 + 2 * i);
+                putInt32(trace, 192, 200 + 2 * j);
+
+                for (int k = 0; k < nSamples; k++)
+                {
+                    float value = testSample(i, j, k);
+                    std::int32_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    putInt32(trace, 240 + 4 * k, bits);
+                }
+
+                file.write(reinterpret_cast<const char*>(trace.data()), trace.size());
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(segy_tests, testIbmFloat)
+{
+    const std::uint8_t data[] = { 0x41, 0x10, 0x00, 0x00,
+                                  0xC1, 0x10, 0x00, 0x00,
+                                  0x42, 0x64, 0x00, 0x00,
+                                  0xC2, 0x76, 0xA0, 0x00,
+                                  0x00, 0x00, 0x00, 0x00,
+                                  0x7F, 0x00, 0x00, 0x00,
+                                  0x60, 0x00, 0x00, 0x01,
+                                  0x7F, 0xFF, 0xFF, 0xFF };
+    float values[8];
+
+    ZGYAccess::SegyFormat::toFloat(data, ZGYAccess::SegyFormat::SampleFormat::IbmFloat, 8, values);
+
+    ASSERT_FLOAT_EQ(values[0], 1.0f);
+    ASSERT_FLOAT_EQ(values[1], -1.0f);
+    ASSERT_FLOAT_EQ(values[2], 100.0f);
+    ASSERT_FLOAT_EQ(values[3], -118.625f);
+    ASSERT_FLOAT_EQ(values[4], 0.0f);
+
+    // the largest exponents saturate per value, so a zero mantissa stays zero
+    ASSERT_EQ(values[5], 0.0f);
+    ASSERT_EQ(values[6], std::ldexp(1.0f, 104));
+    ASSERT_TRUE(std::isinf(values[7]));
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(segy_tests, testFromFloat)
+{
+    const float values[] = { 1.0f, -1.0f, 100.0f, -118.625f, 0.0f, 3.0e-5f, -7.25e6f };
+    std::uint8_t data[4 * 7];
+    float roundTrip[7];
+
+    ZGYAccess::SegyFormat::fromFloat(values, ZGYAccess::SegyFormat::SampleFormat::IbmFloat, 7, data);
+
+    ASSERT_EQ(data[0], 0x41);
+    ASSERT_EQ(data[1], 0x10);
+    ASSERT_EQ(data[12], 0xC2);
+    ASSERT_EQ(data[13], 0x76);
+    ASSERT_EQ(data[14], 0xA0);
+
+    ZGYAccess::SegyFormat::toFloat(data, ZGYAccess::SegyFormat::SampleFormat::IbmFloat, 7, roundTrip);
+    for (int n = 0; n < 7; n++)
+    {
+        ASSERT_NEAR(roundTrip[n], values[n], std::abs(values[n]) * 2e-6);
+    }
+
+    ZGYAccess::SegyFormat::fromFloat(values, ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, 7, data);
+    ZGYAccess::SegyFormat::toFloat(data, ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, 7, roundTrip);
+    for (int n = 0; n < 7; n++)
+    {
+        ASSERT_EQ(roundTrip[n], values[n]);
+    }
+
+    const float wide[] = { 40000.0f, -2.6f };
+    ZGYAccess::SegyFormat::fromFloat(wide, ZGYAccess::SegyFormat::SampleFormat::Int16, 2, data);
+    ZGYAccess::SegyFormat::toFloat(data, ZGYAccess::SegyFormat::SampleFormat::Int16, 2, roundTrip);
+    ASSERT_EQ(roundTrip[0], 32767.0f);
+    ASSERT_EQ(roundTrip[1], -3.0f);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(segy_tests, testIntegerFormats)
+{
+    const std::uint8_t data16[] = { 0xFF, 0xFE, 0x01, 0x00 };
+    const std::uint8_t data32[] = { 0x00, 0x01, 0x00, 0x00 };
+    const std::uint8_t data8[] = { 0x80, 0x7F };
+    float values[2];
+
+    ZGYAccess::SegyFormat::toFloat(data16, ZGYAccess::SegyFormat::SampleFormat::Int16, 2, values);
+    ASSERT_EQ(values[0], -2.0f);
+    ASSERT_EQ(values[1], 256.0f);
+
+    ZGYAccess::SegyFormat::toFloat(data32, ZGYAccess::SegyFormat::SampleFormat::Int32, 1, values);
+    ASSERT_EQ(values[0], 65536.0f);
+
+    ZGYAccess::SegyFormat::toFloat(data8, ZGYAccess::SegyFormat::SampleFormat::Int8, 2, values);
+    ASSERT_EQ(values[0], -128.0f);
+    ASSERT_EQ(values[1], 127.0f);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(segy_tests, testImport)
+{
+    const auto folder = std::filesystem::temp_directory_path();
+    const std::string segyFile = (folder / "segy_tests_import.segy").string();
+    const std::string zgyFile = (folder / "segy_tests_import.zgy").string();
+    const int nSamples = 50;
+
+    writeTestSegy(segyFile, nSamples);
+
+    ZGYAccess::SegyImporter importer;
+    ASSERT_TRUE(importer.import(segyFile, zgyFile)) << importer.errorMessage();
+
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(zgyFile));
+
+    ASSERT_EQ(reader.inlineSize(), 5);
+    ASSERT_EQ(reader.xlineSize(), 7);
+    ASSERT_EQ(reader.zSize(), nSamples);
+
+    ASSERT_EQ(reader.inlineRange().first, 100);
+    ASSERT_EQ(reader.inlineStep(), 2);
+    ASSERT_EQ(reader.xlineRange().first, 200);
+    ASSERT_EQ(reader.xlineStep(), 2);
+
+    ASSERT_DOUBLE_EQ(reader.zStep(), 4.0);
+    ASSERT_DOUBLE_EQ(reader.zRange().first, 500.0);
+
+    auto [wx, wy] = reader.toWorldCoordinate(104, 206);
+    ASSERT_NEAR(wx, 1050.0, 1e-3);
+    ASSERT_NEAR(wy, 2037.5, 1e-3);
+
+    for (int i = 0; i < 5; i++)
+    {
+        for (int j = 0; j < 7; j++)
+        {
+            auto trace = reader.zTrace(i, j);
+            for (int k = 0; k < nSamples; k++)
+            {
+                float expected = ((i == 2) && (j == 3)) ? 0.0f : testSample(i, j, k);
+                ASSERT_FLOAT_EQ(trace->valueAt(0, k), expected);
+            }
+        }
+    }
+
+    reader.close();
+
+    ASSERT_FALSE(importer.import((folder / "does_not_exist.segy").string(), zgyFile));
+    ASSERT_FALSE(importer.errorMessage().empty());
+
+    // header fields must lie within the trace header
+    ZGYAccess::SegyImporter outside;
+    outside.setHeaderPositions(189, 238, 181, 185);
+    ASSERT_FALSE(outside.import(segyFile, zgyFile));
+    ASSERT_FALSE(outside.errorMessage().empty());
+
+    // one garbage inline number spreads the grid far beyond the traces in the file
+    {
+        std::fstream file(segyFile, std::ios::binary | std::ios::in | std::ios::out);
+        std::vector<std::uint8_t> field(4, 0);
+        putInt32(field, 0, 2000000000);
+        file.seekp(3600 + 188);
+        file.write(reinterpret_cast<const char*>(field.data()), field.size());
+    }
+    ASSERT_FALSE(importer.import(segyFile, zgyFile));
+    ASSERT_FALSE(importer.errorMessage().empty());
+
+    std::filesystem::remove(segyFile);
+    std::filesystem::remove(zgyFile);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(segy_tests, testExportRoundTrip)
+{
+    const auto folder = std::filesystem::temp_directory_path();
+    const std::string segyFile = (folder / "segy_tests_export.segy").string();
+    const std::string zgyFile = (folder / "segy_tests_export.zgy").string();
+
+    ZGYAccess::ZGYReader source;
+    ASSERT_TRUE(source.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    for (auto format : { ZGYAccess::SegyFormat::SampleFormat::IeeeFloat, ZGYAccess::SegyFormat::SampleFormat::IbmFloat })
+    {
+        // a small budget forces several slabs per brick row
+        ZGYAccess::SegyExporter exporter;
+        exporter.setSampleFormat(format);
+        exporter.setMemoryBudget(2 * 1024 * 1024);
+        ASSERT_TRUE(exporter.exportToFile(source, segyFile)) << exporter.errorMessage();
+
+        const auto expectedSize = 3600 + (std::uintmax_t)source.inlineSize() * source.xlineSize() * (240 + 4 * source.zSize());
+        ASSERT_EQ(std::filesystem::file_size(segyFile), expectedSize);
+
+        ZGYAccess::SegyImporter importer;
+        ASSERT_TRUE(importer.import(segyFile, zgyFile)) << importer.errorMessage();
+
+        ZGYAccess::ZGYReader reader;
+        ASSERT_TRUE(reader.open(zgyFile));
+
+        ASSERT_EQ(reader.inlineSize(), source.inlineSize());
+        ASSERT_EQ(reader.xlineSize(), source.xlineSize());
+        ASSERT_EQ(reader.zSize(), source.zSize());
+        ASSERT_EQ(reader.inlineRange().first, source.inlineRange().first);
+        ASSERT_EQ(reader.inlineStep(), source.inlineStep());
+        ASSERT_EQ(reader.xlineRange().first, source.xlineRange().first);
+        ASSERT_EQ(reader.xlineStep(), source.xlineStep());
+        ASSERT_NEAR(reader.zStep(), source.zStep(), 1e-3);
+
+        const int il = source.inlineRange().first + 3 * source.inlineStep();
+        const int xl = source.xlineRange().first + 40 * source.xlineStep();
+        ASSERT_NEAR(reader.toWorldCoordinate(il, xl).first, source.toWorldCoordinate(il, xl).first, 0.01);
+        ASSERT_NEAR(reader.toWorldCoordinate(il, xl).second, source.toWorldCoordinate(il, xl).second, 0.01);
+
+        for (int i : { 0, 63, 64, source.inlineSize() - 1 })
+        {
+            auto expected = source.inlineSlice(i);
+            auto actual = reader.inlineSlice(i);
+            ASSERT_EQ(actual->size(), expected->size());
+            for (int n = 0; n < expected->size(); n++)
+            {
+                ASSERT_NEAR(actual->values()[n], expected->values()[n], std::abs(expected->values()[n]) * 1e-6);
+            }
+        }
+
+        reader.close();
+    }
+
+    source.close();
+
+    std::filesystem::remove(segyFile);
+    std::filesystem::remove(zgyFile);
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(segy_tests, testFailedExportRemovesFile)
+{
+    const auto folder = std::filesystem::temp_directory_path();
+    const std::string segyFile = (folder / "segy_tests_failed_export.segy").string();
+
+    ZGYAccess::ZGYReader source;
+    ASSERT_TRUE(source.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    // the slab buffers are refused after the headers are written
+    auto& governor = ZGYAccess::MemoryGovernor::instance();
+    governor.setBudget(governor.usage() + 4096);
+
+    ZGYAccess::SegyExporter exporter;
+    ASSERT_FALSE(exporter.exportToFile(source, segyFile));
+    ASSERT_FALSE(exporter.errorMessage().empty());
+    ASSERT_FALSE(std::filesystem::exists(segyFile));
+
+    governor.setBudget(0);
+    source.close();
+}
@@ -0,0 +1,127 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_synthetic.h"
+
+namespace
+{
+    double correlation(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        double ab = 0.0, aa = 0.0, bb = 0.0;
+        for (size_t n = 0; n < a.size(); n++)
+        {
+            ab += (double)a[n] * b[n];
+            aa += (double)a[n] * a[n];
+            bb += (double)b[n] * b[n];
+        }
+        return ab / std::sqrt(aa * bb);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(synthetic_tests, testGenerateTraces)
+{
+    ZGYAccess::SyntheticVolumeGenerator generator(100, 90, 120);
+    generator.setSeed(7);
+
+    std::vector<float> trace(120);
+    std::vector<float> neighbour(120);
+
+    // corners are outside the survey outline
+    ASSERT_TRUE(generator.isDeadTrace(0, 0));
+    generator.generateTrace(0, 0, trace.data());
+    for (float value : trace)
+    {
+        ASSERT_EQ(value, 0.0f);
+    }
+
+    // layered content is continuous from trace to trace, and within the amplitude limit
+    ASSERT_FALSE(generator.isDeadTrace(50, 20));
+    generator.generateTrace(50, 20, trace.data());
+    generator.generateTrace(50, 21, neighbour.data());
+    ASSERT_GT(correlation(trace, neighbour), 0.8);
+    for (float value : trace)
+    {
+        ASSERT_LE(std::abs(value), generator.amplitudeLimit());
+    }
+
+    ZGYAccess::SyntheticVolumeGenerator other(100, 90, 120);
+    other.setSeed(8);
+    other.generateTrace(50, 20, neighbour.data());
+    ASSERT_LT(correlation(trace, neighbour), 0.9);
+
+    generator.setDeadAreas(false);
+    ASSERT_FALSE(generator.isDeadTrace(0, 0));
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(synthetic_tests, testWriteVolume)
+{
+    const auto folder = std::filesystem::temp_directory_path();
+    const std::string zgyFile = (folder / "synthetic_tests.zgy").string();
+
+    for (auto sampleType : { ZGYAccess::SyntheticSampleType::Float32, ZGYAccess::SyntheticSampleType::Int16 })
+    {
+        // a small budget forces several slabs per brick row
+        ZGYAccess::SyntheticVolumeGenerator generator(100, 150, 120);
+        generator.setSampleType(sampleType);
+        generator.setMemoryBudget(4 * 1024 * 1024);
+        ASSERT_TRUE(generator.write(zgyFile)) << generator.errorMessage();
+
+        ZGYAccess::ZGYReader reader;
+        ASSERT_TRUE(reader.open(zgyFile));
+        ASSERT_EQ(reader.inlineSize(), 100);
+        ASSERT_EQ(reader.xlineSize(), 150);
+        ASSERT_EQ(reader.zSize(), 120);
+
+        const double tolerance = (sampleType == ZGYAccess::SyntheticSampleType::Float32) ? 0.0 : 1e-3;
+
+        std::vector<float> expected(120);
+        for (auto [i, j] : { std::make_pair(0, 0), std::make_pair(50, 70), std::make_pair(64, 128), std::make_pair(99, 149) })
+        {
+            generator.generateTrace(i, j, expected.data());
+
+            auto trace = reader.zTrace(i, j);
+            for (int k = 0; k < 120; k++)
+            {
+                ASSERT_NEAR(trace->valueAt(0, k), expected[k], tolerance);
+            }
+        }
+
+        reader.close();
+    }
+
+    ZGYAccess::SyntheticVolumeGenerator compressedInt8(10, 10, 10);
+    compressedInt8.setSampleType(ZGYAccess::SyntheticSampleType::Int8);
+    compressedInt8.setCompression(30.0f);
+    ASSERT_FALSE(compressedInt8.write(zgyFile));
+    ASSERT_FALSE(compressedInt8.errorMessage().empty());
+
+    std::filesystem::remove(zgyFile);
+}
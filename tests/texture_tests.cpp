@@ -0,0 +1,132 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <cmath>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_texture.h"
+#include "testdatafolder.h"
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(texture_tests, testExportFullVolume)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    auto [minVal, maxVal] = reader.dataRange();
+
+    ZGYAccess::TextureBrickExporter exporter(32, 1, ZGYAccess::TextureFormat::UNorm8);
+    auto bricks = exporter.exportVolume(reader, 0, { 0, 0, 0 }, { reader.inlineSize(), reader.xlineSize(), reader.zSize() });
+
+    ASSERT_EQ(bricks->brickCount[0], 4);
+    ASSERT_EQ(bricks->brickCount[1], 2);
+    ASSERT_EQ(bricks->brickCount[2], 6);
+    ASSERT_EQ(bricks->bricks.size(), 48);
+    ASSERT_EQ(bricks->paddedSize(), 34);
+
+    for (auto& brick : bricks->bricks)
+    {
+        ASSERT_EQ(brick.data.size(), 34 * 34 * 34);
+    }
+
+    // interior sample (5, 6, 7) of the first brick is at padded position (6, 7, 8)
+    auto slice = reader.inlineSlice(5);
+    float value = slice->valueAt(6, 7);
+    int expected = (int)std::lround((value - minVal) / (maxVal - minVal) * 255.0);
+
+    const auto& data = bricks->bricks[0].data;
+    ASSERT_EQ(data[(6 * 34 + 7) * 34 + 8], expected);
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(texture_tests, testExportLod)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+    ASSERT_GT(reader.lodCount(), 1);
+
+    auto lodSize = reader.sizeAtLod(1);
+
+    ZGYAccess::TextureBrickExporter exporter(64, 2, ZGYAccess::TextureFormat::UNorm16);
+    auto bricks = exporter.exportVolume(reader, 1, { 0, 0, 0 }, { reader.inlineSize(), reader.xlineSize(), reader.zSize() });
+
+    ASSERT_EQ(bricks->lod, 1);
+    ASSERT_EQ(bricks->bytesPerSample(), 2);
+
+    for (int d = 0; d < 3; d++)
+    {
+        ASSERT_EQ(bricks->brickCount[d], (lodSize[d] + 63) / 64);
+    }
+
+    for (auto& brick : bricks->bricks)
+    {
+        ASSERT_EQ(brick.data.size(), 68 * 68 * 68 * 2);
+    }
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(texture_tests, testBorderRepeatsEdge)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ZGYAccess::TextureBrickExporter exporter(16, 1, ZGYAccess::TextureFormat::UNorm8);
+    auto bricks = exporter.exportVolume(reader, 0, { 0, 0, 0 }, { 16, 16, 16 });
+
+    ASSERT_EQ(bricks->bricks.size(), 1);
+
+    const auto& data = bricks->bricks[0].data;
+    const int p = bricks->paddedSize();
+
+    // the survey starts at the brick origin, so the low border repeats the first sample
+    for (int k = 1; k < p; k++)
+    {
+        ASSERT_EQ(data[(0 * p + 1) * p + k], data[(1 * p + 1) * p + k]);
+    }
+
+    reader.close();
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(texture_tests, testExportEmpty)
+{
+    ZGYAccess::ZGYReader reader;
+
+    ZGYAccess::TextureBrickExporter exporter(32, 1, ZGYAccess::TextureFormat::UNorm8);
+    auto bricks = exporter.exportVolume(reader, 0, { 0, 0, 0 }, { 10, 10, 10 });
+
+    ASSERT_TRUE(bricks->bricks.empty());
+}
@@ -0,0 +1,124 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_thumbnail.h"
+#include "testdatafolder.h"
+
+using ZGYAccess::ThumbnailColorMap;
+using ZGYAccess::ThumbnailGenerator;
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(thumbnail_tests, testGenerate)
+{
+    ZGYAccess::ZGYReader reader;
+    ASSERT_TRUE(reader.open(std::string(TEST_DATA_DIR) + "Fancy-int8.zgy"));
+
+    ThumbnailGenerator generator;
+    generator.setMaxSize(64);
+
+    auto thumbnails = generator.generate(reader);
+    ASSERT_FALSE(thumbnails->isEmpty());
+    ASSERT_EQ(thumbnails->lod, reader.lodCount() - 1);
+
+    // the longest side is scaled to the max size and the aspect ratio kept
+    const auto size = reader.sizeAtLod(thumbnails->lod);
+    ASSERT_EQ(thumbnails->inlineImage.height(), 64);
+    ASSERT_NEAR(thumbnails->inlineImage.width(), 64.0 * size[1] / size[2], 1.0);
+    ASSERT_EQ(thumbnails->zImage.width(), 64);
+    ASSERT_NEAR(thumbnails->zImage.height(), 64.0 * size[1] / size[0], 1.0);
+
+    // the clip range lies inside the data range, and the grey image spans black to white
+    const auto [minVal, maxVal] = reader.dataRange();
+    ASSERT_LT(thumbnails->clipMin, thumbnails->clipMax);
+    ASSERT_GE(thumbnails->clipMin, minVal);
+    ASSERT_LE(thumbnails->clipMax, maxVal);
+
+    int darkest = 255;
+    int brightest = 0;
+    for (auto* image : { &thumbnails->inlineImage, &thumbnails->xlineImage, &thumbnails->zImage })
+    {
+        for (int y = 0; y < image->height(); y++)
+        {
+            for (int x = 0; x < image->width(); x++)
+            {
+                const auto rgba = image->pixel(x, y);
+                ASSERT_EQ(rgba[3], 255);
+                ASSERT_EQ(rgba[0], rgba[1]);
+                darkest = std::min(darkest, (int)rgba[0]);
+                brightest = std::max(brightest, (int)rgba[0]);
+            }
+        }
+    }
+    ASSERT_EQ(darkest, 0);
+    ASSERT_EQ(brightest, 255);
+
+    generator.setColorMap(ThumbnailColorMap::Seismic);
+    auto seismic = generator.generate(reader);
+    ASSERT_EQ(seismic->clipMin, -seismic->clipMax);
+
+    reader.close();
+
+    ZGYAccess::ZGYReader closedReader;
+    ASSERT_TRUE(generator.generate(closedReader)->isEmpty());
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+TEST(thumbnail_tests, testSidecarCache)
+{
+    const std::string filename = std::string(TEST_DATA_DIR) + "Fancy-int8.zgy";
+    const std::string sidecar = filename + ".thumbnails";
+    std::filesystem::remove(sidecar);
+
+    ThumbnailGenerator generator;
+    auto thumbnails = generator.thumbnails(filename);
+    ASSERT_FALSE(thumbnails->isEmpty());
+    ASSERT_TRUE(std::filesystem::exists(sidecar));
+
+    // the second call is served from the sidecar
+    const auto written = std::filesystem::last_write_time(sidecar);
+    auto cached = generator.thumbnails(filename);
+    ASSERT_EQ(std::filesystem::last_write_time(sidecar), written);
+    ASSERT_EQ(cached->zImage.width(), thumbnails->zImage.width());
+    ASSERT_EQ(cached->zImage.height(), thumbnails->zImage.height());
+    ASSERT_EQ(cached->clipMax, thumbnails->clipMax);
+    ASSERT_TRUE(std::equal(cached->inlineImage.data(), cached->inlineImage.data() + cached->inlineImage.byteSize(), thumbnails->inlineImage.data()));
+
+    // other settings make new thumbnails
+    generator.setMaxSize(32);
+    auto smaller = generator.thumbnails(filename);
+    ASSERT_EQ(std::max(smaller->zImage.width(), smaller->zImage.height()), 32);
+
+    auto batch = generator.thumbnails(std::vector<std::string>{ filename, filename + ".missing" });
+    ASSERT_EQ(batch.size(), 2u);
+    ASSERT_FALSE(batch[0]->isEmpty());
+    ASSERT_TRUE(batch[1]->isEmpty());
+
+    std::filesystem::remove(sidecar);
+}
@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_compressionadvisor.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static int usage()
+{
+    std::cerr << "Usage: zgy-advise-compression [options] input.zgy" << std::endl;
+    std::cerr << "  --bricks <n>                number of bricks to trial compress (default 64)" << std::endl;
+    std::cerr << "  --tolerance <t>[,<t>...]    zfp accuracy relative to the RMS amplitude (default 0.2,0.06,0.02,0.006)" << std::endl;
+    std::cerr << "  --rate <bits>[,<bits>...]   fixed rate bits per sample to try instead" << std::endl;
+    return 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static std::vector<double> parseList(const std::string& text)
+{
+    std::vector<double> values;
+
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find(',', start);
+        if (end == std::string::npos) end = text.size();
+        values.push_back(std::atof(text.substr(start, end - start).c_str()));
+        start = end + 1;
+    }
+
+    return values;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    ZGYAccess::CompressionAdvisor advisor;
+    std::vector<double> targets = { 0.2, 0.06, 0.02, 0.006 };
+    bool fixedRate = false;
+
+    int arg = 1;
+    for (; arg < argc; arg++)
+    {
+        const std::string option = argv[arg];
+        if (option.rfind("--", 0) != 0) break;
+
+        if ((option == "--bricks") && (arg + 1 < argc))
+        {
+            advisor.setSampleBrickCount(std::atoi(argv[++arg]));
+        }
+        else if ((option == "--tolerance") && (arg + 1 < argc))
+        {
+            targets = parseList(argv[++arg]);
+            fixedRate = false;
+        }
+        else if ((option == "--rate") && (arg + 1 < argc))
+        {
+            targets = parseList(argv[++arg]);
+            fixedRate = true;
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (argc - arg != 1) return usage();
+
+    ZGYAccess::ZGYReader reader;
+    if (!reader.open(argv[arg]))
+    {
+        std::cerr << "Could not open " << argv[arg] << std::endl;
+        return 1;
+    }
+
+    auto estimates = fixedRate ? advisor.estimateBitRate(reader, targets) : advisor.estimateAccuracy(reader, targets);
+    if (estimates.empty())
+    {
+        std::cerr << "Trial compression failed" << std::endl;
+        return 1;
+    }
+
+    std::printf("%d bricks sampled, %d constant\n", advisor.sampledBrickCount(), advisor.constantBrickCount());
+    std::printf("%10s %10s %12s %10s %14s\n", fixedRate ? "bits" : "tolerance", "ratio", "rms error", "snr dB", "decode MB/s");
+    for (const auto& estimate : estimates)
+    {
+        std::printf("%10.4g %10.2f %12.5g %10.2f %14.1f\n", estimate.target, estimate.compressionRatio, estimate.rmsError, estimate.snr, estimate.decodeSpeed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_compare.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static int usage()
+{
+    std::cerr << "Usage: zgy-compare [options] first.zgy second.zgy" << std::endl;
+    std::cerr << "  --tolerance <value>         ignore sample differences up to this value" << std::endl;
+    std::cerr << "Exit code is 0 when the files match, 1 when they differ and 2 on errors" << std::endl;
+    return 2;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    ZGYAccess::VolumeComparator comparator;
+
+    int arg = 1;
+    for (; arg < argc; arg++)
+    {
+        const std::string option = argv[arg];
+        if (option.rfind("--", 0) != 0) break;
+
+        if ((option == "--tolerance") && (arg + 1 < argc))
+        {
+            comparator.setTolerance(std::atof(argv[++arg]));
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (argc - arg != 2) return usage();
+
+    ZGYAccess::ZGYReader first;
+    ZGYAccess::ZGYReader second;
+    if (!first.open(argv[arg]) || !second.open(argv[arg + 1]))
+    {
+        std::cerr << "Could not open input files" << std::endl;
+        return 2;
+    }
+
+    const auto result = comparator.compare(first, second);
+    if (!result.sameSize)
+    {
+        std::cerr << "Volume sizes differ" << std::endl;
+        return 1;
+    }
+    if (result.readFailed)
+    {
+        std::cerr << "Failed to read samples" << std::endl;
+        return 2;
+    }
+
+    std::printf("geometry: %s\n", result.sameGeometry ? "same" : "different");
+    if (result.identicalFiles)
+        std::printf("bricks: none read, the files are byte for byte identical\n");
+    else
+        std::printf("bricks: %d constant, %d decoded\n", result.constantBricks, result.decodedBricks);
+    std::printf("samples: %lld compared, %lld different\n", (long long)result.comparedSamples, (long long)result.differingSamples);
+    std::printf("max difference: %g\nrms difference: %g\n", result.maxDifference, result.rmsDifference);
+
+    for (const auto& region : result.regions)
+    {
+        std::printf("region %d,%d,%d size %d,%d,%d: %lld samples, max difference %g\n", region.start[0], region.start[1], region.start[2],
+                    region.size[0], region.size[1], region.size[2], (long long)region.differingSamples, region.maxDifference);
+    }
+
+    return result.isIdentical() ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_segyexport.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static int usage()
+{
+    std::cerr << "Usage: zgy-export-segy [options] input.zgy output.segy" << std::endl;
+    std::cerr << "  --ibm                       write IBM float samples instead of IEEE float" << std::endl;
+    std::cerr << "  --memory <MB>               memory budget for trace buffers" << std::endl;
+    return 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    ZGYAccess::SegyExporter exporter;
+
+    int arg = 1;
+    for (; arg < argc; arg++)
+    {
+        const std::string option = argv[arg];
+        if (option.rfind("--", 0) != 0) break;
+
+        if (option == "--ibm")
+        {
+            exporter.setSampleFormat(ZGYAccess::SegyFormat::SampleFormat::IbmFloat);
+        }
+        else if ((option == "--memory") && (arg + 1 < argc))
+        {
+            exporter.setMemoryBudget(std::atoll(argv[++arg]) * 1024 * 1024);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (argc - arg != 2) return usage();
+
+    ZGYAccess::ZGYReader reader;
+    if (!reader.open(argv[arg]))
+    {
+        std::cerr << "Could not open " << argv[arg] << std::endl;
+        return 1;
+    }
+
+    if (!exporter.exportToFile(reader, argv[arg + 1]))
+    {
+        std::cerr << "Export failed: " << exporter.errorMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_synthetic.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static int usage()
+{
+    std::cerr << "Usage: zgy-generate [options] output.zgy" << std::endl;
+    std::cerr << "  --size <il> <xl> <z>        number of inlines, crosslines and samples (default 1024 1024 1024)" << std::endl;
+    std::cerr << "  --type <int8|int16|float>   sample type (default float)" << std::endl;
+    std::cerr << "  --snr <dB>                  ZFP compress with the given signal to noise ratio" << std::endl;
+    std::cerr << "  --seed <n>                  seed for the layer model" << std::endl;
+    std::cerr << "  --no-dead                   do not add dead areas" << std::endl;
+    std::cerr << "  --memory <MB>               memory budget for sample buffers" << std::endl;
+    return 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    int ni = 1024, nj = 1024, nk = 1024;
+    ZGYAccess::SyntheticSampleType sampleType = ZGYAccess::SyntheticSampleType::Float32;
+    float snr = 0.0f;
+    unsigned int seed = 1;
+    bool deadAreas = true;
+    long long memoryMB = 1024;
+
+    int arg = 1;
+    for (; arg < argc; arg++)
+    {
+        const std::string option = argv[arg];
+        if (option.rfind("--", 0) != 0) break;
+
+        if ((option == "--size") && (arg + 3 < argc))
+        {
+            ni = std::atoi(argv[arg + 1]);
+            nj = std::atoi(argv[arg + 2]);
+            nk = std::atoi(argv[arg + 3]);
+            arg += 3;
+        }
+        else if ((option == "--type") && (arg + 1 < argc))
+        {
+            const std::string type = argv[++arg];
+            if (type == "int8")
+                sampleType = ZGYAccess::SyntheticSampleType::Int8;
+            else if (type == "int16")
+                sampleType = ZGYAccess::SyntheticSampleType::Int16;
+            else if (type == "float")
+                sampleType = ZGYAccess::SyntheticSampleType::Float32;
+            else
+                return usage();
+        }
+        else if ((option == "--snr") && (arg + 1 < argc))
+        {
+            snr = (float)std::atof(argv[++arg]);
+        }
+        else if ((option == "--seed") && (arg + 1 < argc))
+        {
+            seed = (unsigned int)std::atoi(argv[++arg]);
+        }
+        else if (option == "--no-dead")
+        {
+            deadAreas = false;
+        }
+        else if ((option == "--memory") && (arg + 1 < argc))
+        {
+            memoryMB = std::atoll(argv[++arg]);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (argc - arg != 1) return usage();
+
+    ZGYAccess::SyntheticVolumeGenerator generator(ni, nj, nk);
+    generator.setSampleType(sampleType);
+    generator.setCompression(snr);
+    generator.setSeed(seed);
+    generator.setDeadAreas(deadAreas);
+    generator.setMemoryBudget(memoryMB * 1024 * 1024);
+
+    if (!generator.write(argv[arg]))
+    {
+        std::cerr << "Generation failed: " << generator.errorMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
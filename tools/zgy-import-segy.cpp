@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgy_segyimport.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static int usage()
+{
+    std::cerr << "Usage: zgy-import-segy [options] input.segy output.zgy" << std::endl;
+    std::cerr << "  --snr <dB>                  ZFP compress with the given signal to noise ratio" << std::endl;
+    std::cerr << "  --headers <il> <xl> <x> <y> 1-based byte positions of inline, crossline and CDP X/Y" << std::endl;
+    std::cerr << "  --memory <MB>               memory budget for sample buffers" << std::endl;
+    return 1;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    ZGYAccess::SegyImporter importer;
+
+    int arg = 1;
+    for (; arg < argc; arg++)
+    {
+        const std::string option = argv[arg];
+        if (option.rfind("--", 0) != 0) break;
+
+        if ((option == "--snr") && (arg + 1 < argc))
+        {
+            importer.setCompression((float)std::atof(argv[++arg]));
+        }
+        else if ((option == "--headers") && (arg + 4 < argc))
+        {
+            const int il = std::atoi(argv[arg + 1]);
+            const int xl = std::atoi(argv[arg + 2]);
+            const int x = std::atoi(argv[arg + 3]);
+            const int y = std::atoi(argv[arg + 4]);
+            importer.setHeaderPositions(il, xl, x, y);
+            arg += 4;
+        }
+        else if ((option == "--memory") && (arg + 1 < argc))
+        {
+            importer.setMemoryBudget(std::atoll(argv[++arg]) * 1024 * 1024);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (argc - arg != 2) return usage();
+
+    if (!importer.import(argv[arg], argv[arg + 1]))
+    {
+        std::cerr << "Import failed: " << importer.errorMessage() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2023 Equinor ASA
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/////////////////////////////////////////////////////////////////////////////////
+
+#include "zgyaccess/zgyreader.h"
+#include "zgyaccess/zgy_qc.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static int usage()
+{
+    std::cerr << "Usage: zgy-qc [options] input.zgy [input.zgy ...]" << std::endl;
+    std::cerr << "  --clip-fraction <f>         fraction of samples at the extremes reported as clipping" << std::endl;
+    std::cerr << "  --max-traces <n>            number of zeroed trace positions to list per file" << std::endl;
+    std::cerr << "Writes a JSON array with one report per file. Exit code is 1 if any file fails." << std::endl;
+    return 2;
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+static std::string jsonString(const std::string& text)
+{
+    std::string retval = "\"";
+    for (char c : text)
+    {
+        if ((c == '"') || (c == '\\')) retval += '\\';
+        retval += c;
+    }
+    return retval + "\"";
+}
+
+//--------------------------------------------------------------------------------------------------
+///
+//--------------------------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    ZGYAccess::QcScanner scanner;
+
+    int arg = 1;
+    for (; arg < argc; arg++)
+    {
+        const std::string option = argv[arg];
+        if (option.rfind("--", 0) != 0) break;
+
+        if ((option == "--clip-fraction") && (arg + 1 < argc))
+        {
+            scanner.setClipFraction(std::atof(argv[++arg]));
+        }
+        else if ((option == "--max-traces") && (arg + 1 < argc))
+        {
+            scanner.setMaxReportedTraces(std::atoi(argv[++arg]));
+        }
+        else
+        {
+            return usage();
+        }
+    }
+
+    if (arg >= argc) return usage();
+
+    bool allPassed = true;
+
+    std::cout << "[" << std::endl;
+    for (int n = arg; n < argc; n++)
+    {
+        ZGYAccess::ZGYReader reader;
+
+        ZGYAccess::QcReport report;
+        if (reader.open(argv[n]))
+            report = scanner.scan(reader);
+        else
+            report.readFailed = true;
+
+        allPassed = allPassed && report.passed();
+
+        std::cout << "{ \"file\": " << jsonString(argv[n]) << ", \"report\": " << report.toJson() << "}" << ((n + 1 < argc) ? "," : "") << std::endl;
+    }
+    std::cout << "]" << std::endl;
+
+    return allPassed ? 0 : 1;
+}